@@ -0,0 +1,156 @@
+/**
+ * @file bench_json_scan.c
+ * @brief Benchmark for JSON scanner module
+ * 
+ * Compares the SIMD and scalar paths on representative server payloads.
+ * Not part of the package build; run on the target:
+ * 
+ *   $(TARGET_CC) -std=c99 -O2 -Isrc -o bench_json_scan \
+ *       bench/bench_json_scan.c src/json_scan.c
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "json_scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_TARGET_BYTES  (64u * 1024u * 1024u)   // Bytes scanned per case
+
+/* ============================================================
+ *  Payload Generators
+ * ============================================================ */
+
+/**
+ * @brief Single-console status reply (below the SIMD threshold)
+ */
+static size_t build_status_reply(char *buf, size_t size) {
+    return (size_t)snprintf(buf, size,
+                            "{\"type\":\"ps5_status\",\"status\":\"standby\",\"ts\":1762156800}");
+}
+
+/**
+ * @brief Multi-console status table
+ */
+static size_t build_console_table(char *buf, size_t size, int consoles) {
+    size_t len = (size_t)snprintf(buf, size, "{\"type\":\"console_table\",\"consoles\":[");
+    
+    for (int i = 0; i < consoles && len < size; i++) {
+        len += (size_t)snprintf(buf + len, size - len,
+                                "%s{\"id\":\"ps5-%03d\",\"name\":\"Sal\xC3\xB3n %d\","
+                                "\"state\":\"standby\",\"ip\":\"192.168.1.%d\","
+                                "\"firmware\":\"24.06-09.60.00\",\"uptime\":%d}",
+                                i == 0 ? "" : ",", i, i, 10 + i, i * 3600);
+    }
+    
+    len += (size_t)snprintf(buf + len, size - len, "],\"status\":\"on\"}");
+    return len;
+}
+
+/**
+ * @brief Power history with telemetry acks
+ */
+static size_t build_history(char *buf, size_t size, int entries) {
+    size_t len = (size_t)snprintf(buf, size, "{\"type\":\"history\",\"entries\":[");
+    
+    for (int i = 0; i < entries && len < size; i++) {
+        len += (size_t)snprintf(buf + len, size - len,
+                                "%s{\"t\":%d,\"from\":\"standby\",\"to\":\"on\","
+                                "\"ack\":{\"seq\":%d,\"ok\":true},\"note\":\"\"}",
+                                i == 0 ? "" : ",", 1762156800 + i * 60, i);
+    }
+    
+    len += (size_t)snprintf(buf + len, size - len, "],\"status\":\"off\"}");
+    return len;
+}
+
+/* ============================================================
+ *  Timing Helpers
+ * ============================================================ */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static volatile size_t g_sink;
+
+static double bench_structurals(const char *data, size_t len, uint32_t *positions,
+                                size_t (*fn)(const char *, size_t, uint32_t *, size_t)) {
+    size_t iterations = BENCH_TARGET_BYTES / len + 1;
+    double start = now_sec();
+    for (size_t i = 0; i < iterations; i++) {
+        g_sink += fn(data, len, positions, JSON_SCAN_MAX_STRUCTURALS);
+    }
+    return (double)(iterations * len) / (now_sec() - start) / 1e6;
+}
+
+static double bench_utf8(const char *data, size_t len, bool (*fn)(const char *, size_t)) {
+    size_t iterations = BENCH_TARGET_BYTES / len + 1;
+    double start = now_sec();
+    for (size_t i = 0; i < iterations; i++) {
+        g_sink += fn(data, len);
+    }
+    return (double)(iterations * len) / (now_sec() - start) / 1e6;
+}
+
+static double bench_find(const char *data, size_t len) {
+    size_t iterations = BENCH_TARGET_BYTES / len + 1;
+    const char *value;
+    size_t value_length;
+    double start = now_sec();
+    for (size_t i = 0; i < iterations; i++) {
+        json_scan_find_string(data, len, "status", &value, &value_length);
+        g_sink += value_length;
+    }
+    return (double)(iterations * len) / (now_sec() - start) / 1e6;
+}
+
+static double bench_strstr(const char *data, size_t len) {
+    size_t iterations = BENCH_TARGET_BYTES / len + 1;
+    double start = now_sec();
+    for (size_t i = 0; i < iterations; i++) {
+        g_sink += (size_t)(strstr(data, "\"status\":\"on\"") != NULL);
+        g_sink += (size_t)(strstr(data, "\"status\":\"standby\"") != NULL);
+        g_sink += (size_t)(strstr(data, "\"status\":\"off\"") != NULL);
+    }
+    return (double)(iterations * len) / (now_sec() - start) / 1e6;
+}
+
+/* ============================================================
+ *  Main
+ * ============================================================ */
+
+int main(void) {
+    static char buf[3][32 * 1024];
+    static uint32_t positions[JSON_SCAN_MAX_STRUCTURALS];
+    const char *names[3] = { "status reply", "console table", "history" };
+    size_t lens[3];
+    
+    lens[0] = build_status_reply(buf[0], sizeof(buf[0]));
+    lens[1] = build_console_table(buf[1], sizeof(buf[1]), 24);
+    lens[2] = build_history(buf[2], sizeof(buf[2]), 160);
+    
+    printf("backend: %s (MB/s)\n", json_scan_backend());
+    printf("%-14s %7s %10s %10s %10s %10s %10s %10s\n", "payload", "bytes",
+           "idx-simd", "idx-scal", "utf8-simd", "utf8-scal", "find", "strstr");
+    
+    for (int i = 0; i < 3; i++) {
+        printf("%-14s %7zu %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f\n",
+               names[i], lens[i],
+               bench_structurals(buf[i], lens[i], positions, json_scan_structurals),
+               bench_structurals(buf[i], lens[i], positions, json_scan_structurals_scalar),
+               bench_utf8(buf[i], lens[i], json_scan_utf8_valid),
+               bench_utf8(buf[i], lens[i], json_scan_utf8_valid_scalar),
+               bench_find(buf[i], lens[i]),
+               bench_strstr(buf[i], lens[i]));
+    }
+    
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file fuzz_control_command.c
+ * @brief Fuzz target for control socket commands
+ *
+ * Sends the input through read_commands() over a socket pair in writes
+ * sized by the first input byte, so line splitting sees partial and
+ * packed command lines. The reader is internal, so the server is
+ * compiled into this file.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_control_command \
+ *       fuzz/fuzz_control_command.c fuzz/fuzz_guard.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "../src/control_server.c"
+#include "fuzz_guard.h"
+
+/** Smallest write into the socket pair */
+#define FUZZ_MIN_WRITE      16
+
+static int g_pair[2] = { -1, -1 };
+
+static int snapshot(char *buffer, size_t size, void *user_data) {
+    return snprintf(buffer, size, "{\"state\":\"IDLE\"}");
+}
+
+/**
+ * @brief Drop whatever the last run left unread
+ */
+static void drain(int fd) {
+    char scratch[256];
+    while (recv(fd, scratch, sizeof(scratch), MSG_DONTWAIT) > 0) {
+    }
+}
+
+static void run_commands(const uint8_t *data, size_t size) {
+    static control_client_t client;
+
+    if (size == 0) {
+        return;
+    }
+
+    // Writes of a few bytes at least, or syscalls drown the parsing cost
+    size_t step = FUZZ_MIN_WRITE + data[0];
+    data++;
+    size--;
+
+    memset(&client, 0, sizeof(client));
+    client.fd = g_pair[0];
+
+    for (size_t offset = 0; offset < size; offset += step) {
+        size_t chunk = size - offset < step ? size - offset : step;
+        if (send(g_pair[1], data + offset, chunk, MSG_DONTWAIT) != (ssize_t)chunk ||
+            read_commands(&client) != 0) {
+            break;
+        }
+        client.outbuf_len = 0;  // Replies are flushed between reads
+    }
+
+    if (client.subscribed) {
+        g_control_ctx.stats.subscribers--;
+    }
+    drain(g_pair[0]);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (g_pair[0] < 0) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, g_pair) != 0) {
+            abort();
+        }
+        g_control_ctx.snapshot = snapshot;
+    }
+
+    fuzz_guard_run(run_commands, data, size);
+    return 0;
+}
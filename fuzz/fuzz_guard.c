@@ -0,0 +1,107 @@
+/**
+ * @file fuzz_guard.c
+ * @brief Fuzz Guard Implementation
+ *
+ * Costs are thread CPU time, so a fuzzer sharing the machine with other
+ * jobs is not charged for their time.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+// POSIX headers for clock_gettime
+#define _POSIX_C_SOURCE 199309L
+
+#include "fuzz_guard.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Runs of an over-budget input, the cheapest one counts */
+#define FUZZ_GUARD_RETRIES          3
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t measure(fuzz_target_fn target, const uint8_t *data, size_t size) {
+    uint64_t start = now_ns();
+    target(data, size);
+    return now_ns() - start;
+}
+
+/**
+ * @brief Time a run again while it stays over the limit
+ */
+static uint64_t cheapest(fuzz_target_fn target, const uint8_t *data, size_t size,
+                         uint64_t cost, uint64_t limit) {
+    for (int i = 1; i < FUZZ_GUARD_RETRIES && cost > limit; i++) {
+        uint64_t again = measure(target, data, size);
+        if (again < cost) {
+            cost = again;
+        }
+    }
+    return cost;
+}
+
+static uint64_t budget_ns(size_t size) {
+    return FUZZ_GUARD_BASE_NS + (uint64_t)size * FUZZ_GUARD_NS_PER_BYTE;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void fuzz_guard_run(fuzz_target_fn target, const uint8_t *data, size_t size) {
+    uint64_t cost = measure(target, data, size);
+
+    cost = cheapest(target, data, size, cost, budget_ns(size));
+    if (cost > budget_ns(size)) {
+        fprintf(stderr, "fuzz_guard: %zu bytes cost %llu ns, budget %llu ns\n",
+                size, (unsigned long long)cost, (unsigned long long)budget_ns(size));
+        abort();
+    }
+
+    if (size == 0 || size > FUZZ_GUARD_MAX_SCALED / FUZZ_GUARD_SCALE) {
+        return;
+    }
+
+    size_t scaled_size = size * FUZZ_GUARD_SCALE;
+    uint8_t *scaled = malloc(scaled_size);
+    if (scaled == NULL) {
+        return;
+    }
+    for (int i = 0; i < FUZZ_GUARD_SCALE; i++) {
+        memcpy(scaled + (size_t)i * size, data, size);
+    }
+
+    // The base cost is paid once per run, not once per copy
+    uint64_t limit = cost * FUZZ_GUARD_SCALE * FUZZ_GUARD_GROWTH_SLACK + FUZZ_GUARD_BASE_NS;
+    uint64_t scaled_cost = measure(target, scaled, scaled_size);
+
+    if (scaled_cost > limit) {
+        // Settle both runs before blaming the input
+        cost = cheapest(target, data, size, measure(target, data, size), 0);
+        limit = cost * FUZZ_GUARD_SCALE * FUZZ_GUARD_GROWTH_SLACK + FUZZ_GUARD_BASE_NS;
+        scaled_cost = cheapest(target, scaled, scaled_size, scaled_cost, limit);
+
+        if (scaled_cost > limit) {
+            fprintf(stderr, "fuzz_guard: superlinear cost, %zu bytes %llu ns, "
+                    "x%d %llu ns\n", size, (unsigned long long)cost,
+                    FUZZ_GUARD_SCALE, (unsigned long long)scaled_cost);
+            free(scaled);
+            abort();
+        }
+    }
+
+    free(scaled);
+}
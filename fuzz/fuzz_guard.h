@@ -0,0 +1,98 @@
+/**
+ * @file fuzz_guard.h
+ * @brief Fuzz Guard - cost budget for parser fuzz targets
+ *
+ * Every parser here runs on the event loop, so an input that takes long
+ * is as bad as one that crashes. The guard times each fuzz input and
+ * aborts, which makes the fuzzer keep the input, when:
+ * - it costs more than FUZZ_GUARD_BASE_NS + FUZZ_GUARD_NS_PER_BYTE per byte
+ * - the input repeated FUZZ_GUARD_SCALE times costs more than
+ *   FUZZ_GUARD_GROWTH_SLACK times linear growth
+ *
+ * Not part of the package build. Build a target with libFuzzer:
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_json_scan \
+ *       fuzz/fuzz_json_scan.c fuzz/fuzz_guard.c src/json_scan.c
+ *
+ * or for AFL and replaying saved inputs, with fuzz/fuzz_main.c instead
+ * of -fsanitize=fuzzer. Sanitizers slow parsers down several times; raise
+ * the budget with -DFUZZ_GUARD_NS_PER_BYTE=... rather than dropping them.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef FUZZ_GUARD_H
+#define FUZZ_GUARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Fixed cost allowed per input, covers call overhead and cold caches */
+#ifndef FUZZ_GUARD_BASE_NS
+#define FUZZ_GUARD_BASE_NS          200000
+#endif
+
+/** Cost allowed per input byte */
+#ifndef FUZZ_GUARD_NS_PER_BYTE
+#define FUZZ_GUARD_NS_PER_BYTE      500
+#endif
+
+/** Times the input is repeated for the growth check */
+#ifndef FUZZ_GUARD_SCALE
+#define FUZZ_GUARD_SCALE            8
+#endif
+
+/** Growth beyond linear tolerated before an input counts as superlinear */
+#ifndef FUZZ_GUARD_GROWTH_SLACK
+#define FUZZ_GUARD_GROWTH_SLACK     4
+#endif
+
+/** Longest repeated input, longer inputs skip the growth check */
+#ifndef FUZZ_GUARD_MAX_SCALED
+#define FUZZ_GUARD_MAX_SCALED       (256 * 1024)
+#endif
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Parser run on one input
+ *
+ * Runs are repeated, so a target must not depend on earlier runs.
+ */
+typedef void (*fuzz_target_fn)(const uint8_t *data, size_t size);
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Run a target on one input within the cost budget
+ *
+ * Aborts with the measured cost on stderr when the input is over budget
+ * or grows superlinearly. An over-budget run is timed again before
+ * aborting, so one preempted run does not fail the fuzzer.
+ *
+ * @param target Parser to run
+ * @param data Input bytes
+ * @param size Input length
+ */
+void fuzz_guard_run(fuzz_target_fn target, const uint8_t *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FUZZ_GUARD_H */
@@ -0,0 +1,72 @@
+/**
+ * @file fuzz_json_scan.c
+ * @brief Fuzz target for the JSON scanner
+ *
+ * Looks up the keys the client and WebSocket layer use, and checks the
+ * block scanner against its scalar reference on every input.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_json_scan \
+ *       fuzz/fuzz_json_scan.c fuzz/fuzz_guard.c src/json_scan.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "json_scan.h"
+#include "fuzz_guard.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t g_positions[JSON_SCAN_MAX_STRUCTURALS + 1];
+static uint32_t g_reference[JSON_SCAN_MAX_STRUCTURALS + 1];
+static volatile size_t g_sink;
+
+static void touch_element(const char *element, size_t length, void *user_data) {
+    g_sink += length > 0 ? (size_t)(unsigned char)element[length - 1] : 0;
+}
+
+static void run_scanner(const uint8_t *data, size_t size) {
+    const char *text = (const char *)data;
+    const char *value;
+    size_t value_length;
+    long number;
+
+    size_t count = json_scan_structurals(text, size, g_positions, JSON_SCAN_MAX_STRUCTURALS);
+    size_t reference = json_scan_structurals_scalar(text, size, g_reference,
+                                                    JSON_SCAN_MAX_STRUCTURALS);
+    size_t stored = count > JSON_SCAN_MAX_STRUCTURALS ? JSON_SCAN_MAX_STRUCTURALS : count;
+    if (count != reference || memcmp(g_positions, g_reference, stored * sizeof(uint32_t)) != 0) {
+        abort();
+    }
+
+    if (json_scan_utf8_valid(text, size) != json_scan_utf8_valid_scalar(text, size)) {
+        abort();
+    }
+
+    static const char *const string_keys[] = { "type", "status", "mode", "redirect" };
+    for (size_t i = 0; i < sizeof(string_keys) / sizeof(string_keys[0]); i++) {
+        if (json_scan_find_string(text, size, string_keys[i], &value, &value_length) == 0) {
+            if (value < text || value + value_length > text + size) {
+                abort();
+            }
+            g_sink += value_length;
+        }
+    }
+
+    static const char *const int_keys[] = { "rate_percent", "ttl_ms", "retry_after_ms" };
+    for (size_t i = 0; i < sizeof(int_keys) / sizeof(int_keys[0]); i++) {
+        if (json_scan_find_int(text, size, int_keys[i], &number) == 0) {
+            g_sink += (size_t)number;
+        }
+    }
+
+    json_scan_for_each_element(text, size, "messages", touch_element, NULL);
+    json_scan_for_each_element(text, size, "features", touch_element, NULL);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    fuzz_guard_run(run_scanner, data, size);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file fuzz_lan_request.c
+ * @brief Fuzz target for LAN status HTTP requests
+ *
+ * Trickles the input into read_request() over a socket pair, so head
+ * detection and request-line parsing see it the way a slow LAN client
+ * sends it. The first input byte sets the size of each write. The
+ * reader is internal, so the server is compiled into this file.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_lan_request \
+ *       fuzz/fuzz_lan_request.c fuzz/fuzz_guard.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "../src/lan_status_server.c"
+#include "fuzz_guard.h"
+
+/** Smallest write into the socket pair */
+#define FUZZ_MIN_WRITE      16
+
+static int g_pair[2] = { -1, -1 };
+
+/**
+ * @brief Drop whatever the last run left unread
+ */
+static void drain(int fd) {
+    char scratch[256];
+    while (recv(fd, scratch, sizeof(scratch), MSG_DONTWAIT) > 0) {
+    }
+}
+
+static void run_request(const uint8_t *data, size_t size) {
+    static lan_conn_t conn;
+
+    if (size == 0) {
+        return;
+    }
+
+    // Writes of a few bytes at least, or syscalls drown the parsing cost
+    size_t step = FUZZ_MIN_WRITE + data[0];
+    data++;
+    size--;
+
+    // Anything past the head buffer is rejected without being parsed
+    if (size > LAN_STATUS_REQUEST_MAX) {
+        size = LAN_STATUS_REQUEST_MAX;
+    }
+
+    memset(&conn, 0, sizeof(conn));
+    conn.fd = g_pair[0];
+    conn.phase = LAN_CONN_REQUEST;
+
+    for (size_t offset = 0; offset < size && conn.phase == LAN_CONN_REQUEST; offset += step) {
+        size_t chunk = size - offset < step ? size - offset : step;
+        if (send(g_pair[1], data + offset, chunk, MSG_DONTWAIT) != (ssize_t)chunk ||
+            read_request(&conn, 0) != 0) {
+            break;
+        }
+    }
+
+    drain(g_pair[0]);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (g_pair[0] < 0 && socketpair(AF_UNIX, SOCK_STREAM, 0, g_pair) != 0) {
+        abort();
+    }
+
+    fuzz_guard_run(run_request, data, size);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file fuzz_main.c
+ * @brief Standalone driver for the fuzz targets
+ *
+ * Runs a target without libFuzzer: on every file named on the command
+ * line, or on stdin when there is none, which is how AFL feeds inputs.
+ * Also replays crash and slow inputs saved by libFuzzer:
+ *
+ *   afl-clang-fast -std=c99 -g -O1 -DTESTING -Isrc -Ifuzz -o fuzz_json_scan \
+ *       fuzz/fuzz_json_scan.c fuzz/fuzz_guard.c fuzz/fuzz_main.c src/json_scan.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Largest input read, matches libFuzzer's default -max_len ceiling */
+#define FUZZ_MAIN_MAX_INPUT     (1024 * 1024)
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/**
+ * @brief Read one input and run the target on it
+ */
+static int run_file(FILE *file, uint8_t *buffer) {
+    size_t size = fread(buffer, 1, FUZZ_MAIN_MAX_INPUT, file);
+
+    if (ferror(file)) {
+        return -1;
+    }
+
+    LLVMFuzzerTestOneInput(buffer, size);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint8_t *buffer = malloc(FUZZ_MAIN_MAX_INPUT);
+
+    if (buffer == NULL) {
+        return 1;
+    }
+
+    if (argc < 2) {
+        int result = run_file(stdin, buffer);
+        free(buffer);
+        return result == 0 ? 0 : 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL || run_file(file, buffer) != 0) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            if (file != NULL) {
+                fclose(file);
+            }
+            free(buffer);
+            return 1;
+        }
+        fclose(file);
+        printf("%s: ok\n", argv[i]);
+    }
+
+    free(buffer);
+    return 0;
+}
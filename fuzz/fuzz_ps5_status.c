@@ -0,0 +1,53 @@
+/**
+ * @file fuzz_ps5_status.c
+ * @brief Fuzz target for PS5 status replies
+ *
+ * Runs server replies through on_ws_message(), covering both the short
+ * message path and the indexed path of parse_ps5_status(). The parser
+ * is internal, so the state machine is compiled into this file.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_ps5_status \
+ *       fuzz/fuzz_ps5_status.c fuzz/fuzz_guard.c \
+ *       src/vpn_controller.c src/vpn_shm.c src/websocket_client.c src/json_scan.c \
+ *       src/press_budget.c src/server_fanout.c src/failure_stats.c src/button_handler.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "../src/client_state_machine.c"
+#include "fuzz_guard.h"
+
+static client_context_t *g_fuzz_ctx;
+
+static void run_status_reply(const uint8_t *data, size_t size) {
+    // Replies only move the state machine while a query is running
+    g_fuzz_ctx->current_state = CLIENT_STATE_QUERYING_PS5;
+    g_fuzz_ctx->ps5_status = PS5_STATUS_UNKNOWN;
+    g_fuzz_ctx->primary_entry.result = FANOUT_RESULT_PENDING;
+
+    on_ws_message((const char *)data, size, g_fuzz_ctx);
+
+    // The first reply of a query is shown as parsed
+    if (g_fuzz_ctx->ps5_status != parse_ps5_status((const char *)data, size)) {
+        abort();
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (g_fuzz_ctx == NULL) {
+        client_config_t config;
+        memset(&config, 0, sizeof(config));
+        strncpy(config.ws_server_host, "192.168.1.1", sizeof(config.ws_server_host) - 1);
+        config.ws_server_port = 8080;
+
+        g_fuzz_ctx = client_sm_create(&config);
+        if (g_fuzz_ctx == NULL) {
+            abort();
+        }
+    }
+
+    fuzz_guard_run(run_status_reply, data, size);
+    return 0;
+}
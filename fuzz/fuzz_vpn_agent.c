@@ -0,0 +1,57 @@
+/**
+ * @file fuzz_vpn_agent.c
+ * @brief Fuzz target for VPN agent replies
+ *
+ * Runs the state, info and progress parsers on the input as one reply,
+ * then feeds it through line reassembly with a connect pending. The
+ * parsers are internal, so the controller is compiled into this file.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_vpn_agent \
+ *       fuzz/fuzz_vpn_agent.c fuzz/fuzz_guard.c src/vpn_shm.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "../src/vpn_controller.c"
+#include "fuzz_guard.h"
+
+#include <stdlib.h>
+
+static volatile size_t g_sink;
+
+static void run_agent_reply(const uint8_t *data, size_t size) {
+    char reply[VPN_MAX_MESSAGE_SIZE];
+    vpn_info_t info;
+
+    // One receive as receive_response() terminates it
+    size_t length = size < sizeof(reply) - 1 ? size : sizeof(reply) - 1;
+    memcpy(reply, data, length);
+    reply[length] = '\0';
+
+    memset(&info, 0, sizeof(info));
+    parse_info_from_response(reply, &info);
+    g_sink += (size_t)info.state + info.bytes_sent + strlen(info.server_ip) +
+              strlen(info.local_ip);
+    g_sink += (size_t)parse_stage_from_event(reply);
+
+    // The same bytes as a stream of receives
+    if (!g_vpn_ctx.operation_pending) {
+        start_operation("connect", VPN_STATE_CONNECTING, VPN_CONNECT_TIMEOUT_MS);
+    }
+    g_vpn_ctx.rx_len = 0;
+    for (size_t offset = 0; offset < size; offset += sizeof(reply) - 1) {
+        size_t chunk = size - offset < sizeof(reply) - 1 ? size - offset : sizeof(reply) - 1;
+        handle_agent_data((const char *)data + offset, chunk);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (!g_vpn_ctx.initialized && vpn_controller_init(NULL) != 0) {
+        abort();
+    }
+
+    fuzz_guard_run(run_agent_reply, data, size);
+    return 0;
+}
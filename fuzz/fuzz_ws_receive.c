@@ -0,0 +1,57 @@
+/**
+ * @file fuzz_ws_receive.c
+ * @brief Fuzz target for WebSocket receive handling
+ *
+ * Feeds server messages through reassembly, UTF-8 validation and the
+ * hello, batch and hint protocol messages. The first input byte picks
+ * where the message is split into two receive callbacks.
+ *
+ *   clang -std=c99 -g -O1 -fsanitize=fuzzer,address,undefined -DTESTING \
+ *       -Isrc -Ifuzz -o fuzz_ws_receive \
+ *       fuzz/fuzz_ws_receive.c fuzz/fuzz_guard.c \
+ *       src/websocket_client.c src/json_scan.c
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "websocket_client.h"
+#include "fuzz_guard.h"
+
+#include <stdlib.h>
+
+static volatile size_t g_sink;
+
+static void on_message(const char *message, size_t length, void *user_data) {
+    g_sink += length > 0 ? (size_t)(unsigned char)message[length - 1] : 0;
+}
+
+static void run_receive(const uint8_t *data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const char *message = (const char *)data + 1;
+    size_t length = size - 1;
+    size_t split = length * data[0] / 256;
+
+    if (split > 0) {
+        ws_client_test_receive(message, split, false);
+    }
+    ws_client_test_receive(message + split, length - split, true);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static int initialized = 0;
+
+    if (!initialized) {
+        if (ws_client_init("192.168.1.1", 8080) != 0) {
+            abort();
+        }
+        ws_client_set_callbacks(NULL, NULL, on_message, NULL, NULL);
+        initialized = 1;
+    }
+
+    fuzz_guard_run(run_receive, data, size);
+    return 0;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file client_features.h
+ * @brief Client Features - Build-time subsystem switches
+ *
+ * Some devices have no button or no LED, and some deployments never use
+ * the VPN. Each switch below defaults to on; a build passes 0 for the
+ * subsystems it lacks (the package Makefile does so from its config
+ * options) and everything behind the switch is compiled out:
+ * - The module's sources are not linked
+ * - Its init, per-tick and cleanup calls are gone
+ * - The state machine skips its workflow phase
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef CLIENT_FEATURES_H
+#define CLIENT_FEATURES_H
+
+/**
+ * @defgroup ClientFeatures Client Features
+ * @brief Subsystems selected at build time
+ * @{
+ */
+
+/** Physical button; without it presses come from SIGUSR1 or the control socket */
+#ifndef CLIENT_FEATURE_BUTTON
+#define CLIENT_FEATURE_BUTTON   1
+#endif
+
+/** Status LED; without it results are only published to status clients */
+#ifndef CLIENT_FEATURE_LED
+#define CLIENT_FEATURE_LED      1
+#endif
+
+/** VPN tunnel; without it the server is reached over the local network */
+#ifndef CLIENT_FEATURE_VPN
+#define CLIENT_FEATURE_VPN      1
+#endif
+
+/** @} */ // end of ClientFeatures
+
+#endif // CLIENT_FEATURES_H
@@ -17,9 +17,15 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include "client_state_machine.h"
+#if CLIENT_FEATURE_BUTTON
 #include "button_handler.h"
+#endif
+#if CLIENT_FEATURE_VPN
 #include "vpn_controller.h"
+#endif
 #include "websocket_client.h"
+#include "json_scan.h"
+#include "server_fanout.h"
 
 #ifndef TESTING
   #ifdef OPENWRT_BUILD
@@ -31,10 +37,24 @@
   #endif
 #endif
 
+// Hardware is only driven by a real build that has it
+#if !defined(TESTING) && CLIENT_FEATURE_BUTTON
+#define CLIENT_USE_BUTTON   1
+#else
+#define CLIENT_USE_BUTTON   0
+#endif
+
+#if !defined(TESTING) && CLIENT_FEATURE_LED
+#define CLIENT_USE_LED      1
+#else
+#define CLIENT_USE_LED      0
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <signal.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -72,10 +92,62 @@ struct client_context_t {
     client_error_t last_error;
     int error_count;
     bool in_error_recovery;
+    bool retry_armed;               // Error state has set its deadline
+    uint32_t retry_at;              // Leave the error state at this time
     
     // LED update tracking
     bool led_update_done;
     uint32_t led_update_start_time;
+    
+    // PS5 query of the running workflow
+    bool query_sent;
+    bool query_parse_failed;        // A reply arrived without a status
+    bool fanout_queried;            // Extra servers were asked this press
+    
+    // Primary failure held back while extra servers may still answer
+    bool primary_failed;
+    client_error_t primary_error;
+    failure_cause_t primary_cause;
+    char primary_detail[FAILURE_DETAIL_MAX];
+    
+    // Cancellation (set from signal handlers, applied in update)
+    volatile sig_atomic_t pending_cancel;
+    volatile sig_atomic_t stop_requested;
+    
+    // Press budget
+    press_budget_t budget;
+    uint32_t phase_timeout;         // Allowance of the running phase
+    bool phase_overrun;             // Running phase hit its allowance
+    bool status_from_cache;         // Press answered from cached status
+    
+    // Primary server row of the status table
+    fanout_entry_t primary_entry;
+    uint32_t primary_query_time;
+    
+    // Redirect from the primary server, applied in update
+    bool redirect_pending;
+    char redirect_host[256];
+    int redirect_port;
+    bool redirect_reconnect;        // Press waits to connect to the new primary
+    
+    // Last good PS5 status, for budget fallback
+    bool has_cached_status;
+    ps5_status_t cached_status;
+    uint32_t cached_status_time;
+    
+    // Idle release
+    bool resources_released;        // Agent link and WS context given back
+    bool press_cold;                // Running press started released
+    uint32_t press_start_time;      // 0 once the press reached the server
+    client_idle_stats_t idle_stats;
+    
+    // Pre-warm ahead of a likely press
+    bool prewarm_active;
+    bool prewarm_vpn_started;
+    uint32_t prewarm_until;
+    
+    // Failures by cause and time to recover
+    failure_stats_t failures;
 };
 
 /* ============================================================
@@ -83,21 +155,28 @@ struct client_context_t {
  * ============================================================ */
 
 static void change_state(client_context_t *ctx, client_state_t new_state);
-static void report_error(client_context_t *ctx, client_error_t error, const char *message);
+static void report_error(client_context_t *ctx, client_error_t error, failure_cause_t cause,
+                         const char *message);
 static void update_led_for_state(client_context_t *ctx, client_state_t state);
 static void update_led_for_ps5_status(client_context_t *ctx, ps5_status_t status);
 
-#ifndef TESTING
+#if CLIENT_USE_BUTTON
 static void on_button_event(button_event_t event, void *user_data);
 #endif
+#if CLIENT_FEATURE_VPN
 static void on_vpn_state_change(vpn_state_t old_state, vpn_state_t new_state, void *user_data);
+static void on_vpn_progress(vpn_connect_stage_t stage, void *user_data);
+#endif
 static void on_ws_message(const char *message, size_t length, void *user_data);
 static void on_ws_connected(void *user_data);
 static void on_ws_disconnected(const char *reason, void *user_data);
 static void on_ws_error(ws_error_t error, const char *message, void *user_data);
+static void on_ws_redirect(const char *host, int port, void *user_data);
 
 static void handle_idle_state(client_context_t *ctx);
+#if CLIENT_FEATURE_VPN
 static void handle_vpn_connecting_state(client_context_t *ctx);
+#endif
 static void handle_vpn_connected_state(client_context_t *ctx);
 static void handle_ws_connecting_state(client_context_t *ctx);
 static void handle_querying_ps5_state(client_context_t *ctx);
@@ -131,6 +210,236 @@ static bool is_state_timeout(client_context_t *ctx) {
     return (current_time - ctx->state_enter_time) >= ctx->current_timeout;
 }
 
+/**
+ * @brief Check if a message view contains a pattern
+ */
+static bool message_contains(const char *message, size_t length, const char *pattern) {
+    size_t pattern_length = strlen(pattern);
+    const char *p = message;
+    const char *end = message + length;
+    
+    while ((size_t)(end - p) >= pattern_length) {
+        p = memchr(p, pattern[0], (size_t)(end - p) - pattern_length + 1);
+        if (p == NULL) {
+            return false;
+        }
+        if (memcmp(p, pattern, pattern_length) == 0) {
+            return true;
+        }
+        p++;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Extract PS5 status from a server message
+ * 
+ * Small replies use plain substring matching. Bulk payloads (multi-console
+ * tables, history) go through the SIMD structural scanner instead. The
+ * message is a view and is not null-terminated.
+ */
+static ps5_status_t parse_ps5_status(const char *message, size_t length) {
+    if (length >= JSON_SCAN_SIMD_THRESHOLD) {
+        const char *value;
+        size_t value_length;
+        
+        // UTF-8 was already validated by the WebSocket client
+        if (json_scan_find_string(message, length, "status", &value, &value_length) != 0) {
+            return PS5_STATUS_UNKNOWN;
+        }
+        
+        if (value_length == 2 && memcmp(value, "on", 2) == 0) {
+            return PS5_STATUS_ON;
+        } else if (value_length == 7 && memcmp(value, "standby", 7) == 0) {
+            return PS5_STATUS_STANDBY;
+        } else if (value_length == 3 && memcmp(value, "off", 3) == 0) {
+            return PS5_STATUS_OFF;
+        }
+        return PS5_STATUS_UNKNOWN;
+    }
+    
+    // Simple parsing - in production use proper JSON library
+    if (message_contains(message, length, "\"status\":\"on\"")) {
+        return PS5_STATUS_ON;
+    } else if (message_contains(message, length, "\"status\":\"standby\"")) {
+        return PS5_STATUS_STANDBY;
+    } else if (message_contains(message, length, "\"status\":\"off\"")) {
+        return PS5_STATUS_OFF;
+    }
+    return PS5_STATUS_UNKNOWN;
+}
+
+/**
+ * @brief Reply parser handed to the fan-out module
+ */
+static int parse_fanout_status(const char *message, size_t length) {
+    ps5_status_t status = parse_ps5_status(message, length);
+    return (status == PS5_STATUS_UNKNOWN) ? -1 : (int)status;
+}
+
+/**
+ * @brief Record the primary server's result for the status table
+ */
+static void finish_primary_query(client_context_t *ctx, fanout_result_t result, int status) {
+    if (ctx->primary_entry.result != FANOUT_RESULT_PENDING) {
+        return;
+    }
+    
+    ctx->primary_entry.result = result;
+    ctx->primary_entry.status = status;
+    ctx->primary_entry.latency_ms = get_current_time_ms() - ctx->primary_query_time;
+    switch (result) {
+        case FANOUT_RESULT_OK:      ctx->primary_entry.replies++;   break;
+        case FANOUT_RESULT_TIMEOUT: ctx->primary_entry.timeouts++;  break;
+        case FANOUT_RESULT_ERROR:   ctx->primary_entry.errors++;    break;
+        default:                                                    break;
+    }
+}
+
+/**
+ * @brief Map a state to its budgeted phase
+ * 
+ * @return Phase, or -1 if the state is not budgeted
+ */
+static int phase_for_state(client_state_t state) {
+    switch (state) {
+        case CLIENT_STATE_VPN_CONNECTING:   return PRESS_PHASE_VPN;
+        case CLIENT_STATE_WS_CONNECTING:    return PRESS_PHASE_WS;
+        case CLIENT_STATE_QUERYING_PS5:     return PRESS_PHASE_QUERY;
+        default:                            return -1;
+    }
+}
+
+/**
+ * @brief Account budget on a state transition
+ */
+static void update_budget(client_context_t *ctx, client_state_t old_state,
+                          client_state_t new_state, uint32_t now) {
+    if (phase_for_state(old_state) >= 0) {
+        press_budget_end_phase(&ctx->budget, now, ctx->phase_overrun);
+        ctx->phase_overrun = false;
+    }
+    
+    // Every press (or restart) enters the workflow through the start state
+    if (new_state == CLIENT_STATE_PRESS_START) {
+        press_budget_start(&ctx->budget, now);
+        ctx->status_from_cache = false;
+    }
+    
+    int phase = phase_for_state(new_state);
+    if (phase >= 0) {
+        ctx->phase_timeout = press_budget_begin_phase(&ctx->budget, (press_phase_t)phase, now);
+    }
+    
+    if (new_state == CLIENT_STATE_LED_UPDATE || new_state == CLIENT_STATE_ERROR) {
+        press_budget_finish(&ctx->budget,
+                            new_state == CLIENT_STATE_ERROR &&
+                            ctx->last_error == CLIENT_ERROR_BUDGET_EXCEEDED,
+                            ctx->status_from_cache);
+    }
+}
+
+/**
+ * @brief Read resident set size of this process
+ * 
+ * @return Resident memory in KB, 0 if unavailable
+ */
+static uint32_t read_rss_kb(void) {
+    FILE *file = fopen("/proc/self/statm", "r");
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    
+    if (file == NULL) {
+        return 0;
+    }
+    if (fscanf(file, "%lu %lu", &size, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(file);
+    
+    return (uint32_t)(resident * (unsigned long)sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Account press-to-server time of the running press
+ */
+static void record_connect_latency(client_context_t *ctx, uint32_t now) {
+    if (ctx->press_start_time == 0) {
+        return;  // Already counted, or a restarted workflow
+    }
+    
+    uint32_t elapsed = now - ctx->press_start_time;
+    if (ctx->press_cold) {
+        ctx->idle_stats.cold_connects++;
+        ctx->idle_stats.cold_connect_ms_total += elapsed;
+    } else {
+        ctx->idle_stats.warm_connects++;
+        ctx->idle_stats.warm_connect_ms_total += elapsed;
+    }
+    ctx->press_start_time = 0;
+}
+
+/**
+ * @brief Give back the agent link and WS context after a long idle
+ */
+static void release_idle_resources(client_context_t *ctx) {
+    uint32_t rss_before = read_rss_kb();
+    
+    // The agent may still hold a lingering session; try again next period
+    #if CLIENT_FEATURE_VPN
+    if (vpn_controller_release() < 0) {
+        ctx->state_enter_time = get_current_time_ms();
+        return;
+    }
+    #endif
+    
+    // A WS context still in use is rebuilt lazily anyway
+    if (ws_client_suspend() < 0) {
+        #ifndef TESTING
+        logger_warning("WebSocket context in use, kept while idle");
+        #endif
+    }
+    
+    uint32_t rss_after = read_rss_kb();
+    uint32_t saved = (rss_before > rss_after) ? rss_before - rss_after : 0;
+    
+    ctx->resources_released = true;
+    ctx->idle_stats.releases++;
+    ctx->idle_stats.last_saved_kb = saved;
+    if (saved > ctx->idle_stats.max_saved_kb) {
+        ctx->idle_stats.max_saved_kb = saved;
+    }
+    
+    #ifndef TESTING
+    logger_info("Released idle resources, %u KB resident freed", saved);
+    #endif
+}
+
+/**
+ * @brief Rebuild what release_idle_resources() gave back
+ */
+static void restore_idle_resources(client_context_t *ctx) {
+    uint32_t start = get_current_time_ms();
+    
+    // The agent socket reopens with the next command and shared state
+    // stays attached across the release, so only the WS context is rebuilt
+    if (ws_client_resume() < 0) {
+        #ifndef TESTING
+        logger_warning("Failed to rebuild WebSocket context, retried on connect");
+        #endif
+    }
+    
+    uint32_t elapsed = get_current_time_ms() - start;
+    
+    ctx->resources_released = false;
+    ctx->idle_stats.restores++;
+    ctx->idle_stats.last_restore_ms = elapsed;
+    if (elapsed > ctx->idle_stats.max_restore_ms) {
+        ctx->idle_stats.max_restore_ms = elapsed;
+    }
+}
+
 /**
  * @brief Change state and trigger callback
  */
@@ -143,6 +452,39 @@ static void change_state(client_context_t *ctx, client_state_t new_state) {
     ctx->current_state = new_state;
     ctx->state_enter_time = get_current_time_ms();
     
+    update_budget(ctx, ctx->previous_state, new_state, ctx->state_enter_time);
+    
+    if (new_state == CLIENT_STATE_ERROR) {
+        ctx->retry_armed = false;  // Armed on the first pass of the handler
+    }
+    
+    if (new_state != CLIENT_STATE_WS_CONNECTING) {
+        ctx->redirect_reconnect = false;
+    }
+    
+    if (new_state == CLIENT_STATE_PRESS_START) {
+        ctx->fanout_queried = false;
+        ctx->primary_failed = false;
+    }
+    
+    if (ctx->previous_state == CLIENT_STATE_IDLE && new_state == CLIENT_STATE_PRESS_START) {
+        ctx->press_start_time = ctx->state_enter_time;
+        ctx->press_cold = ctx->resources_released;
+        
+        // The press takes over the links of a running pre-warm
+        if (ctx->prewarm_active) {
+            ctx->prewarm_active = false;
+            ctx->stats.prewarm_hits++;
+        }
+    }
+    
+    if (new_state == CLIENT_STATE_QUERYING_PS5) {
+        ctx->query_sent = false;
+        ctx->query_parse_failed = false;
+        ctx->ps5_status = PS5_STATUS_UNKNOWN;  // Aggregated from this press's replies
+        record_connect_latency(ctx, ctx->state_enter_time);
+    }
+    
     #ifndef TESTING
     logger_info("Client state changed: %s -> %s",
              client_state_to_string(ctx->previous_state),
@@ -157,11 +499,16 @@ static void change_state(client_context_t *ctx, client_state_t new_state) {
 
 /**
  * @brief Report error
+ * 
+ * The message doubles as the detail of the failure record, so callers
+ * pass on what the failing layer said.
  */
-static void report_error(client_context_t *ctx, client_error_t error, const char *message) {
+static void report_error(client_context_t *ctx, client_error_t error, failure_cause_t cause,
+                         const char *message) {
     ctx->last_error = error;
     ctx->error_count++;
     ctx->stats.error_count++;
+    failure_stats_record(&ctx->failures, cause, message, get_current_time_ms());
     
     #ifndef TESTING
     logger_error("Client error: %s - %s", client_error_to_string(error), message);
@@ -172,12 +519,241 @@ static void report_error(client_context_t *ctx, client_error_t error, const char
     }
 }
 
+#if CLIENT_FEATURE_VPN
+/**
+ * @brief Map a VPN controller error to a failure cause
+ */
+static failure_cause_t vpn_failure_cause(vpn_error_t error) {
+    switch (error) {
+        case VPN_ERROR_SOCKET:
+        case VPN_ERROR_AGENT_UNREACHABLE:   return FAILURE_CAUSE_AGENT_UNREACHABLE;
+        case VPN_ERROR_REJECTED:            return FAILURE_CAUSE_VPN_REJECTED;
+        case VPN_ERROR_RESOLVE_TIMEOUT:     return FAILURE_CAUSE_VPN_DNS;
+        case VPN_ERROR_HANDSHAKE_TIMEOUT:   return FAILURE_CAUSE_VPN_HANDSHAKE_TIMEOUT;
+        case VPN_ERROR_TIMEOUT:
+        case VPN_ERROR_MAX_RETRIES:         return FAILURE_CAUSE_VPN_TIMEOUT;
+        default:                            return FAILURE_CAUSE_AGENT_PROTOCOL;
+    }
+}
+
+/**
+ * @brief Map the connect stage a VPN phase timed out in to a failure cause
+ */
+static failure_cause_t vpn_timeout_cause(vpn_connect_stage_t stage) {
+    switch (stage) {
+        case VPN_STAGE_RESOLVING:           return FAILURE_CAUSE_VPN_DNS;
+        case VPN_STAGE_HANDSHAKING:         return FAILURE_CAUSE_VPN_HANDSHAKE_TIMEOUT;
+        default:                            return FAILURE_CAUSE_VPN_TIMEOUT;
+    }
+}
+#endif
+
+/**
+ * @brief Map a WebSocket error to a failure cause
+ */
+static failure_cause_t ws_failure_cause(ws_error_t error) {
+    switch (error) {
+        case WS_ERROR_DNS:                  return FAILURE_CAUSE_WS_DNS;
+        case WS_ERROR_REFUSED:              return FAILURE_CAUSE_WS_REFUSED;
+        case WS_ERROR_HANDSHAKE:            return FAILURE_CAUSE_WS_HANDSHAKE;
+        case WS_ERROR_TIMEOUT:              return FAILURE_CAUSE_WS_TIMEOUT;
+        case WS_ERROR_PONG_TIMEOUT:         return FAILURE_CAUSE_WS_PONG_TIMEOUT;
+        default:                            return FAILURE_CAUSE_WS_ERROR;
+    }
+}
+
+/**
+ * @brief Handle a phase running out of time
+ * 
+ * When the allowance was cut by the press budget, a recent cached status
+ * is shown instead of an error; otherwise the press fails right away.
+ */
+static void handle_phase_timeout(client_context_t *ctx, client_error_t error,
+                                 failure_cause_t cause, const char *message) {
+    bool limited = press_budget_is_limited(&ctx->budget);
+    uint32_t now = get_current_time_ms();
+    
+    ctx->phase_overrun = true;
+    
+    if (limited && ctx->has_cached_status &&
+        now - ctx->cached_status_time <= CLIENT_STATUS_CACHE_MAX_AGE_S * 1000) {
+        #ifndef TESTING
+        logger_warning("%s, press budget spent: showing cached status %s",
+                   message, ps5_status_to_string(ctx->cached_status));
+        #endif
+        ctx->ps5_status = ctx->cached_status;
+        ctx->status_from_cache = true;
+        change_state(ctx, CLIENT_STATE_LED_UPDATE);
+        return;
+    }
+    
+    if (limited) {
+        report_error(ctx, CLIENT_ERROR_BUDGET_EXCEEDED, FAILURE_CAUSE_BUDGET, message);
+    } else {
+        report_error(ctx, error, cause, message);
+    }
+    change_state(ctx, CLIENT_STATE_ERROR);
+}
+
+/**
+ * @brief Check if extra servers may still answer the running press
+ */
+static bool fanout_pending(const client_context_t *ctx) {
+    return ctx->fanout_queried && !server_fanout_is_complete();
+}
+
+/**
+ * @brief Handle the primary server failing its part of the press
+ * 
+ * While extra servers may still answer, the failure is held back and the
+ * press waits for them in the query state; it fails only once every
+ * server has failed or timed out.
+ */
+static void fail_primary(client_context_t *ctx, client_error_t error, failure_cause_t cause,
+                         const char *message) {
+    if (!fanout_pending(ctx)) {
+        report_error(ctx, error, cause, message);
+        change_state(ctx, CLIENT_STATE_ERROR);
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_warning("%s, waiting for fan-out servers", message);
+    #endif
+    
+    change_state(ctx, CLIENT_STATE_QUERYING_PS5);
+    ctx->primary_failed = true;
+    ctx->primary_error = error;
+    ctx->primary_cause = cause;
+    snprintf(ctx->primary_detail, sizeof(ctx->primary_detail), "%s", message);
+}
+
+/**
+ * @brief Release the VPN after a workflow
+ * 
+ * A healthy tunnel is suspended so the next press can resume it without
+ * a handshake; anything else gets a full disconnect.
+ */
+static void release_vpn(client_context_t *ctx) {
+    #if CLIENT_FEATURE_VPN
+    vpn_state_t vpn_state = vpn_controller_get_state();
+    
+    if (vpn_state == VPN_STATE_SUSPENDED) {
+        return;
+    }
+    
+    if (vpn_state == VPN_STATE_CONNECTED && ctx->config.vpn_linger_ms > 0) {
+        vpn_controller_suspend(ctx->config.vpn_linger_ms);
+    } else {
+        vpn_controller_disconnect();
+    }
+    #endif
+}
+
+/**
+ * @brief Close the budget of a workflow that did not run to the end
+ */
+static void drop_press(client_context_t *ctx) {
+    uint32_t now = get_current_time_ms();
+    
+    press_budget_end_phase(&ctx->budget, now, false);
+    press_budget_finish(&ctx->budget, false, false);
+    ctx->phase_overrun = false;
+    ctx->query_sent = false;
+    ctx->fanout_queried = false;
+    ctx->primary_failed = false;
+    ctx->redirect_reconnect = false;
+}
+
+/**
+ * @brief Restart the workflow for a new press
+ * 
+ * Links are left as they are: a connected or connecting VPN and WebSocket
+ * are picked up again by the state handlers instead of being torn down.
+ */
+static void restart_workflow(client_context_t *ctx) {
+    drop_press(ctx);
+    ctx->stats.restarted_workflows++;
+    ctx->last_error = CLIENT_ERROR_NONE;
+    ctx->error_count = 0;
+    
+    if (ctx->current_state == CLIENT_STATE_PRESS_START) {
+        // Already in the first phase, only rearm its deadline
+        ctx->state_enter_time = get_current_time_ms();
+        update_budget(ctx, CLIENT_STATE_PRESS_START, CLIENT_STATE_PRESS_START,
+                      ctx->state_enter_time);
+    } else {
+        change_state(ctx, CLIENT_STATE_PRESS_START);
+    }
+}
+
+/**
+ * @brief Abort the workflow and release its resources now
+ */
+static void abort_workflow(client_context_t *ctx, client_cancel_t reason) {
+    drop_press(ctx);
+    ctx->stats.cancelled_workflows++;
+    
+    // Drops a connect or query still in flight
+    ws_client_disconnect();
+    server_fanout_disconnect_all();
+    
+    // A disconnect supersedes a VPN command still in flight; after a
+    // config change the session may point at the wrong server
+    #if CLIENT_FEATURE_VPN
+    if (reason == CLIENT_CANCEL_CONFIG_CHANGE) {
+        vpn_controller_disconnect();
+    } else {
+        release_vpn(ctx);
+    }
+    #endif
+    
+    #if CLIENT_USE_LED
+    led_off();
+    #endif
+    
+    change_state(ctx, CLIENT_STATE_IDLE);
+}
+
+/**
+ * @brief Act on a cancellation request
+ */
+static void apply_pending_cancel(client_context_t *ctx) {
+    client_cancel_t reason = (client_cancel_t)ctx->pending_cancel;
+    
+    if (reason == CLIENT_CANCEL_NONE) {
+        return;
+    }
+    ctx->pending_cancel = CLIENT_CANCEL_NONE;
+    
+    // A press in idle starts the workflow, it cancels nothing
+    if (reason == CLIENT_CANCEL_NEW_PRESS && ctx->current_state == CLIENT_STATE_IDLE) {
+        #ifndef TESTING
+        logger_info("Button press: starting workflow");
+        #endif
+        change_state(ctx, CLIENT_STATE_PRESS_START);
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_info("Workflow cancelled: %s (state %s)",
+             client_cancel_to_string(reason),
+             client_state_to_string(ctx->current_state));
+    #endif
+    
+    if (reason == CLIENT_CANCEL_NEW_PRESS) {
+        restart_workflow(ctx);
+    } else if (ctx->current_state != CLIENT_STATE_IDLE) {
+        abort_workflow(ctx, reason);
+    }
+}
+
 /**
  * @brief Update LED based on state
  */
 
 static void update_led_for_state(client_context_t *ctx, client_state_t state) {
-    #ifndef TESTING
+    #if CLIENT_USE_LED
     switch (state) {
         case CLIENT_STATE_IDLE:
             // LED off in idle
@@ -220,6 +796,7 @@ static void update_led_for_ps5_status(client_context_t *ctx, ps5_status_t status
     ctx->led_update_start_time = get_current_time_ms();
     ctx->led_update_done = false;
     
+    #if CLIENT_USE_LED
     switch (status) {
         case PS5_STATUS_ON:
             // White (符合規格)
@@ -243,11 +820,12 @@ static void update_led_for_ps5_status(client_context_t *ctx, ps5_status_t status
     
     logger_info("LED updated for PS5 status: %s", ps5_status_to_string(status));
     #endif
+    #endif
 }
 /**
  * @brief Button event callback
  */
-#ifndef TESTING
+#if CLIENT_USE_BUTTON
 static void on_button_event(button_event_t event, void *user_data) {
     client_context_t *ctx = (client_context_t *)user_data;
     
@@ -259,13 +837,21 @@ static void on_button_event(button_event_t event, void *user_data) {
     
     ctx->stats.button_press_count++;
     
-    // Only handle short press in idle state
-    if (event == BUTTON_EVENT_SHORT_PRESS && ctx->current_state == CLIENT_STATE_IDLE) {
-        change_state(ctx, CLIENT_STATE_VPN_CONNECTING);
+    // A short press starts the workflow, or restarts it when busy; a long
+    // press cancels it
+    if (event == BUTTON_EVENT_SHORT_PRESS) {
+        if (ctx->current_state == CLIENT_STATE_IDLE) {
+            change_state(ctx, CLIENT_STATE_PRESS_START);
+        } else {
+            client_sm_cancel(ctx, CLIENT_CANCEL_NEW_PRESS);
+        }
+    } else if (event == BUTTON_EVENT_LONG_PRESS && ctx->current_state != CLIENT_STATE_IDLE) {
+        client_sm_cancel(ctx, CLIENT_CANCEL_LONG_PRESS);
     }
 }
 #endif
 
+#if CLIENT_FEATURE_VPN
 /**
  * @brief VPN state change callback
  */
@@ -286,6 +872,70 @@ static void on_vpn_state_change(vpn_state_t old_state, vpn_state_t new_state, vo
     }
 }
 
+/**
+ * @brief VPN connect progress callback
+ */
+static void on_vpn_progress(vpn_connect_stage_t stage, void *user_data) {
+    client_context_t *ctx = (client_context_t *)user_data;
+    
+    if (ctx == NULL) {
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_info("VPN connect progress: %s (state %s)",
+             vpn_controller_stage_to_string(stage),
+             client_state_to_string(ctx->current_state));
+    #endif
+}
+#endif
+
+/**
+ * @brief Check if replies belong to a press in progress
+ * 
+ * Extra servers are queried while the primary still connects, so their
+ * replies count from the WebSocket phase on.
+ */
+static bool is_collecting_replies(const client_context_t *ctx) {
+    return ctx->current_state == CLIENT_STATE_WS_CONNECTING ||
+           ctx->current_state == CLIENT_STATE_QUERYING_PS5 ||
+           ctx->current_state == CLIENT_STATE_LED_UPDATE;
+}
+
+/**
+ * @brief Merge one server's reply into the press result
+ * 
+ * The LED shows the most awake console across all servers. The first
+ * reply ends the query phase; later ones refresh the LED.
+ */
+static void merge_ps5_status(client_context_t *ctx, ps5_status_t status) {
+    if (!is_collecting_replies(ctx)) {
+        ctx->ps5_status = status;  // Unsolicited update outside a press
+        return;
+    }
+    
+    // Not a status reply: keep collecting until the phase deadline
+    if (status == PS5_STATUS_UNKNOWN && ctx->current_state != CLIENT_STATE_LED_UPDATE) {
+        return;
+    }
+    
+    if (ctx->current_state == CLIENT_STATE_LED_UPDATE) {
+        if (status <= ctx->ps5_status) {
+            return;  // Nothing new to show
+        }
+        ctx->led_update_done = false;  // Show the better status
+    }
+    ctx->ps5_status = status;
+    
+    if (ctx->ps5_status != PS5_STATUS_UNKNOWN) {
+        ctx->has_cached_status = true;
+        ctx->cached_status = ctx->ps5_status;
+        ctx->cached_status_time = get_current_time_ms();
+    }
+    
+    change_state(ctx, CLIENT_STATE_LED_UPDATE);
+}
+
 /**
  * @brief WebSocket message callback
  */
@@ -301,79 +951,253 @@ static void on_ws_message(const char *message, size_t length, void *user_data) {
     #endif
     
     // Parse PS5 status from message
-    // Simple parsing - in production use proper JSON library
-    if (strstr(message, "\"status\":\"on\"")) {
-        ctx->ps5_status = PS5_STATUS_ON;
-        ctx->stats.successful_queries++;
-    } else if (strstr(message, "\"status\":\"standby\"")) {
-        ctx->ps5_status = PS5_STATUS_STANDBY;
-        ctx->stats.successful_queries++;
-    } else if (strstr(message, "\"status\":\"off\"")) {
-        ctx->ps5_status = PS5_STATUS_OFF;
+    ps5_status_t status = parse_ps5_status(message, length);
+    if (status != PS5_STATUS_UNKNOWN) {
         ctx->stats.successful_queries++;
+        finish_primary_query(ctx, FANOUT_RESULT_OK, (int)status);
+        failure_stats_recovered(&ctx->failures, get_current_time_ms());
     } else {
-        ctx->ps5_status = PS5_STATUS_UNKNOWN;
         ctx->stats.failed_queries++;
+        if (ctx->current_state == CLIENT_STATE_QUERYING_PS5) {
+            ctx->query_parse_failed = true;
+        }
     }
     
     ctx->stats.last_query_time = time(NULL);
     
-    // Transition to LED update state
-    if (ctx->current_state == CLIENT_STATE_QUERYING_PS5) {
-        change_state(ctx, CLIENT_STATE_LED_UPDATE);
+    merge_ps5_status(ctx, status);
+}
+
+/**
+ * @brief Fan-out result callback
+ */
+static void on_fanout_result(int index, const fanout_entry_t *entry, void *user_data) {
+    client_context_t *ctx = (client_context_t *)user_data;
+    
+    if (ctx == NULL || entry->result != FANOUT_RESULT_OK) {
+        return;
     }
+    
+    failure_stats_recovered(&ctx->failures, get_current_time_ms());
+    merge_ps5_status(ctx, (ps5_status_t)entry->status);
 }
 
 /**
  * @brief WebSocket connected callback
  */
-static void on_ws_connected(void *user_data) {
-    client_context_t *ctx = (client_context_t *)user_data;
-    
-    if (ctx == NULL) {
+static void on_ws_connected(void *user_data) {
+    client_context_t *ctx = (client_context_t *)user_data;
+    
+    if (ctx == NULL) {
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_info("WebSocket connected");
+    #endif
+    
+    // Transition to querying state if in connecting state
+    if (ctx->current_state == CLIENT_STATE_WS_CONNECTING) {
+        change_state(ctx, CLIENT_STATE_QUERYING_PS5);
+    }
+}
+
+/**
+ * @brief WebSocket disconnected callback
+ */
+static void on_ws_disconnected(const char *reason, void *user_data) {
+    #ifndef TESTING
+    logger_warning("WebSocket disconnected: %s", reason ? reason : "unknown");
+    #endif
+    (void)user_data;  // Unused in current implementation
+}
+
+/**
+ * @brief WebSocket error callback
+ */
+static void on_ws_error(ws_error_t error, const char *message, void *user_data) {
+    client_context_t *ctx = (client_context_t *)user_data;
+    
+    if (ctx == NULL) {
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_error("WebSocket error: %s - %s", 
+              ws_client_error_to_string(error), 
+              message ? message : "unknown");
+    #endif
+    
+    if ((ctx->current_state == CLIENT_STATE_WS_CONNECTING ||
+         ctx->current_state == CLIENT_STATE_QUERYING_PS5) && !ctx->primary_failed) {
+        finish_primary_query(ctx, FANOUT_RESULT_ERROR, -1);
+        fail_primary(ctx, CLIENT_ERROR_WS_FAILED, ws_failure_cause(error),
+                     message ? message : "WebSocket error");
+    } else if (ctx->current_state == CLIENT_STATE_IDLE && ctx->prewarm_active) {
+        // Pre-warmed links live long enough to miss pongs; no press to fail
+        failure_stats_record(&ctx->failures, ws_failure_cause(error),
+                             message ? message : "WebSocket error", get_current_time_ms());
+    }
+}
+
+/**
+ * @brief WebSocket redirect callback
+ * 
+ * Runs inside the WebSocket service call; the move waits for update so
+ * the status table and the running press see one consistent primary.
+ */
+static void on_ws_redirect(const char *host, int port, void *user_data) {
+    client_context_t *ctx = (client_context_t *)user_data;
+    
+    if (ctx == NULL || strlen(host) >= sizeof(ctx->redirect_host)) {
+        return;
+    }
+    
+    strcpy(ctx->redirect_host, host);
+    ctx->redirect_port = port;
+    ctx->redirect_pending = true;
+}
+
+/**
+ * @brief Release the links of a pre-warm no press used
+ */
+static void end_prewarm(client_context_t *ctx) {
+    ctx->prewarm_active = false;
+    ws_client_disconnect();
+    release_vpn(ctx);
+    ctx->state_enter_time = get_current_time_ms();  // Idle release counts from here
+}
+
+/**
+ * @brief Bring links up while a pre-warm runs, drop them when it expires
+ */
+static void handle_prewarm(client_context_t *ctx) {
+    if ((int32_t)(get_current_time_ms() - ctx->prewarm_until) >= 0) {
+        ctx->stats.prewarms_unused++;
+        end_prewarm(ctx);
         return;
     }
     
-    #ifndef TESTING
-    logger_info("WebSocket connected");
-    #endif
+    if (ctx->resources_released) {
+        restore_idle_resources(ctx);
+    }
     
-    // Transition to querying state if in connecting state
-    if (ctx->current_state == CLIENT_STATE_WS_CONNECTING) {
-        change_state(ctx, CLIENT_STATE_QUERYING_PS5);
+    #if CLIENT_FEATURE_VPN
+    vpn_state_t vpn_state = vpn_controller_get_state();
+    
+    if (vpn_state == VPN_STATE_DISCONNECTED || vpn_state == VPN_STATE_UNKNOWN ||
+        vpn_state == VPN_STATE_SUSPENDED) {
+        // Started once; a tunnel that went down again is left to the press
+        if (ctx->prewarm_vpn_started || vpn_controller_connect() < 0) {
+            end_prewarm(ctx);
+            return;
+        }
+        ctx->prewarm_vpn_started = true;
+    } else if (vpn_state == VPN_STATE_CONNECTED) {
+        if (ws_client_get_state() == WS_STATE_DISCONNECTED && ws_client_connect() < 0) {
+            end_prewarm(ctx);
+        }
+    } else if (vpn_state == VPN_STATE_ERROR) {
+        end_prewarm(ctx);
+    }
+    #else
+    if (ws_client_get_state() == WS_STATE_DISCONNECTED && ws_client_connect() < 0) {
+        end_prewarm(ctx);
     }
+    #endif
 }
 
 /**
- * @brief WebSocket disconnected callback
+ * @brief Make a server the primary and keep the status table in step
+ * 
+ * The link must be down. A fan-out server taking over hands its slot to
+ * the old primary.
  */
-static void on_ws_disconnected(const char *reason, void *user_data) {
+static int switch_primary(client_context_t *ctx, const char *host, int port) {
+    if (ctx->primary_entry.port == port && strcmp(ctx->primary_entry.host, host) == 0) {
+        return 0;
+    }
+    
+    fanout_entry_t previous = ctx->primary_entry;
+    if (ws_client_set_server(host, port) < 0) {
+        return -1;
+    }
+    
+    fanout_entry_t extra[FANOUT_MAX_SERVERS];
+    int count = server_fanout_get_results(extra, FANOUT_MAX_SERVERS);
+    for (int i = 0; i < count; i++) {
+        if (extra[i].port == port && strcmp(extra[i].host, host) == 0) {
+            if (server_fanout_set_server(i, previous.host, previous.port) < 0) {
+                ws_client_set_server(previous.host, previous.port);
+                return -1;
+            }
+            break;
+        }
+    }
+    
+    memset(&ctx->primary_entry, 0, sizeof(ctx->primary_entry));
+    strcpy(ctx->primary_entry.host, host);
+    ctx->primary_entry.port = port;
+    ctx->primary_entry.status = -1;
+    
     #ifndef TESTING
-    logger_warning("WebSocket disconnected: %s", reason ? reason : "unknown");
+    logger_info("Primary server %s:%d -> %s:%d", previous.host, previous.port, host, port);
     #endif
-    (void)user_data;  // Unused in current implementation
+    
+    return 0;
 }
 
 /**
- * @brief WebSocket error callback
+ * @brief Act on a redirect from the primary server
+ * 
+ * A press still waiting for the primary reconnects to the new server;
+ * one past its answer finishes first and the move waits for idle. A
+ * pre-warm gives up its links, the next press connects to the new server.
  */
-static void on_ws_error(ws_error_t error, const char *message, void *user_data) {
-    client_context_t *ctx = (client_context_t *)user_data;
+static void apply_pending_redirect(client_context_t *ctx) {
+    bool reconnect = false;
     
-    if (ctx == NULL) {
+    if (!ctx->redirect_pending) {
         return;
     }
     
-    #ifndef TESTING
-    logger_error("WebSocket error: %s - %s", 
-              ws_client_error_to_string(error), 
-              message ? message : "unknown");
-    #endif
+    switch (ctx->current_state) {
+        case CLIENT_STATE_IDLE:
+        case CLIENT_STATE_VPN_CONNECTING:
+        case CLIENT_STATE_VPN_CONNECTED:
+            break;
+        case CLIENT_STATE_WS_CONNECTING:
+            reconnect = true;
+            break;
+        case CLIENT_STATE_QUERYING_PS5:
+            if (ctx->primary_failed) {
+                return;  // Only fan-out servers are left to answer
+            }
+            reconnect = true;
+            break;
+        default:
+            return;
+    }
+    ctx->redirect_pending = false;
     
-    if (ctx->current_state == CLIENT_STATE_WS_CONNECTING ||
-        ctx->current_state == CLIENT_STATE_QUERYING_PS5) {
-        report_error(ctx, CLIENT_ERROR_WS_FAILED, "WebSocket error");
-        change_state(ctx, CLIENT_STATE_ERROR);
+    if (ctx->prewarm_active) {
+        end_prewarm(ctx);
+    } else {
+        ws_client_disconnect();
+    }
+    
+    if (switch_primary(ctx, ctx->redirect_host, ctx->redirect_port) < 0) {
+        #ifndef TESTING
+        logger_warning("Redirect to %s:%d not followed, server in use by the fan-out",
+                       ctx->redirect_host, ctx->redirect_port);
+        #endif
+    }
+    
+    // The connecting state starts the link once the hold-off is over
+    if (reconnect) {
+        ctx->query_sent = false;
+        change_state(ctx, CLIENT_STATE_WS_CONNECTING);
+        ctx->redirect_reconnect = true;
     }
 }
 
@@ -382,36 +1206,96 @@ static void on_ws_error(ws_error_t error, const char *message, void *user_data)
  * ============================================================ */
 
 static void handle_idle_state(client_context_t *ctx) {
-    // Just wait for button press
-    // Button callback will trigger state change
-    (void)ctx;  // Unused in current implementation
+    // Wait for button press, the button callback triggers the state change.
+    // Low-memory devices give back resources after a long idle.
+    if (ctx->prewarm_active) {
+        handle_prewarm(ctx);
+        return;
+    }
+    
+    if (ctx->config.idle_release_ms > 0 && !ctx->resources_released &&
+        get_current_time_ms() - ctx->state_enter_time >= ctx->config.idle_release_ms) {
+        release_idle_resources(ctx);
+    }
 }
 
+#if CLIENT_FEATURE_VPN
 static void handle_vpn_connecting_state(client_context_t *ctx) {
+    // Rebuild here, not in the press handler, which may run in a signal handler
+    if (ctx->resources_released) {
+        restore_idle_resources(ctx);
+    }
+    
     vpn_state_t vpn_state = vpn_controller_get_state();
     
+    // Kick off the connect (or resume of a suspended session); stage
+    // deadlines and retries are handled by the VPN controller, the state
+    // timeout below is only the outer bound
+    if (vpn_state == VPN_STATE_DISCONNECTED || vpn_state == VPN_STATE_UNKNOWN ||
+        vpn_state == VPN_STATE_SUSPENDED) {
+        if (vpn_controller_connect() < 0) {
+            report_error(ctx, CLIENT_ERROR_VPN_FAILED,
+                         vpn_failure_cause(vpn_controller_get_last_error()),
+                         "Failed to start VPN connection");
+            change_state(ctx, CLIENT_STATE_ERROR);
+        }
+        return;
+    }
+    
     if (vpn_state == VPN_STATE_CONNECTED) {
         change_state(ctx, CLIENT_STATE_VPN_CONNECTED);
         ctx->stats.vpn_connect_count++;
     } else if (vpn_state == VPN_STATE_ERROR) {
-        report_error(ctx, CLIENT_ERROR_VPN_FAILED, "VPN connection failed");
+        vpn_error_t error = vpn_controller_get_last_error();
+        char message[64];
+        snprintf(message, sizeof(message), "VPN connection failed: %s",
+                 vpn_controller_error_to_string(error));
+        report_error(ctx, CLIENT_ERROR_VPN_FAILED, vpn_failure_cause(error), message);
         change_state(ctx, CLIENT_STATE_ERROR);
     } else if (is_state_timeout(ctx)) {
-        report_error(ctx, CLIENT_ERROR_VPN_TIMEOUT, "VPN connection timeout");
-        change_state(ctx, CLIENT_STATE_ERROR);
+        vpn_connect_stage_t stage = vpn_controller_get_connect_stage();
+        char message[64];
+        snprintf(message, sizeof(message), "VPN connection timeout in %s",
+                 vpn_controller_stage_to_string(stage));
+        handle_phase_timeout(ctx, CLIENT_ERROR_VPN_TIMEOUT, vpn_timeout_cause(stage), message);
     }
 }
+#endif
 
 static void handle_vpn_connected_state(client_context_t *ctx) {
-    // Start WebSocket connection
-    if (ws_client_get_state() != WS_STATE_CONNECTED &&
-        ws_client_get_state() != WS_STATE_CONNECTING) {
-        
+    #if !CLIENT_FEATURE_VPN
+    // Presses start here without a tunnel phase
+    if (ctx->resources_released) {
+        restore_idle_resources(ctx);
+    }
+    #endif
+    
+    ws_state_t ws_state = ws_client_get_state();
+    
+    // Extra servers connect alongside the primary and each gets its query
+    // as soon as its own link is up, with its own deadline
+    server_fanout_connect_all();
+    if (!ctx->fanout_queried) {
+        uint32_t fanout_timeout = press_budget_remaining(&ctx->budget, get_current_time_ms());
+        if (fanout_timeout > FANOUT_QUERY_TIMEOUT_MS) {
+            fanout_timeout = FANOUT_QUERY_TIMEOUT_MS;
+        }
+        server_fanout_query_all(fanout_timeout);
+        ctx->fanout_queried = true;
+    }
+    
+    // Reuse a link kept across a restart
+    if (ws_state == WS_STATE_CONNECTED) {
+        change_state(ctx, CLIENT_STATE_QUERYING_PS5);
+    } else if (ws_state == WS_STATE_CONNECTING) {
+        change_state(ctx, CLIENT_STATE_WS_CONNECTING);
+    } else {
+        // Start WebSocket connection
         if (ws_client_connect() == 0) {
             change_state(ctx, CLIENT_STATE_WS_CONNECTING);
         } else {
-            report_error(ctx, CLIENT_ERROR_WS_FAILED, "Failed to start WebSocket connection");
-            change_state(ctx, CLIENT_STATE_ERROR);
+            fail_primary(ctx, CLIENT_ERROR_WS_FAILED, FAILURE_CAUSE_WS_ERROR,
+                         "Failed to start WebSocket connection");
         }
     }
 }
@@ -422,38 +1306,70 @@ static void handle_ws_connecting_state(client_context_t *ctx) {
     if (ws_state == WS_STATE_CONNECTED) {
         // Will be handled by callback
     } else if (ws_state == WS_STATE_ERROR) {
-        report_error(ctx, CLIENT_ERROR_WS_FAILED, "WebSocket connection failed");
-        change_state(ctx, CLIENT_STATE_ERROR);
+        fail_primary(ctx, CLIENT_ERROR_WS_FAILED, FAILURE_CAUSE_WS_ERROR,
+                     "WebSocket connection failed");
     } else if (is_state_timeout(ctx)) {
-        report_error(ctx, CLIENT_ERROR_WS_TIMEOUT, "WebSocket connection timeout");
-        change_state(ctx, CLIENT_STATE_ERROR);
+        if (fanout_pending(ctx)) {
+            fail_primary(ctx, CLIENT_ERROR_WS_TIMEOUT, FAILURE_CAUSE_WS_TIMEOUT,
+                         "WebSocket connection timeout");
+        } else {
+            handle_phase_timeout(ctx, CLIENT_ERROR_WS_TIMEOUT, FAILURE_CAUSE_WS_TIMEOUT,
+                                 "WebSocket connection timeout");
+        }
+    } else if (ws_state == WS_STATE_DISCONNECTED && ctx->redirect_reconnect) {
+        // Redirected: connect to the new server once its hold-off is over
+        ws_hint_state_t hint;
+        if (ws_client_get_hint_state(&hint) == 0 && hint.hold_remaining_ms == 0) {
+            ctx->redirect_reconnect = false;
+            if (ws_client_connect() < 0) {
+                fail_primary(ctx, CLIENT_ERROR_WS_FAILED, FAILURE_CAUSE_WS_ERROR,
+                             "Failed to start WebSocket connection");
+            }
+        }
     }
 }
 
 static void handle_querying_ps5_state(client_context_t *ctx) {
-    // Send PS5 query if not already sent
-    static bool query_sent = false;
+    // The primary is out, only extra servers can still answer
+    if (ctx->primary_failed) {
+        if (!fanout_pending(ctx)) {
+            report_error(ctx, ctx->primary_error, ctx->primary_cause, ctx->primary_detail);
+            change_state(ctx, CLIENT_STATE_ERROR);
+        } else if (is_state_timeout(ctx)) {
+            handle_phase_timeout(ctx, ctx->primary_error, ctx->primary_cause,
+                                 ctx->primary_detail);
+        }
+        return;
+    }
     
-    if (!query_sent) {
-        if (ws_client_send("{\"type\":\"query_ps5\"}") == 0) {
-            query_sent = true;
+    // Send PS5 query if not already sent
+    if (!ctx->query_sent) {
+        if (ws_client_query_ps5_status() == 0) {
+            ctx->query_sent = true;
+            ctx->primary_entry.result = FANOUT_RESULT_PENDING;
+            ctx->primary_query_time = get_current_time_ms();
+            
             #ifndef TESTING
             logger_info("PS5 query sent");
             #endif
         } else {
-            report_error(ctx, CLIENT_ERROR_PS5_FAILED, "Failed to send PS5 query");
-            change_state(ctx, CLIENT_STATE_ERROR);
-            query_sent = false;
+            fail_primary(ctx, CLIENT_ERROR_PS5_FAILED, FAILURE_CAUSE_QUERY_SEND,
+                         "Failed to send PS5 query");
             return;
         }
     }
     
     // Check for timeout
     if (is_state_timeout(ctx)) {
-        report_error(ctx, CLIENT_ERROR_PS5_TIMEOUT, "PS5 query timeout");
-        change_state(ctx, CLIENT_STATE_ERROR);
-        query_sent = false;
         ctx->stats.failed_queries++;
+        finish_primary_query(ctx, FANOUT_RESULT_TIMEOUT, -1);
+        if (ctx->query_parse_failed) {
+            handle_phase_timeout(ctx, CLIENT_ERROR_PS5_TIMEOUT, FAILURE_CAUSE_PARSE_ERROR,
+                                 "PS5 query answered without a status");
+        } else {
+            handle_phase_timeout(ctx, CLIENT_ERROR_PS5_TIMEOUT, FAILURE_CAUSE_QUERY_TIMEOUT,
+                                 "PS5 query timeout");
+        }
     }
     
     // Response will be handled by callback
@@ -475,56 +1391,58 @@ static void handle_led_update_state(client_context_t *ctx) {
 static void handle_waiting_state(client_context_t *ctx) {
     // Disconnect WebSocket
     ws_client_disconnect();
+    server_fanout_disconnect_all();
     
-    // Disconnect VPN
-    vpn_controller_disconnect();
+    // Suspend or disconnect VPN
+    release_vpn(ctx);
     
     // Return to idle
     change_state(ctx, CLIENT_STATE_CLEANUP);
 }
 
 static void handle_error_state(client_context_t *ctx) {
-    // Update LED to show error
-    update_led_for_state(ctx, CLIENT_STATE_ERROR);
-    
-    // Check if should retry
-    if (ctx->error_count < ctx->config.max_retry_attempts && ctx->config.auto_retry) {
-        // Wait a bit before retry
-        struct timespec sleep_time = {
-            .tv_sec = CLIENT_RETRY_INTERVAL_S,
-            .tv_nsec = 0
-        };
-        nanosleep(&sleep_time, NULL);
+    uint32_t now = get_current_time_ms();
+    bool retry = ctx->error_count < ctx->config.max_retry_attempts && ctx->config.auto_retry;
+    
+    // First pass: show the error and set the deadline, the loop keeps
+    // running so presses and stops are still picked up while we wait
+    if (!ctx->retry_armed) {
+        update_led_for_state(ctx, CLIENT_STATE_ERROR);
         
-        #ifndef TESTING
+        if (retry) {
+            ctx->retry_at = now + CLIENT_RETRY_INTERVAL_S * 1000;
+        } else {
+            // Max retries exceeded or auto retry disabled
+            report_error(ctx, CLIENT_ERROR_MAX_RETRIES, FAILURE_CAUSE_NONE,
+                         "Maximum retry attempts exceeded");
+            ctx->retry_at = now + CLIENT_ERROR_HOLD_S * 1000;
+        }
+        ctx->retry_armed = true;
+        return;
+    }
+    
+    if ((int32_t)(now - ctx->retry_at) < 0) {
+        return;
+    }
+    
+    #ifndef TESTING
+    if (retry) {
         logger_info("Retrying after error (attempt %d/%d)", 
                 ctx->error_count, ctx->config.max_retry_attempts);
-        #endif
-        
-        change_state(ctx, CLIENT_STATE_CLEANUP);
-    } else {
-        // Max retries exceeded or auto retry disabled
-        report_error(ctx, CLIENT_ERROR_MAX_RETRIES, "Maximum retry attempts exceeded");
-        
-        // Wait before cleanup
-        struct timespec sleep_time = {
-            .tv_sec = 5,
-            .tv_nsec = 0
-        };
-        nanosleep(&sleep_time, NULL);
-        
-        change_state(ctx, CLIENT_STATE_CLEANUP);
     }
+    #endif
+    
+    change_state(ctx, CLIENT_STATE_CLEANUP);
 }
 
 static void handle_cleanup_state(client_context_t *ctx) {
-    // Ensure everything is disconnected
+    // Ensure everything is disconnected (a suspended VPN session is kept)
     ws_client_disconnect();
-    vpn_controller_disconnect();
+    server_fanout_disconnect_all();
+    release_vpn(ctx);
     
     // Turn off LED
-    #ifndef TESTING
-    led_off();
+    #if CLIENT_USE_LED
     led_off();
     #endif
     
@@ -559,6 +1477,21 @@ client_context_t* client_sm_create(const client_config_t *config) {
     ctx->ps5_status = PS5_STATUS_UNKNOWN;
     ctx->initialized = false;
     
+    strncpy(ctx->primary_entry.host, config->ws_server_host, sizeof(ctx->primary_entry.host) - 1);
+    ctx->primary_entry.port = config->ws_server_port;
+    ctx->primary_entry.status = -1;
+    
+    // Phase caps are the legacy per-phase timeouts
+    press_budget_init(&ctx->budget, config->press_budget_ms);
+    press_budget_set_phase(&ctx->budget, PRESS_PHASE_VPN,
+                           CLIENT_VPN_CONNECT_TIMEOUT_S * 1000, 0);
+    press_budget_set_phase(&ctx->budget, PRESS_PHASE_WS,
+                           CLIENT_WS_CONNECT_TIMEOUT_S * 1000, PRESS_BUDGET_RESERVE_WS_MS);
+    press_budget_set_phase(&ctx->budget, PRESS_PHASE_QUERY,
+                           CLIENT_PS5_QUERY_TIMEOUT_S * 1000, PRESS_BUDGET_RESERVE_QUERY_MS);
+    
+    failure_stats_init(&ctx->failures);
+    
     return ctx;
 }
 
@@ -572,7 +1505,7 @@ int client_sm_init(client_context_t *ctx) {
     }
     
     // Initialize button handler
-    #ifndef TESTING
+    #if CLIENT_USE_BUTTON
     if (button_handler_init(ctx->config.button_pin, ctx->config.button_debounce_ms) < 0) {
         logger_error("Failed to initialize button handler");
         return -1;
@@ -581,26 +1514,50 @@ int client_sm_init(client_context_t *ctx) {
     #endif
     
     // Initialize VPN controller
+    #if CLIENT_FEATURE_VPN
     if (vpn_controller_init(ctx->config.vpn_socket_path) < 0) {
         #ifndef TESTING
         logger_error("Failed to initialize VPN controller");
+        #endif
+        #if CLIENT_USE_BUTTON
         button_handler_cleanup();
         #endif
         return -1;
     }
     vpn_controller_set_callback(on_vpn_state_change, ctx);
+    vpn_controller_set_progress_callback(on_vpn_progress, ctx);
+    
+    // Shared state is optional, older agents only speak the socket protocol
+    if (ctx->config.vpn_shm_name[0] != '\0') {
+        vpn_controller_attach_shm(ctx->config.vpn_shm_name);
+    }
+    #endif
     
     // Initialize WebSocket client
     if (ws_client_init(ctx->config.ws_server_host, ctx->config.ws_server_port) < 0) {
         #ifndef TESTING
         logger_error("Failed to initialize WebSocket client");
+        #endif
+        #if CLIENT_USE_BUTTON
         button_handler_cleanup();
         #endif
+        #if CLIENT_FEATURE_VPN
         vpn_controller_cleanup();
+        #endif
         return -1;
     }
     // 🔧 FIXED: Correct parameter order for ws_client_set_callbacks
     ws_client_set_callbacks(on_ws_connected, on_ws_disconnected, on_ws_message, on_ws_error, ctx);
+    ws_client_set_redirect_callback(on_ws_redirect, ctx);
+    
+    // Extra servers are optional, a bad list only loses the fan-out
+    if (server_fanout_init(parse_fanout_status, on_fanout_result, ctx) == 0 &&
+        ctx->config.fanout_servers[0] != '\0' &&
+        server_fanout_add_servers(ctx->config.fanout_servers) < 0) {
+        #ifndef TESTING
+        logger_warning("Invalid fan-out server list: %s", ctx->config.fanout_servers);
+        #endif
+    }
     
     ctx->initialized = true;
     ctx->current_state = CLIENT_STATE_IDLE;
@@ -641,26 +1598,25 @@ int client_sm_update(client_context_t *ctx) {
     }
     
     // Process sub-modules
-    #ifndef TESTING
+    #if CLIENT_USE_BUTTON
     button_handler_process();
     #endif
+    #if CLIENT_FEATURE_VPN
     vpn_controller_process(10);      // 🔧 FIXED: Added timeout parameter
+    #endif
     ws_client_service(10);           // 🔧 FIXED: Changed from ws_client_process to ws_client_service
+    server_fanout_process();
     
-    // Set timeout based on state
-    switch (ctx->current_state) {
-        case CLIENT_STATE_VPN_CONNECTING:
-            ctx->current_timeout = CLIENT_VPN_CONNECT_TIMEOUT_S * 1000;
-            break;
-        case CLIENT_STATE_WS_CONNECTING:
-            ctx->current_timeout = CLIENT_WS_CONNECT_TIMEOUT_S * 1000;
-            break;
-        case CLIENT_STATE_QUERYING_PS5:
-            ctx->current_timeout = CLIENT_PS5_QUERY_TIMEOUT_S * 1000;
-            break;
-        default:
-            ctx->current_timeout = 0;
-            break;
+    // Presses, long presses and stops that arrived since the last pass
+    apply_pending_cancel(ctx);
+    apply_pending_redirect(ctx);
+    
+    // Set timeout based on state: the phase allowance from the press
+    // budget (0 means no timeout, so a spent budget expires on the next pass)
+    if (phase_for_state(ctx->current_state) >= 0) {
+        ctx->current_timeout = (ctx->phase_timeout > 0) ? ctx->phase_timeout : 1;
+    } else {
+        ctx->current_timeout = 0;
     }
     
     // Update LED for current state
@@ -674,7 +1630,9 @@ int client_sm_update(client_context_t *ctx) {
             handle_idle_state(ctx);
             break;
         case CLIENT_STATE_VPN_CONNECTING:
+            #if CLIENT_FEATURE_VPN
             handle_vpn_connecting_state(ctx);
+            #endif
             break;
         case CLIENT_STATE_VPN_CONNECTED:
             handle_vpn_connected_state(ctx);
@@ -702,6 +1660,48 @@ int client_sm_update(client_context_t *ctx) {
     return 0;  // 🔧 FIXED: Return int instead of void
 }
 
+int client_sm_run(client_context_t *ctx) {
+    if (ctx == NULL || !ctx->initialized) {
+        return -1;
+    }
+    
+    struct timespec interval = {
+        .tv_sec = 0,
+        .tv_nsec = 10 * 1000 * 1000
+    };
+    
+    ctx->stop_requested = 0;
+    while (!ctx->stop_requested) {
+        client_sm_update(ctx);
+        nanosleep(&interval, NULL);
+    }
+    
+    // Release whatever the stop interrupted
+    apply_pending_cancel(ctx);
+    return 0;
+}
+
+void client_sm_stop(client_context_t *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    
+    ctx->stop_requested = 1;
+    client_sm_cancel(ctx, CLIENT_CANCEL_SHUTDOWN);
+}
+
+int client_sm_cancel(client_context_t *ctx, client_cancel_t reason) {
+    if (ctx == NULL || reason <= CLIENT_CANCEL_NONE || reason > CLIENT_CANCEL_SHUTDOWN) {
+        return -1;
+    }
+    
+    // Keep the stronger request if one is already pending
+    if ((int)reason > (int)ctx->pending_cancel) {
+        ctx->pending_cancel = reason;
+    }
+    return 0;
+}
+
 client_state_t client_sm_get_state(const client_context_t *ctx) {  // 🔧 FIXED: Added const
     if (ctx == NULL) {
         return CLIENT_STATE_IDLE;
@@ -724,6 +1724,40 @@ int client_sm_get_stats(const client_context_t *ctx, client_stats_t *stats) {  /
     return 0;
 }
 
+int client_sm_get_budget_stats(const client_context_t *ctx, press_budget_stats_t *stats) {
+    if (ctx == NULL || stats == NULL) {
+        return -1;
+    }
+    memcpy(stats, &ctx->budget.stats, sizeof(press_budget_stats_t));
+    return 0;
+}
+
+int client_sm_get_idle_stats(const client_context_t *ctx, client_idle_stats_t *stats) {
+    if (ctx == NULL || stats == NULL) {
+        return -1;
+    }
+    memcpy(stats, &ctx->idle_stats, sizeof(client_idle_stats_t));
+    return 0;
+}
+
+int client_sm_get_failure_stats(const client_context_t *ctx, failure_stats_t *stats) {
+    if (ctx == NULL || stats == NULL) {
+        return -1;
+    }
+    memcpy(stats, &ctx->failures, sizeof(failure_stats_t));
+    return 0;
+}
+
+int client_sm_get_status_table(const client_context_t *ctx, fanout_entry_t *entries,
+                               int max_entries) {
+    if (ctx == NULL || entries == NULL || max_entries <= 0) {
+        return -1;
+    }
+    
+    entries[0] = ctx->primary_entry;
+    return 1 + server_fanout_get_results(entries + 1, max_entries - 1);
+}
+
 void client_sm_cleanup(client_context_t *ctx) {
     if (ctx == NULL) {
         return;
@@ -733,11 +1767,21 @@ void client_sm_cleanup(client_context_t *ctx) {
         return;
     }
     
+    // Cancel the in-flight workflow before its modules go away
+    client_sm_cancel(ctx, CLIENT_CANCEL_SHUTDOWN);
+    apply_pending_cancel(ctx);
+    if (ctx->prewarm_active) {
+        end_prewarm(ctx);
+    }
+    
     // Cleanup all modules
-    #ifndef TESTING
+    #if CLIENT_USE_BUTTON
     button_handler_cleanup();
     #endif
+    #if CLIENT_FEATURE_VPN
     vpn_controller_cleanup();
+    #endif
+    server_fanout_cleanup();
     ws_client_cleanup();
     
     ctx->initialized = false;
@@ -756,6 +1800,49 @@ void client_sm_destroy(client_context_t *ctx) {
     free(ctx);
 }
 
+int client_sm_prewarm(client_context_t *ctx, uint32_t hold_ms) {
+    if (ctx == NULL || !ctx->initialized || hold_ms == 0) {
+        return -1;
+    }
+    
+    if (ctx->current_state != CLIENT_STATE_IDLE) {
+        return -1;  // A press is already using the links
+    }
+    
+    uint32_t until = get_current_time_ms() + hold_ms;
+    if (ctx->prewarm_active) {
+        if ((int32_t)(until - ctx->prewarm_until) > 0) {
+            ctx->prewarm_until = until;
+        }
+        return 0;
+    }
+    
+    ctx->prewarm_active = true;
+    ctx->prewarm_vpn_started = false;
+    ctx->prewarm_until = until;
+    ctx->stats.prewarms++;
+    
+    #ifndef TESTING
+    logger_info("Pre-warming links for a likely press (%u s)", hold_ms / 1000);
+    #endif
+    
+    return 0;
+}
+
+int client_sm_set_primary_server(client_context_t *ctx, const char *host, int port) {
+    if (ctx == NULL || !ctx->initialized || host == NULL ||
+        strlen(host) >= sizeof(ctx->primary_entry.host)) {
+        return -1;
+    }
+    
+    if (ctx->current_state != CLIENT_STATE_IDLE || ctx->prewarm_active ||
+        ctx->pending_cancel != CLIENT_CANCEL_NONE) {
+        return -1;  // Links in use, or about to be
+    }
+    
+    return switch_primary(ctx, host, port);
+}
+
 int client_sm_trigger_button(client_context_t *ctx, bool long_press) {
     if (ctx == NULL) {
         #ifndef TESTING
@@ -771,34 +1858,18 @@ int client_sm_trigger_button(client_context_t *ctx, bool long_press) {
         return -1;
     }
     
-    // Only trigger if in idle state
-    if (ctx->current_state != CLIENT_STATE_IDLE) {
-        #ifndef TESTING
-        logger_warning("Cannot trigger button: not in idle state (current: %s)", 
-                   client_state_to_string(ctx->current_state));
-        #endif
-        return -1;
-    }
-    
-    #ifndef TESTING
+    // Only record the request, this may run in a signal handler; the
+    // next update starts or restarts the workflow
     if (long_press) {
-        logger_info("Manual button trigger: long press");
-    } else {
-        logger_info("Manual button trigger: short press");
+        // A long press cancels a running workflow, nothing to do in idle
+        if (ctx->current_state == CLIENT_STATE_IDLE) {
+            return 0;
+        }
+        return client_sm_cancel(ctx, CLIENT_CANCEL_LONG_PRESS);
     }
-    #endif
     
-    // Simulate button press event
-    if (long_press) {
-        // Long press - currently not implemented in the workflow
-        // Could be used for future features
-        return 0;
-    } else {
-        // Short press - trigger VPN connection
-        ctx->stats.button_press_count++;
-        change_state(ctx, CLIENT_STATE_VPN_CONNECTING);
-        return 0;
-    }
+    ctx->stats.button_press_count++;
+    return client_sm_cancel(ctx, CLIENT_CANCEL_NEW_PRESS);
 }
 
 const char* client_state_to_string(client_state_t state) {
@@ -826,10 +1897,22 @@ const char* client_error_to_string(client_error_t error) {
         case CLIENT_ERROR_PS5_TIMEOUT:    return "PS5_TIMEOUT";
         case CLIENT_ERROR_PS5_FAILED:     return "PS5_FAILED";
         case CLIENT_ERROR_MAX_RETRIES:    return "MAX_RETRIES";
+        case CLIENT_ERROR_BUDGET_EXCEEDED: return "BUDGET_EXCEEDED";
         default:                          return "UNKNOWN_ERROR";
     }
 }
 
+const char* client_cancel_to_string(client_cancel_t reason) {
+    switch (reason) {
+        case CLIENT_CANCEL_NONE:          return "NONE";
+        case CLIENT_CANCEL_NEW_PRESS:     return "NEW_PRESS";
+        case CLIENT_CANCEL_LONG_PRESS:    return "LONG_PRESS";
+        case CLIENT_CANCEL_CONFIG_CHANGE: return "CONFIG_CHANGE";
+        case CLIENT_CANCEL_SHUTDOWN:      return "SHUTDOWN";
+        default:                          return "UNKNOWN";
+    }
+}
+
 const char* ps5_status_to_string(ps5_status_t status) {
     switch (status) {
         case PS5_STATUS_UNKNOWN:  return "UNKNOWN";
@@ -839,3 +1922,12 @@ const char* ps5_status_to_string(ps5_status_t status) {
         default:                  return "INVALID";
     }
 }
+
+#ifdef TESTING
+void client_sm_test_age_state(client_context_t *ctx, uint32_t ms) {
+    if (ctx != NULL) {
+        ctx->state_enter_time -= ms;
+        ctx->retry_at -= ms;
+    }
+}
+#endif
@@ -18,6 +18,11 @@
 #include <stdbool.h>
 #include <time.h>
 
+#include "client_features.h"
+#include "press_budget.h"
+#include "server_fanout.h"
+#include "failure_stats.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -50,6 +55,12 @@ extern "C" {
 /** Retry interval in seconds */
 #define CLIENT_RETRY_INTERVAL_S         5
 
+/** Error display time once retries are exhausted, in seconds */
+#define CLIENT_ERROR_HOLD_S             5
+
+/** Oldest PS5 status used as a fallback when a press runs out of budget */
+#define CLIENT_STATUS_CACHE_MAX_AGE_S   600
+
 /* ============================================================
  *  Type Definitions
  * ============================================================ */
@@ -69,6 +80,13 @@ typedef enum {
     CLIENT_STATE_CLEANUP,           /**< Cleaning up resources */
 } client_state_t;
 
+/** State every press (or restart) enters first; VPN-less builds skip the tunnel phase */
+#if CLIENT_FEATURE_VPN
+#define CLIENT_STATE_PRESS_START    CLIENT_STATE_VPN_CONNECTING
+#else
+#define CLIENT_STATE_PRESS_START    CLIENT_STATE_VPN_CONNECTED
+#endif
+
 /**
  * @brief PS5 status from server
  */
@@ -91,8 +109,23 @@ typedef enum {
     CLIENT_ERROR_PS5_TIMEOUT,       /**< PS5 query timeout */
     CLIENT_ERROR_PS5_FAILED,        /**< PS5 query failed */
     CLIENT_ERROR_MAX_RETRIES,       /**< Maximum retries exceeded */
+    CLIENT_ERROR_BUDGET_EXCEEDED,   /**< Press ran out of its time budget */
 } client_error_t;
 
+/**
+ * @brief Workflow cancellation reasons
+ * 
+ * Listed from weakest to strongest; a stronger pending request is not
+ * replaced by a weaker one.
+ */
+typedef enum {
+    CLIENT_CANCEL_NONE = 0,         /**< Nothing pending */
+    CLIENT_CANCEL_NEW_PRESS,        /**< Short press while busy, restart the workflow */
+    CLIENT_CANCEL_LONG_PRESS,       /**< Long press, abort the workflow */
+    CLIENT_CANCEL_CONFIG_CHANGE,    /**< Configuration changed, abort and drop all links */
+    CLIENT_CANCEL_SHUTDOWN,         /**< Client is stopping */
+} client_cancel_t;
+
 /**
  * @brief Client statistics
  */
@@ -104,8 +137,31 @@ typedef struct {
     uint32_t vpn_success_count;     /**< Successful VPN connections */
     uint32_t error_count;           /**< Total errors */
     time_t last_query_time;         /**< Last successful query timestamp */
+    uint32_t restarted_workflows;   /**< Workflows restarted by a new press */
+    uint32_t cancelled_workflows;   /**< Workflows aborted before completion */
+    uint32_t prewarms;              /**< Links brought up ahead of a likely press */
+    uint32_t prewarm_hits;          /**< Presses that found a pre-warm running */
+    uint32_t prewarms_unused;       /**< Pre-warms torn down without a press */
 } client_stats_t;
 
+/**
+ * @brief Idle release statistics
+ * 
+ * Memory given back while idle and what it costs the next press.
+ */
+typedef struct {
+    uint32_t releases;              /**< Idle releases performed */
+    uint32_t restores;              /**< Rebuilds on a press after a release */
+    uint32_t last_saved_kb;         /**< Resident memory freed by the last release */
+    uint32_t max_saved_kb;          /**< Most resident memory freed by a release */
+    uint32_t last_restore_ms;       /**< Time spent rebuilding on the last cold press */
+    uint32_t max_restore_ms;        /**< Longest rebuild */
+    uint32_t cold_connects;         /**< Presses that started released and reached the server */
+    uint32_t cold_connect_ms_total; /**< Sum of press-to-server times of cold presses */
+    uint32_t warm_connects;         /**< Presses that started with resources held */
+    uint32_t warm_connect_ms_total; /**< Sum of press-to-server times of warm presses */
+} client_idle_stats_t;
+
 /**
  * @brief Client context structure
  * 
@@ -143,10 +199,23 @@ typedef struct {
     int button_pin;                 /**< GPIO pin for button */
     int button_debounce_ms;         /**< Button debounce time */
     char vpn_socket_path[256];      /**< VPN agent socket path */
+    char vpn_shm_name[64];          /**< VPN agent shared state region (empty = socket only) */
     char ws_server_host[256];       /**< WebSocket server host */
     int ws_server_port;             /**< WebSocket server port */
     bool auto_retry;                /**< Enable automatic retry on error */
     int max_retry_attempts;         /**< Maximum retry attempts */
+    uint32_t vpn_linger_ms;         /**< Keep VPN session for resume after a press (0 = full disconnect) */
+    bool ws_weighted_scheduling;    /**< Serve WS send classes by weighted round robin, not strictly */
+    bool ws_batching;               /**< Offer batch envelopes to the server */
+    uint32_t press_budget_ms;       /**< Button-to-LED budget per press (0 = phase timeouts only) */
+    char fanout_servers[256];       /**< Extra servers queried on each press, "host:port" separated by spaces */
+    char control_socket_path[108];  /**< Local control socket (empty = disabled) */
+    char lan_status_bind[64];       /**< LAN status endpoint address (empty = all) */
+    int lan_status_port;            /**< LAN status endpoint port (0 = disabled) */
+    uint32_t idle_release_ms;       /**< Release VPN agent link and WS context after this long idle (0 = keep) */
+    char usage_profile_path[128];   /**< Learned usage histogram (empty = no learning) */
+    uint32_t prewarm_lead_ms;       /**< Bring links up this long before likely use (0 = never) */
+    char path_cache_path[128];      /**< Best server per network (empty = no caching) */
 } client_config_t;
 
 /* ============================================================
@@ -223,16 +292,63 @@ int client_sm_run(client_context_t *ctx);
 /**
  * @brief Stop state machine
  * 
- * Signal the state machine to stop and return to idle.
+ * Signal the state machine to stop and return to idle. Makes
+ * client_sm_run() return and cancels the in-flight workflow.
+ * Safe to call from a signal handler.
  * 
  * @param ctx Client context
  */
 void client_sm_stop(client_context_t *ctx);
 
+/**
+ * @brief Cancel the in-flight workflow
+ * 
+ * Only records the request, so it is safe to call from a signal handler.
+ * The next client_sm_update() (or client_sm_cleanup()) acts on it at once
+ * instead of waiting out phase timeouts. A restart keeps the VPN and
+ * WebSocket links that are connected or still coming up; an abort drops
+ * the WebSocket and releases the VPN.
+ * 
+ * @param ctx Client context
+ * @param reason Why the workflow is cancelled
+ * @return 0 on success, negative error code on failure
+ */
+int client_sm_cancel(client_context_t *ctx, client_cancel_t reason);
+
+/**
+ * @brief Bring up VPN and WebSocket ahead of a likely press
+ * 
+ * Only starts from idle. A press within hold_ms finds the links up;
+ * otherwise they are released as after a press. Calling again while a
+ * pre-warm runs extends it.
+ * 
+ * @param ctx Client context
+ * @param hold_ms How long to keep the links without a press
+ * @return 0 on success, negative if not idle or on invalid arguments
+ */
+int client_sm_prewarm(client_context_t *ctx, uint32_t hold_ms);
+
+/**
+ * @brief Make another server the primary one
+ * 
+ * Only while idle and not pre-warming, so no link is in use. When the
+ * server is one of the fan-out servers, the two trade places and every
+ * server is still queried once.
+ * 
+ * @param ctx Client context
+ * @param host Server hostname or IP address
+ * @param port Server port number
+ * @return 0 on success, negative if links are in use or on invalid arguments
+ */
+int client_sm_set_primary_server(client_context_t *ctx, const char *host, int port);
+
 /**
  * @brief Trigger button press event
  * 
  * Manually trigger a button press (for testing or external control).
+ * Only records the press, so it is safe from a signal handler; the next
+ * client_sm_update() starts the workflow from idle. Outside idle, a short
+ * press restarts the workflow and a long press cancels it.
  * 
  * @param ctx Client context
  * @param long_press true for long press, false for short press
@@ -285,6 +401,55 @@ client_error_t client_sm_get_last_error(const client_context_t *ctx);
  */
 int client_sm_get_stats(const client_context_t *ctx, client_stats_t *stats);
 
+/**
+ * @brief Get press budget statistics
+ * 
+ * Retrieve per-phase overruns and durations of the press budget.
+ * 
+ * @param ctx Client context
+ * @param stats Pointer to stats structure to fill
+ * @return 0 on success, negative error code on failure
+ */
+int client_sm_get_budget_stats(const client_context_t *ctx, press_budget_stats_t *stats);
+
+/**
+ * @brief Get idle release statistics
+ * 
+ * Compare cold_connect_ms_total / cold_connects against the warm
+ * average to see the latency cost of idle_release_ms.
+ * 
+ * @param ctx Client context
+ * @param stats Pointer to stats structure to fill
+ * @return 0 on success, negative error code on failure
+ */
+int client_sm_get_idle_stats(const client_context_t *ctx, client_idle_stats_t *stats);
+
+/**
+ * @brief Get press failures by cause
+ * 
+ * Rank with failure_stats_rank() to see which cause costs the most time.
+ * 
+ * @param ctx Client context
+ * @param stats Pointer to stats structure to fill
+ * @return 0 on success, negative error code on failure
+ */
+int client_sm_get_failure_stats(const client_context_t *ctx, failure_stats_t *stats);
+
+/**
+ * @brief Get the status table of the last press
+ * 
+ * The primary server comes first, followed by the fan-out servers in
+ * configuration order. Entries still pending are filled in as replies
+ * arrive.
+ * 
+ * @param ctx Client context
+ * @param entries Output array
+ * @param max_entries Capacity of entries
+ * @return Number of entries written, or negative on invalid arguments
+ */
+int client_sm_get_status_table(const client_context_t *ctx, fanout_entry_t *entries,
+                               int max_entries);
+
 /**
  * @brief Reset statistics
  * 
@@ -336,6 +501,26 @@ const char* ps5_status_to_string(ps5_status_t status);
  */
 const char* client_error_to_string(client_error_t error);
 
+/**
+ * @brief Get cancellation reason string
+ * 
+ * @param reason Cancellation reason
+ * @return Reason description string
+ */
+const char* client_cancel_to_string(client_cancel_t reason);
+
+#ifdef TESTING
+/**
+ * @brief Move the start of the running state back (test builds only)
+ * 
+ * The error state's retry deadline moves back with it.
+ * 
+ * @param ctx Client context
+ * @param ms Milliseconds the state should appear to have run for already
+ */
+void client_sm_test_age_state(client_context_t *ctx, uint32_t ms);
+#endif
+
 /** @} */ // end of ClientStateMachine group
 
 #ifdef __cplusplus
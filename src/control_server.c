@@ -0,0 +1,506 @@
+/**
+ * @file control_server.c
+ * @brief Control Server Implementation
+ *
+ * Published values are kept once per topic with a sequence number. Each
+ * subscriber remembers the last sequence it was sent per topic, so an
+ * update a subscriber could not take yet is simply replaced by the next
+ * one instead of being queued. Writes never block: a client whose output
+ * makes no progress for the stall timeout is disconnected.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "control_server.h"
+
+#ifndef TESTING
+  #ifdef OPENWRT_BUILD
+    #include <gaming/logger.h>
+  #else
+    #include "../../gaming-core/src/logger.h"
+  #endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+/**
+ * @brief One connected control client
+ */
+typedef struct {
+    int fd;                             /**< Socket, -1 if slot is free */
+    bool subscribed;                    /**< Sent "watch" */
+
+    char inbuf[CONTROL_COMMAND_MAX];    /**< Partial command line */
+    size_t inbuf_len;
+
+    char outbuf[CONTROL_OUTBUF_SIZE];   /**< Bytes not yet written */
+    size_t outbuf_len;
+    uint32_t stall_start;               /**< When output stopped draining, 0 if flowing */
+
+    uint32_t sent_seq[CONTROL_TOPIC_COUNT];
+} control_client_t;
+
+/**
+ * @brief Latest value of a topic
+ */
+typedef struct {
+    char data[CONTROL_EVENT_MAX];
+    uint32_t seq;                       /**< 0 until first publish */
+} control_topic_value_t;
+
+/**
+ * @brief Control server context
+ */
+typedef struct {
+    bool initialized;
+    int listen_fd;
+    char socket_path[108];
+    uint32_t stall_timeout_ms;
+
+    control_snapshot_fn snapshot;
+    void *user_data;
+    control_press_fn press;
+    void *press_user_data;
+
+    control_topic_value_t topics[CONTROL_TOPIC_COUNT];
+    control_client_t clients[CONTROL_MAX_CLIENTS];
+
+    control_stats_t stats;
+} control_ctx_t;
+
+/* ============================================================
+ *  Global Variables
+ * ============================================================ */
+
+static control_ctx_t g_control_ctx = {
+    .initialized = false,
+    .listen_fd = -1,
+};
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Get current time in milliseconds
+ */
+static uint32_t get_current_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void close_client(control_client_t *client) {
+    if (client->fd < 0) {
+        return;
+    }
+
+    close(client->fd);
+    if (client->subscribed) {
+        g_control_ctx.stats.subscribers--;
+    }
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+}
+
+/**
+ * @brief Append a line to a client's output buffer
+ *
+ * @return 0 on success, -1 if it does not fit
+ */
+static int queue_line(control_client_t *client, const char *line, int length) {
+    if (length < 0 || client->outbuf_len + (size_t)length > sizeof(client->outbuf)) {
+        return -1;
+    }
+
+    memcpy(client->outbuf + client->outbuf_len, line, (size_t)length);
+    client->outbuf_len += (size_t)length;
+    return 0;
+}
+
+/**
+ * @brief Queue the newest value of every topic the subscriber has not seen
+ *
+ * A topic that does not fit stays unsent and is retried on the next pass,
+ * by which time it may have been replaced again.
+ */
+static void queue_events(control_client_t *client) {
+    char line[CONTROL_EVENT_MAX + 96];
+
+    for (int i = 0; i < CONTROL_TOPIC_COUNT; i++) {
+        const control_topic_value_t *topic = &g_control_ctx.topics[i];
+
+        if (topic->seq == client->sent_seq[i]) {
+            continue;
+        }
+
+        int len = snprintf(line, sizeof(line),
+                           "{\"type\":\"event\",\"topic\":\"%s\",\"seq\":%u,\"data\":%s}\n",
+                           control_topic_to_string((control_topic_t)i), topic->seq, topic->data);
+        if (len >= (int)sizeof(line) || queue_line(client, line, len) != 0) {
+            continue;
+        }
+
+        if (client->sent_seq[i] != 0) {
+            g_control_ctx.stats.events_coalesced += topic->seq - client->sent_seq[i] - 1;
+        }
+        client->sent_seq[i] = topic->seq;
+        g_control_ctx.stats.events_sent++;
+    }
+}
+
+/**
+ * @brief Write as much output as the socket takes
+ *
+ * @return 0 to keep the client, -1 to drop it
+ */
+static int flush_client(control_client_t *client) {
+    size_t written = 0;
+
+    while (written < client->outbuf_len) {
+        ssize_t n = send(client->fd, client->outbuf + written,
+                         client->outbuf_len - written, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            written += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        return -1;
+    }
+
+    if (written > 0) {
+        memmove(client->outbuf, client->outbuf + written, client->outbuf_len - written);
+        client->outbuf_len -= written;
+        client->stall_start = 0;
+    }
+
+    if (client->outbuf_len == 0) {
+        return 0;
+    }
+
+    uint32_t now = get_current_time_ms();
+    if (client->stall_start == 0) {
+        client->stall_start = now;
+    } else if (now - client->stall_start >= g_control_ctx.stall_timeout_ms) {
+        g_control_ctx.stats.slow_drops++;
+        #ifndef TESTING
+        logger_warning("Control client not reading for %u ms, dropping",
+                       now - client->stall_start);
+        #endif
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Run one command line
+ *
+ * @return 0 to keep the client, -1 to drop it
+ */
+static int run_command(control_client_t *client, const char *command) {
+    char line[CONTROL_EVENT_MAX + 32];
+    int len;
+
+    if (strcmp(command, "watch") == 0) {
+        if (!client->subscribed) {
+            client->subscribed = true;
+            g_control_ctx.stats.subscribers++;
+        }
+        // Start from the current value of every topic
+        memset(client->sent_seq, 0, sizeof(client->sent_seq));
+        return 0;
+    }
+
+    if (strcmp(command, "unwatch") == 0) {
+        if (client->subscribed) {
+            client->subscribed = false;
+            g_control_ctx.stats.subscribers--;
+        }
+        return 0;
+    }
+
+    if (strcmp(command, "ping") == 0) {
+        len = snprintf(line, sizeof(line), "{\"type\":\"pong\"}\n");
+    } else if (strcmp(command, "press") == 0 && g_control_ctx.press != NULL) {
+        bool accepted = g_control_ctx.press(g_control_ctx.press_user_data) == 0;
+        len = snprintf(line, sizeof(line), "{\"type\":\"press\",\"accepted\":%s}\n",
+                       accepted ? "true" : "false");
+    } else if (strcmp(command, "status") == 0 && g_control_ctx.snapshot != NULL) {
+        char data[CONTROL_EVENT_MAX];
+        int data_len = g_control_ctx.snapshot(data, sizeof(data), g_control_ctx.user_data);
+        if (data_len < 0 || data_len >= (int)sizeof(data)) {
+            len = snprintf(line, sizeof(line),
+                           "{\"type\":\"error\",\"message\":\"status unavailable\"}\n");
+        } else {
+            len = snprintf(line, sizeof(line), "{\"type\":\"status\",\"data\":%s}\n", data);
+        }
+    } else {
+        len = snprintf(line, sizeof(line),
+                       "{\"type\":\"error\",\"message\":\"unknown command\"}\n");
+    }
+
+    // A client that does not read its own replies is as stuck as a slow subscriber
+    return queue_line(client, line, len);
+}
+
+/**
+ * @brief Read and run complete command lines
+ *
+ * @return 0 to keep the client, -1 to drop it
+ */
+static int read_commands(control_client_t *client) {
+    for (;;) {
+        size_t space = sizeof(client->inbuf) - client->inbuf_len;
+        if (space == 0) {
+            return -1;  // Command line too long
+        }
+
+        ssize_t n = recv(client->fd, client->inbuf + client->inbuf_len, space, MSG_DONTWAIT);
+        if (n == 0) {
+            return -1;  // Peer closed
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        client->inbuf_len += (size_t)n;
+
+        char *newline;
+        while ((newline = memchr(client->inbuf, '\n', client->inbuf_len)) != NULL) {
+            size_t line_len = (size_t)(newline - client->inbuf);
+
+            *newline = '\0';
+            if (line_len > 0 && client->inbuf[line_len - 1] == '\r') {
+                client->inbuf[line_len - 1] = '\0';
+            }
+            if (client->inbuf[0] != '\0' && run_command(client, client->inbuf) != 0) {
+                return -1;
+            }
+
+            client->inbuf_len -= line_len + 1;
+            memmove(client->inbuf, newline + 1, client->inbuf_len);
+        }
+    }
+}
+
+static void accept_clients(void) {
+    for (;;) {
+        int fd = accept(g_control_ctx.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            return;
+        }
+
+        control_client_t *slot = NULL;
+        for (int i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+            if (g_control_ctx.clients[i].fd < 0) {
+                slot = &g_control_ctx.clients[i];
+                break;
+            }
+        }
+
+        if (slot == NULL || set_nonblocking(fd) != 0) {
+            g_control_ctx.stats.clients_rejected++;
+            close(fd);
+            continue;
+        }
+
+        memset(slot, 0, sizeof(*slot));
+        slot->fd = fd;
+        g_control_ctx.stats.clients_accepted++;
+    }
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+int control_server_init(const char *socket_path, control_snapshot_fn snapshot,
+                        void *user_data) {
+    if (g_control_ctx.initialized) {
+        #ifndef TESTING
+        logger_warning("Control server already initialized");
+        #endif
+        return -1;
+    }
+
+    if (socket_path == NULL) {
+        socket_path = CONTROL_DEFAULT_SOCKET_PATH;
+    }
+    if (socket_path[0] == '\0' || strlen(socket_path) >= sizeof(g_control_ctx.socket_path)) {
+        return -1;
+    }
+
+    memset(&g_control_ctx, 0, sizeof(g_control_ctx));
+    strncpy(g_control_ctx.socket_path, socket_path, sizeof(g_control_ctx.socket_path) - 1);
+    g_control_ctx.stall_timeout_ms = CONTROL_STALL_TIMEOUT_MS;
+    g_control_ctx.snapshot = snapshot;
+    g_control_ctx.user_data = user_data;
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+        g_control_ctx.clients[i].fd = -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        g_control_ctx.listen_fd = -1;
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    unlink(socket_path);  // Stale socket from a previous run
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        chmod(socket_path, CONTROL_SOCKET_MODE) != 0 ||  // Before anyone can connect
+        listen(fd, CONTROL_MAX_CLIENTS) != 0 ||
+        set_nonblocking(fd) != 0) {
+        #ifndef TESTING
+        logger_error("Failed to listen on control socket %s: %s", socket_path, strerror(errno));
+        #endif
+        close(fd);
+        g_control_ctx.listen_fd = -1;
+        return -1;
+    }
+
+    g_control_ctx.listen_fd = fd;
+    g_control_ctx.initialized = true;
+
+    #ifndef TESTING
+    logger_info("Control server listening on %s", socket_path);
+    #endif
+
+    return 0;
+}
+
+void control_server_set_stall_timeout(uint32_t timeout_ms) {
+    g_control_ctx.stall_timeout_ms = timeout_ms;
+}
+
+void control_server_set_press_handler(control_press_fn press, void *user_data) {
+    g_control_ctx.press = press;
+    g_control_ctx.press_user_data = user_data;
+}
+
+int control_server_publish(control_topic_t topic, const char *json) {
+    if (!g_control_ctx.initialized || topic < 0 || topic >= CONTROL_TOPIC_COUNT ||
+        json == NULL) {
+        return -1;
+    }
+
+    control_topic_value_t *value = &g_control_ctx.topics[topic];
+    size_t len = strlen(json);
+    if (len >= sizeof(value->data)) {
+        return -1;
+    }
+
+    memcpy(value->data, json, len + 1);
+    value->seq++;
+    if (value->seq == 0) {
+        value->seq = 1;  // 0 means "never sent"
+    }
+    g_control_ctx.stats.events_published++;
+
+    return 0;
+}
+
+void control_server_process(void) {
+    if (!g_control_ctx.initialized) {
+        return;
+    }
+
+    accept_clients();
+
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+        control_client_t *client = &g_control_ctx.clients[i];
+
+        if (client->fd < 0) {
+            continue;
+        }
+
+        if (read_commands(client) != 0) {
+            close_client(client);
+            continue;
+        }
+
+        if (client->subscribed) {
+            queue_events(client);
+        }
+
+        if (flush_client(client) != 0) {
+            close_client(client);
+        }
+    }
+}
+
+int control_server_get_subscriber_count(void) {
+    return (int)g_control_ctx.stats.subscribers;
+}
+
+int control_server_get_stats(control_stats_t *stats) {
+    if (stats == NULL) {
+        return -1;
+    }
+
+    *stats = g_control_ctx.stats;
+    return 0;
+}
+
+void control_server_cleanup(void) {
+    if (!g_control_ctx.initialized) {
+        return;
+    }
+
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+        close_client(&g_control_ctx.clients[i]);
+    }
+
+    close(g_control_ctx.listen_fd);
+    unlink(g_control_ctx.socket_path);
+
+    memset(&g_control_ctx, 0, sizeof(g_control_ctx));
+    g_control_ctx.listen_fd = -1;
+}
+
+const char* control_topic_to_string(control_topic_t topic) {
+    switch (topic) {
+        case CONTROL_TOPIC_STATE:       return "state";
+        case CONTROL_TOPIC_PS5:         return "ps5";
+        case CONTROL_TOPIC_METRICS:     return "metrics";
+        case CONTROL_TOPIC_FAILURES:    return "failures";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,212 @@
+/**
+ * @file control_server.h
+ * @brief Control Server - local control socket with event subscriptions
+ *
+ * This module serves a Unix socket for local tools (LuCI page, fleet
+ * agent). Clients send one command per line and read one JSON object per
+ * line back. A "watch" client becomes a subscriber and is pushed state
+ * transitions, PS5 status changes and metric deltas as they happen.
+ * Features include:
+ * - Non-blocking accept, read and write from the main loop
+ * - Latest-value topics: updates are coalesced per subscriber
+ * - Bounded output buffer per client
+ * - Subscribers that stop reading are dropped, never waited on
+ *
+ * Protocol (newline terminated):
+ * - "status"  -> {"type":"status","data":{...}}
+ * - "watch"   -> {"type":"event","topic":"...","seq":N,"data":{...}} per update
+ * - "unwatch" -> stop events
+ * - "press"   -> {"type":"press","accepted":true|false}
+ * - "ping"    -> {"type":"pong"}
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup ControlServer Control Server
+ * @brief Local control socket and event stream
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Default control socket path */
+#define CONTROL_DEFAULT_SOCKET_PATH     "/var/run/gaming-client.sock"
+
+/** Control socket permissions, owner only */
+#define CONTROL_SOCKET_MODE             0600
+
+/** Maximum simultaneous control clients */
+#define CONTROL_MAX_CLIENTS             8
+
+/** Maximum length of one event payload (JSON object) */
+#define CONTROL_EVENT_MAX               512
+
+/** Output buffer per client */
+#define CONTROL_OUTBUF_SIZE             2048
+
+/** Longest accepted command line */
+#define CONTROL_COMMAND_MAX             64
+
+/** Default time a subscriber may block its output before it is dropped */
+#define CONTROL_STALL_TIMEOUT_MS        5000
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Event topics
+ *
+ * Each topic holds only its latest value; a subscriber that falls behind
+ * skips straight to it.
+ */
+typedef enum {
+    CONTROL_TOPIC_STATE = 0,        /**< State machine transitions */
+    CONTROL_TOPIC_PS5,              /**< PS5 status changes */
+    CONTROL_TOPIC_METRICS,          /**< Periodic metric deltas */
+    CONTROL_TOPIC_FAILURES,         /**< Failures by cause and time to recover */
+    CONTROL_TOPIC_COUNT
+} control_topic_t;
+
+/**
+ * @brief Status snapshot writer for the "status" command
+ *
+ * @param buffer Output buffer for a JSON object
+ * @param size Buffer size
+ * @param user_data User-provided data pointer
+ * @return Length written, negative on failure
+ */
+typedef int (*control_snapshot_fn)(char *buffer, size_t size, void *user_data);
+
+/**
+ * @brief Button press handler for the "press" command
+ *
+ * @param user_data User-provided data pointer
+ * @return 0 if the press was accepted, negative otherwise
+ */
+typedef int (*control_press_fn)(void *user_data);
+
+/**
+ * @brief Control server statistics
+ */
+typedef struct {
+    uint32_t clients_accepted;      /**< Connections accepted */
+    uint32_t clients_rejected;      /**< Connections refused, all slots in use */
+    uint32_t subscribers;           /**< Current subscribers */
+    uint32_t events_published;      /**< Updates published across all topics */
+    uint32_t events_sent;           /**< Event lines queued to subscribers */
+    uint32_t events_coalesced;      /**< Updates a subscriber skipped */
+    uint32_t slow_drops;            /**< Clients dropped for not reading */
+} control_stats_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize control server
+ *
+ * Create and listen on the control socket, replacing a stale one. The
+ * socket is owner-only (CONTROL_SOCKET_MODE) since "press" drives the
+ * console.
+ *
+ * @param socket_path Socket path (NULL for default)
+ * @param snapshot Status snapshot writer (NULL to answer "status" with an error)
+ * @param user_data User data passed to snapshot
+ * @return 0 on success, -1 on failure
+ */
+int control_server_init(const char *socket_path, control_snapshot_fn snapshot,
+                        void *user_data);
+
+/**
+ * @brief Set how long a client may block its output
+ *
+ * @param timeout_ms Stall timeout in milliseconds
+ */
+void control_server_set_stall_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief Let clients press the button
+ *
+ * Call after control_server_init(). Without a handler "press" is an
+ * unknown command.
+ *
+ * @param press Press handler (NULL to disable)
+ * @param user_data User data passed to press
+ */
+void control_server_set_press_handler(control_press_fn press, void *user_data);
+
+/**
+ * @brief Publish the latest value of a topic
+ *
+ * Only records the value; subscribers are written in
+ * control_server_process(). Cheap enough for state callbacks. Call from
+ * the main loop only, never from a signal handler.
+ *
+ * @param topic Topic
+ * @param json Event payload, a JSON object
+ * @return 0 on success, -1 on failure
+ */
+int control_server_publish(control_topic_t topic, const char *json);
+
+/**
+ * @brief Serve control clients
+ *
+ * Accept connections, run commands and flush pending events without
+ * blocking. Call from the main loop.
+ */
+void control_server_process(void);
+
+/**
+ * @brief Get number of subscribers
+ *
+ * @return Clients that sent "watch"
+ */
+int control_server_get_subscriber_count(void);
+
+/**
+ * @brief Get control server statistics
+ *
+ * @param stats Output statistics
+ * @return 0 on success, -1 on failure
+ */
+int control_server_get_stats(control_stats_t *stats);
+
+/**
+ * @brief Clean up control server
+ *
+ * Close all clients and remove the socket.
+ */
+void control_server_cleanup(void);
+
+/**
+ * @brief Get topic string
+ *
+ * @param topic Topic
+ * @return Topic name
+ */
+const char* control_topic_to_string(control_topic_t topic);
+
+/** @} */ // end of ControlServer group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTROL_SERVER_H */
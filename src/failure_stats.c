@@ -0,0 +1,219 @@
+/**
+ * @file failure_stats.c
+ * @brief Failure Statistics Implementation
+ *
+ * Pure bookkeeping on caller-supplied millisecond timestamps; the state
+ * machine owns the clock and decides what counts as a failure.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#include "failure_stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Upper bounds of the time-to-recover buckets
+ */
+static const uint32_t g_bucket_limits_ms[FAILURE_TTR_BUCKETS] = {
+    1000, 2000, 5000, 10000, 30000, 60000, 300000, UINT32_MAX
+};
+
+static bool is_valid_cause(failure_cause_t cause) {
+    return cause > FAILURE_CAUSE_NONE && cause < FAILURE_CAUSE_COUNT;
+}
+
+/**
+ * @brief Check if cause a ranks before cause b
+ */
+static bool ranks_before(const failure_stats_t *stats, failure_cause_t a, failure_cause_t b) {
+    const failure_cause_stats_t *sa = &stats->causes[a];
+    const failure_cause_stats_t *sb = &stats->causes[b];
+
+    if (sa->ttr_total_ms != sb->ttr_total_ms) {
+        return sa->ttr_total_ms > sb->ttr_total_ms;
+    }
+    return sa->count > sb->count;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void failure_stats_init(failure_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+}
+
+void failure_stats_record(failure_stats_t *stats, failure_cause_t cause,
+                          const char *detail, uint32_t now_ms) {
+    if (stats == NULL || !is_valid_cause(cause)) {
+        return;
+    }
+
+    stats->causes[cause].count++;
+
+    failure_record_t *record = &stats->log[stats->log_count % FAILURE_LOG_SIZE];
+    record->cause = cause;
+    record->time_ms = now_ms;
+    record->detail[0] = '\0';
+    if (detail != NULL) {
+        strncpy(record->detail, detail, sizeof(record->detail) - 1);
+        record->detail[sizeof(record->detail) - 1] = '\0';
+    }
+    stats->log_count++;
+
+    // Later failures of the same outage are symptoms of the first
+    if (!stats->outage_open) {
+        stats->outage_open = true;
+        stats->outage_cause = cause;
+        stats->outage_start_ms = now_ms;
+        stats->causes[cause].outages++;
+    }
+}
+
+uint32_t failure_stats_recovered(failure_stats_t *stats, uint32_t now_ms) {
+    if (stats == NULL || !stats->outage_open) {
+        return 0;
+    }
+
+    uint32_t elapsed = now_ms - stats->outage_start_ms;
+    failure_cause_stats_t *cause = &stats->causes[stats->outage_cause];
+
+    cause->recovered++;
+    cause->ttr_total_ms += elapsed;
+    if (elapsed > cause->ttr_max_ms) {
+        cause->ttr_max_ms = elapsed;
+    }
+
+    int bucket = 0;
+    while (bucket < FAILURE_TTR_BUCKETS - 1 && elapsed >= g_bucket_limits_ms[bucket]) {
+        bucket++;
+    }
+    cause->ttr_histogram[bucket]++;
+
+    stats->outage_open = false;
+    return elapsed;
+}
+
+int failure_stats_get_recent(const failure_stats_t *stats, failure_record_t *records,
+                             int max_records) {
+    if (stats == NULL || records == NULL || max_records <= 0) {
+        return 0;
+    }
+
+    int available = stats->log_count < FAILURE_LOG_SIZE ? (int)stats->log_count
+                                                        : FAILURE_LOG_SIZE;
+    int count = available < max_records ? available : max_records;
+
+    for (int i = 0; i < count; i++) {
+        records[i] = stats->log[(stats->log_count - 1 - (uint32_t)i) % FAILURE_LOG_SIZE];
+    }
+
+    return count;
+}
+
+int failure_stats_rank(const failure_stats_t *stats, failure_cause_t *causes, int max_causes) {
+    failure_cause_t sorted[FAILURE_CAUSE_COUNT];
+    int count = 0;
+
+    if (stats == NULL || causes == NULL || max_causes <= 0) {
+        return 0;
+    }
+
+    // Insertion sort, there are only a handful of causes
+    for (int c = FAILURE_CAUSE_NONE + 1; c < FAILURE_CAUSE_COUNT; c++) {
+        if (stats->causes[c].count == 0) {
+            continue;
+        }
+
+        int pos = count++;
+        while (pos > 0 && ranks_before(stats, (failure_cause_t)c, sorted[pos - 1])) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = (failure_cause_t)c;
+    }
+
+    if (count > max_causes) {
+        count = max_causes;
+    }
+    memcpy(causes, sorted, (size_t)count * sizeof(failure_cause_t));
+    return count;
+}
+
+int failure_stats_to_json(const failure_stats_t *stats, char *buffer, size_t size) {
+    failure_cause_t ranked[FAILURE_CAUSE_COUNT];
+    char member[160];
+
+    if (stats == NULL || buffer == NULL || size < 3) {
+        return -1;
+    }
+
+    int count = failure_stats_rank(stats, ranked, FAILURE_CAUSE_COUNT);
+    size_t len = 1;
+    buffer[0] = '{';
+
+    for (int i = 0; i < count; i++) {
+        const failure_cause_stats_t *cs = &stats->causes[ranked[i]];
+        int n = snprintf(member, sizeof(member), "%s\"%s\":[%u,%u,%u,%u,[",
+                         len > 1 ? "," : "", failure_cause_to_string(ranked[i]),
+                         cs->count, cs->recovered, cs->ttr_total_ms, cs->ttr_max_ms);
+        for (int b = 0; b < FAILURE_TTR_BUCKETS; b++) {
+            n += snprintf(member + n, sizeof(member) - (size_t)n, "%s%u",
+                          b > 0 ? "," : "", cs->ttr_histogram[b]);
+        }
+        n += snprintf(member + n, sizeof(member) - (size_t)n, "]]");
+
+        // Keep room for the closing brace
+        if (len + (size_t)n + 2 > size) {
+            break;
+        }
+        memcpy(buffer + len, member, (size_t)n);
+        len += (size_t)n;
+    }
+
+    buffer[len++] = '}';
+    buffer[len] = '\0';
+    return (int)len;
+}
+
+uint32_t failure_stats_bucket_limit_ms(int bucket) {
+    if (bucket < 0 || bucket >= FAILURE_TTR_BUCKETS) {
+        return 0;
+    }
+    return g_bucket_limits_ms[bucket];
+}
+
+const char* failure_cause_to_string(failure_cause_t cause) {
+    switch (cause) {
+        case FAILURE_CAUSE_NONE:                    return "none";
+        case FAILURE_CAUSE_AGENT_UNREACHABLE:       return "agent_unreachable";
+        case FAILURE_CAUSE_AGENT_PROTOCOL:          return "agent_protocol";
+        case FAILURE_CAUSE_VPN_REJECTED:            return "vpn_rejected";
+        case FAILURE_CAUSE_VPN_DNS:                 return "vpn_dns";
+        case FAILURE_CAUSE_VPN_HANDSHAKE_TIMEOUT:   return "vpn_handshake_timeout";
+        case FAILURE_CAUSE_VPN_TIMEOUT:             return "vpn_timeout";
+        case FAILURE_CAUSE_WS_DNS:                  return "ws_dns";
+        case FAILURE_CAUSE_WS_REFUSED:              return "ws_refused";
+        case FAILURE_CAUSE_WS_HANDSHAKE:            return "ws_handshake";
+        case FAILURE_CAUSE_WS_TIMEOUT:              return "ws_timeout";
+        case FAILURE_CAUSE_WS_PONG_TIMEOUT:         return "ws_pong_timeout";
+        case FAILURE_CAUSE_WS_ERROR:                return "ws_error";
+        case FAILURE_CAUSE_QUERY_SEND:              return "query_send";
+        case FAILURE_CAUSE_PARSE_ERROR:             return "parse_error";
+        case FAILURE_CAUSE_QUERY_TIMEOUT:           return "query_timeout";
+        case FAILURE_CAUSE_BUDGET:                  return "budget";
+        default:                                    return "unknown";
+    }
+}
@@ -0,0 +1,207 @@
+/**
+ * @file failure_stats.h
+ * @brief Failure Statistics - press failures by cause and time to recover
+ *
+ * A press that fails opens an outage, attributed to the cause of its
+ * first failure. The next press that gets a PS5 status closes it; the
+ * time in between is what the failure cost the user.
+ * Features include:
+ * - Fine-grained causes from the VPN agent, the WebSocket and the query
+ * - Per-cause counts and time-to-recover histograms
+ * - Ring of recent failure records with the lower layer's detail
+ * - JSON export ranked by time lost
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef FAILURE_STATS_H
+#define FAILURE_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup FailureStats Failure Statistics
+ * @brief Failure taxonomy and time-to-recover metrics
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Time-to-recover histogram buckets (see failure_stats_bucket_limit_ms) */
+#define FAILURE_TTR_BUCKETS             8
+
+/** Recent failure records kept */
+#define FAILURE_LOG_SIZE                16
+
+/** Longest detail kept per record */
+#define FAILURE_DETAIL_MAX              48
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Failure causes
+ */
+typedef enum {
+    FAILURE_CAUSE_NONE = 0,             /**< Not a failure of its own */
+    FAILURE_CAUSE_AGENT_UNREACHABLE,    /**< VPN agent socket not reachable */
+    FAILURE_CAUSE_AGENT_PROTOCOL,       /**< VPN agent sent something unexpected */
+    FAILURE_CAUSE_VPN_REJECTED,         /**< VPN agent reported the connect failed */
+    FAILURE_CAUSE_VPN_DNS,              /**< VPN server name did not resolve in time */
+    FAILURE_CAUSE_VPN_HANDSHAKE_TIMEOUT,/**< VPN tunnel handshake timed out */
+    FAILURE_CAUSE_VPN_TIMEOUT,          /**< VPN connect timed out in another stage */
+    FAILURE_CAUSE_WS_DNS,               /**< Gaming-server name did not resolve */
+    FAILURE_CAUSE_WS_REFUSED,           /**< Gaming-server refused the TCP connection */
+    FAILURE_CAUSE_WS_HANDSHAKE,         /**< TLS or WebSocket upgrade failed */
+    FAILURE_CAUSE_WS_TIMEOUT,           /**< WebSocket connect or handshake timed out */
+    FAILURE_CAUSE_WS_PONG_TIMEOUT,      /**< Server stopped answering pings */
+    FAILURE_CAUSE_WS_ERROR,             /**< Other WebSocket failure */
+    FAILURE_CAUSE_QUERY_SEND,           /**< PS5 query could not be sent */
+    FAILURE_CAUSE_PARSE_ERROR,          /**< Replies arrived but none had a status */
+    FAILURE_CAUSE_QUERY_TIMEOUT,        /**< No reply to the PS5 query */
+    FAILURE_CAUSE_BUDGET,               /**< Press ran out of its time budget */
+    FAILURE_CAUSE_COUNT
+} failure_cause_t;
+
+/**
+ * @brief One recorded failure
+ */
+typedef struct {
+    failure_cause_t cause;              /**< What failed */
+    uint32_t time_ms;                   /**< When, in the caller's clock */
+    char detail[FAILURE_DETAIL_MAX];    /**< Detail from the failing layer */
+} failure_record_t;
+
+/**
+ * @brief Statistics of one cause
+ */
+typedef struct {
+    uint32_t count;                             /**< Failures recorded */
+    uint32_t outages;                           /**< Outages this cause started */
+    uint32_t recovered;                         /**< Of those, outages that ended */
+    uint32_t ttr_total_ms;                      /**< Time lost to recovered outages */
+    uint32_t ttr_max_ms;                        /**< Longest recovered outage */
+    uint32_t ttr_histogram[FAILURE_TTR_BUCKETS];/**< Recovered outages by duration */
+} failure_cause_stats_t;
+
+/**
+ * @brief Failure statistics
+ */
+typedef struct {
+    failure_cause_stats_t causes[FAILURE_CAUSE_COUNT];
+
+    failure_record_t log[FAILURE_LOG_SIZE];     /**< Ring of recent records */
+    uint32_t log_count;                         /**< Records ever written */
+
+    bool outage_open;                           /**< Failed and not yet recovered */
+    failure_cause_t outage_cause;               /**< First cause of the open outage */
+    uint32_t outage_start_ms;                   /**< Start of the open outage */
+} failure_stats_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize failure statistics
+ *
+ * @param stats Statistics to initialize
+ */
+void failure_stats_init(failure_stats_t *stats);
+
+/**
+ * @brief Record a failure
+ *
+ * Opens an outage if none is open.
+ *
+ * @param stats Statistics
+ * @param cause Failure cause
+ * @param detail Detail from the failing layer (may be NULL)
+ * @param now_ms Current time in milliseconds
+ */
+void failure_stats_record(failure_stats_t *stats, failure_cause_t cause,
+                          const char *detail, uint32_t now_ms);
+
+/**
+ * @brief Record a success
+ *
+ * Closes the open outage and accounts its time to its first cause.
+ *
+ * @param stats Statistics
+ * @param now_ms Current time in milliseconds
+ * @return Outage duration in milliseconds, 0 if none was open
+ */
+uint32_t failure_stats_recovered(failure_stats_t *stats, uint32_t now_ms);
+
+/**
+ * @brief Get recent failure records
+ *
+ * @param stats Statistics
+ * @param records Output array, newest first
+ * @param max_records Capacity of records
+ * @return Number of records written
+ */
+int failure_stats_get_recent(const failure_stats_t *stats, failure_record_t *records,
+                             int max_records);
+
+/**
+ * @brief Rank causes by time lost
+ *
+ * Causes with at least one failure, most time lost first; count breaks
+ * ties.
+ *
+ * @param stats Statistics
+ * @param causes Output array
+ * @param max_causes Capacity of causes
+ * @return Number of causes written
+ */
+int failure_stats_rank(const failure_stats_t *stats, failure_cause_t *causes, int max_causes);
+
+/**
+ * @brief Export statistics as JSON
+ *
+ * One member per cause in rank order:
+ * "cause":[count,recovered,ttr_total_ms,ttr_max_ms,[histogram]].
+ * Causes that do not fit are left out, so the costliest are kept.
+ *
+ * @param stats Statistics
+ * @param buffer Output buffer
+ * @param size Buffer size
+ * @return Length written, negative if not even "{}" fits
+ */
+int failure_stats_to_json(const failure_stats_t *stats, char *buffer, size_t size);
+
+/**
+ * @brief Get upper bound of a histogram bucket
+ *
+ * @param bucket Bucket index
+ * @return Exclusive upper bound in milliseconds (UINT32_MAX for the last)
+ */
+uint32_t failure_stats_bucket_limit_ms(int bucket);
+
+/**
+ * @brief Get cause string
+ *
+ * @param cause Failure cause
+ * @return Cause name
+ */
+const char* failure_cause_to_string(failure_cause_t cause);
+
+/** @} */ // end of FailureStats group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAILURE_STATS_H */
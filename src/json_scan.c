@@ -0,0 +1,618 @@
+/**
+ * @file json_scan.c
+ * @brief JSON Scanner Implementation
+ * 
+ * Structural characters and non-ASCII bytes are located 16 bytes at a
+ * time with NEON or SSE2 compares, falling back to table lookups on
+ * other targets. Key lookup walks the structural positions as they are
+ * produced, so no index has to be stored for large payloads.
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#include "json_scan.h"
+
+#include <string.h>
+#include <limits.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define JSON_SCAN_NEON 1
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+  #define JSON_SCAN_SSE2 1
+#endif
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+/** Bytes handled per block compare */
+#define BLOCK_SIZE 16
+
+/**
+ * @brief Key lookup walker state
+ */
+typedef struct {
+    const char *data;
+    const char *key;
+    size_t key_length;
+    bool top_level;             // Only match keys of the outermost object
+    int depth;                  // Open objects and arrays
+    
+    bool in_string;
+    size_t string_start;
+    size_t skip_pos;            // Escaped character to ignore (SIZE_MAX if none)
+    
+    bool key_matched;           // Last closed string equals key
+    size_t key_end;             // Closing quote of matched key
+    bool awaiting_value;        // Colon seen after matched key
+    size_t colon_pos;
+    bool in_value;              // Current string is the value
+    char value_open;            // '"' for string values, '[' for arrays, ':' for numbers
+    
+    const char *value;
+    size_t value_length;
+    bool found;
+} key_walker_t;
+
+/**
+ * @brief Array element walker state
+ */
+typedef struct {
+    const char *data;
+    bool in_string;
+    size_t skip_pos;
+    int depth;                  // Nesting below the array itself
+    size_t element_start;
+    int count;
+    bool done;
+    
+    json_scan_element_fn fn;
+    void *user_data;
+} array_walker_t;
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Lookup table of structural characters
+ */
+static bool is_structural(uint8_t c) {
+    switch (c) {
+        case '{': case '}': case '[': case ']':
+        case ':': case ',': case '"': case '\\':
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_json_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool only_space_between(const char *data, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+        if (!is_json_space(data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(JSON_SCAN_NEON)
+/**
+ * @brief Collapse a NEON compare result into a 16-bit mask
+ */
+static inline uint32_t neon_movemask(uint8x16_t v) {
+    static const uint8_t bit_values[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+    uint8x16_t bits = vandq_u8(v, vld1q_u8(bit_values));
+    #if defined(__aarch64__)
+    uint32_t lo = vaddv_u8(vget_low_u8(bits));
+    uint32_t hi = vaddv_u8(vget_high_u8(bits));
+    #else
+    uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    uint32_t lo = vget_lane_u8(sum, 0);
+    uint32_t hi = vget_lane_u8(sum, 1);
+    #endif
+    return lo | (hi << 8);
+}
+#endif
+
+/**
+ * @brief Bitmask of structural characters in a 16-byte block
+ */
+static inline uint32_t structural_mask(const uint8_t *block) {
+#if defined(JSON_SCAN_NEON)
+    uint8x16_t v = vld1q_u8(block);
+    // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+    uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+    uint8x16_t m = vceqq_u8(folded, vdupq_n_u8('{'));
+    m = vorrq_u8(m, vceqq_u8(folded, vdupq_n_u8('}')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(':')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(',')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('"')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\\')));
+    return neon_movemask(m);
+#elif defined(JSON_SCAN_SSE2)
+    __m128i v = _mm_loadu_si128((const __m128i *)block);
+    // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+    __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i m = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    return (uint32_t)_mm_movemask_epi8(m);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        if (is_structural(block[i])) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief Check if a 16-byte block is pure ASCII
+ */
+static inline bool block_is_ascii(const uint8_t *block) {
+#if defined(JSON_SCAN_NEON)
+    uint8x16_t v = vld1q_u8(block);
+    #if defined(__aarch64__)
+    return vmaxvq_u8(v) < 0x80;
+    #else
+    return neon_movemask(vcgeq_u8(v, vdupq_n_u8(0x80))) == 0;
+    #endif
+#elif defined(JSON_SCAN_SSE2)
+    __m128i v = _mm_loadu_si128((const __m128i *)block);
+    return _mm_movemask_epi8(v) == 0;
+#else
+    uint8_t acc = 0;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        acc |= block[i];
+    }
+    return acc < 0x80;
+#endif
+}
+
+/**
+ * @brief Length of the UTF-8 sequence at s, 0 if invalid
+ */
+static size_t utf8_sequence_length(const uint8_t *s, size_t remaining) {
+    uint8_t c = s[0];
+    
+    if (c < 0x80) {
+        return 1;
+    }
+    
+    size_t need;
+    uint8_t lo = 0x80, hi = 0xBF;
+    
+    if (c < 0xC2) {
+        return 0;                               // Continuation or overlong
+    } else if (c < 0xE0) {
+        need = 2;
+    } else if (c < 0xF0) {
+        need = 3;
+        if (c == 0xE0) lo = 0xA0;               // Overlong
+        if (c == 0xED) hi = 0x9F;               // Surrogates
+    } else if (c < 0xF5) {
+        need = 4;
+        if (c == 0xF0) lo = 0x90;               // Overlong
+        if (c == 0xF4) hi = 0x8F;               // Above U+10FFFF
+    } else {
+        return 0;
+    }
+    
+    if (remaining < need || s[1] < lo || s[1] > hi) {
+        return 0;
+    }
+    for (size_t i = 2; i < need; i++) {
+        if (s[i] < 0x80 || s[i] > 0xBF) {
+            return 0;
+        }
+    }
+    
+    return need;
+}
+
+/**
+ * @brief Feed one structural position to the key walker
+ */
+static void walker_feed(key_walker_t *w, size_t pos) {
+    const char c = w->data[pos];
+    
+    if (pos == w->skip_pos) {
+        return;  // Escaped character
+    }
+    
+    if (w->in_string) {
+        if (c == '\\') {
+            w->skip_pos = pos + 1;
+        } else if (c == '"') {
+            w->in_string = false;
+            if (w->in_value) {
+                w->value = w->data + w->string_start + 1;
+                w->value_length = pos - w->string_start - 1;
+                w->found = true;
+                return;
+            }
+            w->key_matched = (!w->top_level || w->depth == 1) &&
+                             (pos - w->string_start - 1 == w->key_length) &&
+                             memcmp(w->data + w->string_start + 1, w->key, w->key_length) == 0;
+            w->key_end = pos;
+        }
+        return;
+    }
+    
+    if (c == '[' && w->value_open == '[' && w->awaiting_value &&
+        only_space_between(w->data, w->colon_pos + 1, pos)) {
+        w->value = w->data + pos;
+        w->found = true;
+    } else if (c == '"') {
+        w->in_string = true;
+        w->string_start = pos;
+        w->in_value = w->value_open == '"' && w->awaiting_value &&
+                      only_space_between(w->data, w->colon_pos + 1, pos);
+        w->awaiting_value = false;
+        w->key_matched = false;
+    } else if (c == ':' && w->key_matched &&
+               only_space_between(w->data, w->key_end + 1, pos)) {
+        if (w->value_open == ':') {
+            // Numbers hold no structurals; the caller parses from here
+            w->value = w->data + pos + 1;
+            w->found = true;
+            return;
+        }
+        w->awaiting_value = true;
+        w->colon_pos = pos;
+        w->key_matched = false;
+    } else {
+        if (c == '{' || c == '[') {
+            w->depth++;
+        } else if (c == '}' || c == ']') {
+            w->depth--;
+        }
+        w->key_matched = false;
+        w->awaiting_value = false;
+    }
+}
+
+/**
+ * @brief Report one array element, trimmed of whitespace
+ */
+static void array_emit(array_walker_t *w, size_t start, size_t end) {
+    while (start < end && is_json_space(w->data[start])) {
+        start++;
+    }
+    while (end > start && is_json_space(w->data[end - 1])) {
+        end--;
+    }
+    if (end > start) {
+        w->fn(w->data + start, end - start, w->user_data);
+        w->count++;
+    }
+}
+
+/**
+ * @brief Feed one structural position to the array walker
+ */
+static void array_walker_feed(array_walker_t *w, size_t pos) {
+    const char c = w->data[pos];
+    
+    if (pos == w->skip_pos) {
+        return;  // Escaped character
+    }
+    
+    if (w->in_string) {
+        if (c == '\\') {
+            w->skip_pos = pos + 1;
+        } else if (c == '"') {
+            w->in_string = false;
+        }
+        return;
+    }
+    
+    switch (c) {
+        case '"':
+            w->in_string = true;
+            break;
+        case '{':
+        case '[':
+            w->depth++;
+            break;
+        case '}':
+            w->depth--;
+            break;
+        case ']':
+            if (w->depth == 0) {
+                array_emit(w, w->element_start, pos);
+                w->done = true;
+            } else {
+                w->depth--;
+            }
+            break;
+        case ',':
+            if (w->depth == 0) {
+                array_emit(w, w->element_start, pos);
+                w->element_start = pos + 1;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Locate the value of key, stopping at its opening character
+ */
+static bool find_value(key_walker_t *w, const char *data, size_t length,
+                       const char *key, char value_open, bool top_level) {
+    memset(w, 0, sizeof(*w));
+    w->data = data;
+    w->key = key;
+    w->key_length = strlen(key);
+    w->top_level = top_level;
+    w->skip_pos = (size_t)-1;
+    w->value_open = value_open;
+    
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t i = 0;
+    
+    for (; i + BLOCK_SIZE <= length && !w->found; i += BLOCK_SIZE) {
+        uint32_t mask = structural_mask(bytes + i);
+        while (mask != 0 && !w->found) {
+            walker_feed(w, i + (size_t)__builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    
+    for (; i < length && !w->found; i++) {
+        if (is_structural(bytes[i])) {
+            walker_feed(w, i);
+        }
+    }
+    
+    return w->found;
+}
+
+/**
+ * @brief Find a string value by key, optionally in the outermost object only
+ */
+static int lookup_string(const char *data, size_t length, const char *key, bool top_level,
+                         const char **value, size_t *value_length) {
+    if (data == NULL || key == NULL || value == NULL || value_length == NULL) {
+        return -1;
+    }
+    
+    key_walker_t w;
+    if (!find_value(&w, data, length, key, '"', top_level)) {
+        return -1;
+    }
+    
+    *value = w.value;
+    *value_length = w.value_length;
+    return 0;
+}
+
+/**
+ * @brief Find an integer value by key, optionally in the outermost object only
+ */
+static int lookup_int(const char *data, size_t length, const char *key, bool top_level,
+                      long *value) {
+    if (data == NULL || key == NULL || value == NULL) {
+        return -1;
+    }
+    
+    key_walker_t w;
+    if (!find_value(&w, data, length, key, ':', top_level)) {
+        return -1;
+    }
+    
+    const char *p = w.value;
+    const char *end = data + length;
+    bool negative = false;
+    long result = 0;
+    
+    while (p < end && is_json_space(*p)) {
+        p++;
+    }
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+        return -1;  // Not a number (string, object, literal)
+    }
+    
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (result > (LONG_MAX - (*p - '0')) / 10) {
+            return -1;
+        }
+        result = result * 10 + (*p - '0');
+    }
+    
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) {
+        return -1;  // Fractions and exponents are not integers
+    }
+    
+    *value = negative ? -result : result;
+    return 0;
+}
+
+/**
+ * @brief Split an array value by key, optionally in the outermost object only
+ */
+static int split_array(const char *data, size_t length, const char *key, bool top_level,
+                       json_scan_element_fn fn, void *user_data) {
+    if (data == NULL || key == NULL || fn == NULL) {
+        return -1;
+    }
+    
+    key_walker_t kw;
+    if (!find_value(&kw, data, length, key, '[', top_level)) {
+        return -1;
+    }
+    
+    array_walker_t w;
+    memset(&w, 0, sizeof(w));
+    w.data = data;
+    w.skip_pos = (size_t)-1;
+    w.element_start = (size_t)(kw.value - data) + 1;
+    w.fn = fn;
+    w.user_data = user_data;
+    
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t i = w.element_start;
+    
+    for (; i + BLOCK_SIZE <= length && !w.done; i += BLOCK_SIZE) {
+        uint32_t mask = structural_mask(bytes + i);
+        while (mask != 0 && !w.done) {
+            array_walker_feed(&w, i + (size_t)__builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    
+    for (; i < length && !w.done; i++) {
+        if (is_structural(bytes[i])) {
+            array_walker_feed(&w, i);
+        }
+    }
+    
+    return w.done ? w.count : -1;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+size_t json_scan_structurals(const char *data, size_t length,
+                             uint32_t *positions, size_t max_positions) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t count = 0;
+    size_t i = 0;
+    
+    for (; i + BLOCK_SIZE <= length; i += BLOCK_SIZE) {
+        uint32_t mask = structural_mask(bytes + i);
+        while (mask != 0) {
+            if (count >= max_positions) {
+                return max_positions + 1;
+            }
+            positions[count++] = (uint32_t)(i + (size_t)__builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    
+    for (; i < length; i++) {
+        if (is_structural(bytes[i])) {
+            if (count >= max_positions) {
+                return max_positions + 1;
+            }
+            positions[count++] = (uint32_t)i;
+        }
+    }
+    
+    return count;
+}
+
+size_t json_scan_structurals_scalar(const char *data, size_t length,
+                                    uint32_t *positions, size_t max_positions) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t count = 0;
+    
+    for (size_t i = 0; i < length; i++) {
+        if (is_structural(bytes[i])) {
+            if (count >= max_positions) {
+                return max_positions + 1;
+            }
+            positions[count++] = (uint32_t)i;
+        }
+    }
+    
+    return count;
+}
+
+int json_scan_find_string(const char *data, size_t length, const char *key,
+                          const char **value, size_t *value_length) {
+    return lookup_string(data, length, key, false, value, value_length);
+}
+
+int json_scan_find_top_string(const char *data, size_t length, const char *key,
+                              const char **value, size_t *value_length) {
+    return lookup_string(data, length, key, true, value, value_length);
+}
+
+int json_scan_find_int(const char *data, size_t length, const char *key, long *value) {
+    return lookup_int(data, length, key, false, value);
+}
+
+int json_scan_find_top_int(const char *data, size_t length, const char *key, long *value) {
+    return lookup_int(data, length, key, true, value);
+}
+
+int json_scan_for_each_element(const char *data, size_t length, const char *key,
+                               json_scan_element_fn fn, void *user_data) {
+    return split_array(data, length, key, false, fn, user_data);
+}
+
+int json_scan_for_each_top_element(const char *data, size_t length, const char *key,
+                                   json_scan_element_fn fn, void *user_data) {
+    return split_array(data, length, key, true, fn, user_data);
+}
+
+bool json_scan_utf8_valid(const char *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t i = 0;
+    
+    while (i < length) {
+        if (i + BLOCK_SIZE <= length && block_is_ascii(bytes + i)) {
+            i += BLOCK_SIZE;
+            continue;
+        }
+        
+        size_t n = utf8_sequence_length(bytes + i, length - i);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+    }
+    
+    return true;
+}
+
+bool json_scan_utf8_valid_scalar(const char *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t i = 0;
+    
+    while (i < length) {
+        size_t n = utf8_sequence_length(bytes + i, length - i);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+    }
+    
+    return true;
+}
+
+const char* json_scan_backend(void) {
+#if defined(JSON_SCAN_NEON)
+    return "neon";
+#elif defined(JSON_SCAN_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
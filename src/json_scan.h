@@ -0,0 +1,203 @@
+/**
+ * @file json_scan.h
+ * @brief JSON Scanner Module - Structural index and UTF-8 validation for bulk payloads
+ * 
+ * This module provides fast scanning of large JSON text messages.
+ * Features include:
+ * - Structural character index ({ } [ ] : , " \)
+ * - Key lookup driven by the index instead of repeated strstr()
+ * - UTF-8 validation for RFC 6455 text frames
+ * - NEON and SSE2 block scanning with a scalar fallback
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup JsonScan JSON Scanner Module
+ * @brief Structural indexing and validation of JSON text
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Payload size from which message parsers switch to the index */
+#define JSON_SCAN_SIMD_THRESHOLD    512
+
+/** Maximum structural positions indexed per message */
+#define JSON_SCAN_MAX_STRUCTURALS   4096
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Build the structural character index
+ * 
+ * Record the offset of every { } [ ] : , " and backslash in data.
+ * Characters inside strings are indexed too; consumers track string
+ * state while walking the index.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param positions Output array of byte offsets
+ * @param max_positions Capacity of positions
+ * @return Number of positions written, or max_positions + 1 if the
+ *         index did not fit
+ */
+size_t json_scan_structurals(const char *data, size_t length,
+                             uint32_t *positions, size_t max_positions);
+
+/**
+ * @brief Find a string value by key
+ * 
+ * Locate the first "key":"value" pair (at any nesting depth) and
+ * return a view of the raw value, escapes left as they are.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param value Set to the first byte of the value
+ * @param value_length Set to the value length in bytes
+ * @return 0 if found, negative if not found
+ */
+int json_scan_find_string(const char *data, size_t length, const char *key,
+                          const char **value, size_t *value_length);
+
+/**
+ * @brief Find a string value by key in the outermost object
+ * 
+ * Like json_scan_find_string(), but keys inside nested objects and
+ * arrays are ignored. Use it for protocol fields that a payload could
+ * otherwise shadow.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param value Set to the first byte of the value
+ * @param value_length Set to the value length in bytes
+ * @return 0 if found, negative if not found
+ */
+int json_scan_find_top_string(const char *data, size_t length, const char *key,
+                              const char **value, size_t *value_length);
+
+/**
+ * @brief Find an integer value by key
+ * 
+ * Locate the first "key":number pair (at any nesting depth). Fractions,
+ * exponents and values out of range are rejected.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param value Set to the parsed value
+ * @return 0 if found, negative if not found or not an integer
+ */
+int json_scan_find_int(const char *data, size_t length, const char *key, long *value);
+
+/**
+ * @brief Find an integer value by key in the outermost object
+ * 
+ * Like json_scan_find_int(), but keys inside nested objects and arrays
+ * are ignored.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param value Set to the parsed value
+ * @return 0 if found, negative if not found or not an integer
+ */
+int json_scan_find_top_int(const char *data, size_t length, const char *key, long *value);
+
+/**
+ * @brief Array element callback
+ * 
+ * @param element First byte of the element (not null-terminated)
+ * @param length Element length in bytes, surrounding whitespace trimmed
+ * @param user_data User-provided data pointer
+ */
+typedef void (*json_scan_element_fn)(const char *element, size_t length, void *user_data);
+
+/**
+ * @brief Split an array value by key
+ * 
+ * Locate the first "key":[...] pair and call fn for each top-level
+ * element of the array, in order.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param fn Element callback
+ * @param user_data User data for fn
+ * @return Number of elements, or negative if not found or unterminated
+ *         (elements before the error have already been reported)
+ */
+int json_scan_for_each_element(const char *data, size_t length, const char *key,
+                               json_scan_element_fn fn, void *user_data);
+
+/**
+ * @brief Split an array value by key in the outermost object
+ * 
+ * Like json_scan_for_each_element(), but keys inside nested objects and
+ * arrays are ignored.
+ * 
+ * @param data JSON text (need not be null-terminated)
+ * @param length Text length in bytes
+ * @param key Key to look for (without quotes)
+ * @param fn Element callback
+ * @param user_data User data for fn
+ * @return Number of elements, or negative if not found or unterminated
+ */
+int json_scan_for_each_top_element(const char *data, size_t length, const char *key,
+                                   json_scan_element_fn fn, void *user_data);
+
+/**
+ * @brief Validate UTF-8
+ * 
+ * Rejects overlong encodings, surrogates and code points above U+10FFFF.
+ * 
+ * @param data Bytes to check
+ * @param length Length in bytes
+ * @return true if data is valid UTF-8
+ */
+bool json_scan_utf8_valid(const char *data, size_t length);
+
+/**
+ * @brief Scalar reference of json_scan_structurals()
+ */
+size_t json_scan_structurals_scalar(const char *data, size_t length,
+                                    uint32_t *positions, size_t max_positions);
+
+/**
+ * @brief Scalar reference of json_scan_utf8_valid()
+ */
+bool json_scan_utf8_valid_scalar(const char *data, size_t length);
+
+/**
+ * @brief Get name of the block scanner compiled in
+ * 
+ * @return "neon", "sse2" or "scalar"
+ */
+const char* json_scan_backend(void);
+
+/** @} */ // end of JsonScan group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_SCAN_H */
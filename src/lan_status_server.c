@@ -0,0 +1,544 @@
+/**
+ * @file lan_status_server.c
+ * @brief LAN Status Server Implementation
+ *
+ * A minimal HTTP/1.1 responder: one request per connection, read until
+ * the end of the head, answered from the cached status. Event streams
+ * stay open and follow the same latest-value scheme as the control
+ * server, so a phone on weak Wi-Fi gets the newest status rather than a
+ * backlog, and one that stops reading is closed.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "lan_status_server.h"
+
+#ifndef TESTING
+  #ifdef OPENWRT_BUILD
+    #include <gaming/logger.h>
+  #else
+    #include "../../gaming-core/src/logger.h"
+  #endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+/**
+ * @brief Connection phase
+ */
+typedef enum {
+    LAN_CONN_FREE = 0,              /**< Slot unused */
+    LAN_CONN_REQUEST,               /**< Reading the request head */
+    LAN_CONN_RESPONSE,              /**< Writing a reply, close when done */
+    LAN_CONN_STREAM,                /**< Event stream, stays open */
+} lan_conn_phase_t;
+
+/**
+ * @brief One LAN connection
+ */
+typedef struct {
+    int fd;
+    lan_conn_phase_t phase;
+
+    char inbuf[LAN_STATUS_REQUEST_MAX];
+    size_t inbuf_len;
+
+    char outbuf[LAN_STATUS_OUTBUF_SIZE];
+    size_t outbuf_len;
+
+    uint32_t start_time;            /**< Accept time, bounds the request read */
+    uint32_t stall_start;           /**< When output stopped draining, 0 if flowing */
+    uint32_t last_write_time;       /**< Last event or keepalive queued */
+    uint32_t sent_seq;              /**< Last status sequence sent */
+} lan_conn_t;
+
+/**
+ * @brief LAN status server context
+ */
+typedef struct {
+    bool initialized;
+    int listen_fd;
+    int port;
+
+    char status[LAN_STATUS_MAX_LENGTH];
+    uint32_t status_seq;            /**< 0 until first update */
+
+    lan_conn_t conns[LAN_STATUS_MAX_CLIENTS];
+    lan_status_stats_t stats;
+} lan_status_ctx_t;
+
+/* ============================================================
+ *  Global Variables
+ * ============================================================ */
+
+static lan_status_ctx_t g_lan_ctx = {
+    .initialized = false,
+    .listen_fd = -1,
+};
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Get current time in milliseconds
+ */
+static uint32_t get_current_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void close_conn(lan_conn_t *conn) {
+    if (conn->phase == LAN_CONN_FREE) {
+        return;
+    }
+
+    close(conn->fd);
+    if (conn->phase == LAN_CONN_STREAM) {
+        g_lan_ctx.stats.subscribers--;
+    }
+    memset(conn, 0, sizeof(*conn));
+    conn->fd = -1;
+}
+
+static int queue_output(lan_conn_t *conn, const char *data, int length) {
+    if (length < 0 || conn->outbuf_len + (size_t)length > sizeof(conn->outbuf)) {
+        return -1;
+    }
+
+    memcpy(conn->outbuf + conn->outbuf_len, data, (size_t)length);
+    conn->outbuf_len += (size_t)length;
+    return 0;
+}
+
+/**
+ * @brief Current status, or a placeholder before the first update
+ */
+static const char* current_status(void) {
+    return g_lan_ctx.status_seq != 0 ? g_lan_ctx.status : "{\"status\":\"UNKNOWN\"}";
+}
+
+/**
+ * @brief Queue a complete response and close after it is written
+ */
+static void respond(lan_conn_t *conn, const char *status_line, const char *content_type,
+                    const char *body) {
+    char response[LAN_STATUS_OUTBUF_SIZE];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 %s\r\n"
+                       "Content-Type: %s\r\n"
+                       "Content-Length: %zu\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Access-Control-Allow-Origin: *\r\n"
+                       "Connection: close\r\n"
+                       "\r\n"
+                       "%s",
+                       status_line, content_type, strlen(body), body);
+
+    conn->phase = LAN_CONN_RESPONSE;
+    if (len >= (int)sizeof(response)) {
+        len = -1;
+    }
+    queue_output(conn, response, len);
+}
+
+/**
+ * @brief Queue the status for a subscriber if it has not seen it yet
+ */
+static void queue_update(lan_conn_t *conn, uint32_t now) {
+    char event[LAN_STATUS_MAX_LENGTH + 16];
+
+    if (g_lan_ctx.status_seq != conn->sent_seq && g_lan_ctx.status_seq != 0) {
+        int len = snprintf(event, sizeof(event), "data: %s\n\n", g_lan_ctx.status);
+        if (queue_output(conn, event, len) != 0) {
+            return;  // Retried next pass, possibly with a newer status
+        }
+
+        if (conn->sent_seq != 0) {
+            g_lan_ctx.stats.updates_coalesced += g_lan_ctx.status_seq - conn->sent_seq - 1;
+        }
+        conn->sent_seq = g_lan_ctx.status_seq;
+        conn->last_write_time = now;
+        g_lan_ctx.stats.updates_pushed++;
+    } else if (now - conn->last_write_time >= LAN_STATUS_KEEPALIVE_MS &&
+               queue_output(conn, ": keepalive\n\n", 13) == 0) {
+        conn->last_write_time = now;
+    }
+}
+
+/**
+ * @brief Start an event stream
+ */
+static void start_stream(lan_conn_t *conn, uint32_t now) {
+    static const char head[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "retry: 5000\n\n";
+
+    queue_output(conn, head, (int)sizeof(head) - 1);
+    conn->phase = LAN_CONN_STREAM;
+    conn->last_write_time = now;
+
+    g_lan_ctx.stats.event_streams++;
+    g_lan_ctx.stats.subscribers++;
+    if (g_lan_ctx.stats.subscribers > g_lan_ctx.stats.peak_subscribers) {
+        g_lan_ctx.stats.peak_subscribers = g_lan_ctx.stats.subscribers;
+    }
+}
+
+/**
+ * @brief Route a complete request head
+ */
+static void handle_request(lan_conn_t *conn, uint32_t now) {
+    char method[8];
+    char path[64];
+
+    // Only the request line matters; headers are ignored
+    if (sscanf(conn->inbuf, "%7s %63s HTTP/1.", method, path) != 2) {
+        g_lan_ctx.stats.bad_requests++;
+        respond(conn, "400 Bad Request", "text/plain", "Bad Request\n");
+        return;
+    }
+
+    char *query = strchr(path, '?');
+    if (query != NULL) {
+        *query = '\0';
+    }
+
+    if (strcmp(method, "GET") != 0) {
+        g_lan_ctx.stats.bad_requests++;
+        respond(conn, "405 Method Not Allowed", "text/plain", "Method Not Allowed\n");
+    } else if (strcmp(path, "/status") == 0) {
+        g_lan_ctx.stats.status_requests++;
+        respond(conn, "200 OK", "application/json", current_status());
+    } else if (strcmp(path, "/events") == 0) {
+        start_stream(conn, now);
+    } else {
+        g_lan_ctx.stats.bad_requests++;
+        respond(conn, "404 Not Found", "text/plain", "Not Found\n");
+    }
+}
+
+/**
+ * @brief Read the request head
+ *
+ * @return 0 to keep the connection, -1 to drop it
+ */
+static int read_request(lan_conn_t *conn, uint32_t now) {
+    for (;;) {
+        size_t space = sizeof(conn->inbuf) - 1 - conn->inbuf_len;
+        if (space == 0) {
+            g_lan_ctx.stats.bad_requests++;
+            return -1;  // Head too large
+        }
+
+        ssize_t n = recv(conn->fd, conn->inbuf + conn->inbuf_len, space, MSG_DONTWAIT);
+        if (n == 0) {
+            return -1;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return -1;
+            }
+            break;
+        }
+        // Only the new bytes can complete the head, a trickled request
+        // must not be rescanned from the start on every read
+        const char *from = conn->inbuf + (conn->inbuf_len > 3 ? conn->inbuf_len - 3 : 0);
+        conn->inbuf_len += (size_t)n;
+        conn->inbuf[conn->inbuf_len] = '\0';
+
+        if (strstr(from, "\r\n\r\n") != NULL || strstr(from, "\n\n") != NULL) {
+            handle_request(conn, now);
+            return 0;
+        }
+    }
+
+    // A LAN client that trickles its request holds a slot; bound it
+    if (now - conn->start_time >= LAN_STATUS_STALL_TIMEOUT_MS) {
+        g_lan_ctx.stats.slow_drops++;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Drain input of an open stream, only to notice the peer closing
+ *
+ * @return 0 to keep the connection, -1 to drop it
+ */
+static int check_stream_input(lan_conn_t *conn) {
+    char discard[64];
+
+    for (;;) {
+        ssize_t n = recv(conn->fd, discard, sizeof(discard), MSG_DONTWAIT);
+        if (n > 0) {
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        return -1;
+    }
+}
+
+/**
+ * @brief Write as much output as the socket takes
+ *
+ * @return 0 to keep the connection, -1 to drop it
+ */
+static int flush_conn(lan_conn_t *conn, uint32_t now) {
+    size_t written = 0;
+
+    while (written < conn->outbuf_len) {
+        ssize_t n = send(conn->fd, conn->outbuf + written, conn->outbuf_len - written,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            written += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        return -1;
+    }
+
+    if (written > 0) {
+        memmove(conn->outbuf, conn->outbuf + written, conn->outbuf_len - written);
+        conn->outbuf_len -= written;
+        conn->stall_start = 0;
+    }
+
+    if (conn->outbuf_len == 0) {
+        // A one-shot reply is complete
+        return conn->phase == LAN_CONN_RESPONSE ? -1 : 0;
+    }
+
+    if (conn->stall_start == 0) {
+        conn->stall_start = now;
+    } else if (now - conn->stall_start >= LAN_STATUS_STALL_TIMEOUT_MS) {
+        g_lan_ctx.stats.slow_drops++;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void accept_conns(uint32_t now) {
+    for (;;) {
+        int fd = accept(g_lan_ctx.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            return;
+        }
+
+        lan_conn_t *slot = NULL;
+        for (int i = 0; i < LAN_STATUS_MAX_CLIENTS; i++) {
+            if (g_lan_ctx.conns[i].phase == LAN_CONN_FREE) {
+                slot = &g_lan_ctx.conns[i];
+                break;
+            }
+        }
+
+        if (slot == NULL || set_nonblocking(fd) != 0) {
+            g_lan_ctx.stats.rejected++;
+            close(fd);
+            continue;
+        }
+
+        memset(slot, 0, sizeof(*slot));
+        slot->fd = fd;
+        slot->phase = LAN_CONN_REQUEST;
+        slot->start_time = now;
+    }
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+int lan_status_server_init(const char *bind_address, int port) {
+    if (g_lan_ctx.initialized) {
+        #ifndef TESTING
+        logger_warning("LAN status server already initialized");
+        #endif
+        return -1;
+    }
+
+    if (port < 0 || port > 65535) {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind_address != NULL && bind_address[0] != '\0' &&
+        inet_pton(AF_INET, bind_address, &addr.sin_addr) != 1) {
+        return -1;
+    }
+
+    memset(&g_lan_ctx, 0, sizeof(g_lan_ctx));
+    g_lan_ctx.listen_fd = -1;
+    for (int i = 0; i < LAN_STATUS_MAX_CLIENTS; i++) {
+        g_lan_ctx.conns[i].fd = -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    socklen_t addr_len = sizeof(addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(fd, LAN_STATUS_MAX_CLIENTS) != 0 ||
+        set_nonblocking(fd) != 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        #ifndef TESTING
+        logger_error("Failed to listen on LAN status port %d: %s", port, strerror(errno));
+        #endif
+        close(fd);
+        return -1;
+    }
+
+    g_lan_ctx.listen_fd = fd;
+    g_lan_ctx.port = ntohs(addr.sin_port);
+    g_lan_ctx.initialized = true;
+
+    #ifndef TESTING
+    logger_info("LAN status server listening on %s:%d",
+                (bind_address != NULL && bind_address[0] != '\0') ? bind_address : "*",
+                g_lan_ctx.port);
+    #endif
+
+    return 0;
+}
+
+int lan_status_server_get_port(void) {
+    return g_lan_ctx.initialized ? g_lan_ctx.port : -1;
+}
+
+int lan_status_server_update(const char *json) {
+    if (!g_lan_ctx.initialized || json == NULL) {
+        return -1;
+    }
+
+    size_t len = strlen(json);
+    if (len >= sizeof(g_lan_ctx.status)) {
+        return -1;
+    }
+
+    memcpy(g_lan_ctx.status, json, len + 1);
+    g_lan_ctx.status_seq++;
+    if (g_lan_ctx.status_seq == 0) {
+        g_lan_ctx.status_seq = 1;  // 0 means "no status yet"
+    }
+
+    return 0;
+}
+
+void lan_status_server_process(void) {
+    if (!g_lan_ctx.initialized) {
+        return;
+    }
+
+    uint32_t now = get_current_time_ms();
+
+    accept_conns(now);
+
+    for (int i = 0; i < LAN_STATUS_MAX_CLIENTS; i++) {
+        lan_conn_t *conn = &g_lan_ctx.conns[i];
+        int result = 0;
+
+        switch (conn->phase) {
+            case LAN_CONN_FREE:
+                continue;
+            case LAN_CONN_REQUEST:
+                result = read_request(conn, now);
+                break;
+            case LAN_CONN_STREAM:
+                result = check_stream_input(conn);
+                break;
+            case LAN_CONN_RESPONSE:
+                break;
+        }
+
+        if (result == 0 && conn->phase == LAN_CONN_STREAM) {
+            queue_update(conn, now);
+        }
+
+        if (result != 0 ||
+            (conn->phase != LAN_CONN_REQUEST && flush_conn(conn, now) != 0)) {
+            close_conn(conn);
+        }
+    }
+}
+
+int lan_status_server_get_subscriber_count(void) {
+    return (int)g_lan_ctx.stats.subscribers;
+}
+
+int lan_status_server_get_stats(lan_status_stats_t *stats) {
+    if (stats == NULL) {
+        return -1;
+    }
+
+    *stats = g_lan_ctx.stats;
+    return 0;
+}
+
+void lan_status_server_cleanup(void) {
+    if (!g_lan_ctx.initialized) {
+        return;
+    }
+
+    for (int i = 0; i < LAN_STATUS_MAX_CLIENTS; i++) {
+        close_conn(&g_lan_ctx.conns[i]);
+    }
+    close(g_lan_ctx.listen_fd);
+
+    memset(&g_lan_ctx, 0, sizeof(g_lan_ctx));
+    g_lan_ctx.listen_fd = -1;
+}
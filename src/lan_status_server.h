@@ -0,0 +1,146 @@
+/**
+ * @file lan_status_server.h
+ * @brief LAN Status Server - cached PS5 status for devices on the LAN
+ *
+ * Phones and laptops behind the router read the console status from the
+ * client instead of each opening a session to the home gaming-server. The
+ * client keeps its single upstream session and serves the last known
+ * status over plain HTTP.
+ * Features include:
+ * - GET /status returns the cached status as JSON
+ * - GET /events streams status updates as Server-Sent Events
+ * - Updates coalesced per subscriber, slow readers dropped
+ * - Non-blocking, serviced from the main loop
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef LAN_STATUS_SERVER_H
+#define LAN_STATUS_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LanStatusServer LAN Status Server
+ * @brief HTTP status cache for LAN clients
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Suggested listen port */
+#define LAN_STATUS_DEFAULT_PORT         8766
+
+/** Maximum simultaneous LAN connections */
+#define LAN_STATUS_MAX_CLIENTS          16
+
+/** Maximum length of the status JSON */
+#define LAN_STATUS_MAX_LENGTH           256
+
+/** Longest accepted request head */
+#define LAN_STATUS_REQUEST_MAX          1024
+
+/** Output buffer per connection */
+#define LAN_STATUS_OUTBUF_SIZE          1024
+
+/** Time a connection may block its output, or take to send a request */
+#define LAN_STATUS_STALL_TIMEOUT_MS     5000
+
+/** Comment line sent to idle event streams so proxies keep them open */
+#define LAN_STATUS_KEEPALIVE_MS         15000
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief LAN status server statistics
+ */
+typedef struct {
+    uint32_t subscribers;           /**< Current event-stream subscribers */
+    uint32_t peak_subscribers;      /**< Most subscribers at once */
+    uint32_t status_requests;       /**< GET /status answered */
+    uint32_t event_streams;         /**< GET /events accepted */
+    uint32_t bad_requests;          /**< Malformed or unknown requests */
+    uint32_t rejected;              /**< Connections refused, all slots in use */
+    uint32_t updates_pushed;        /**< Event lines queued to subscribers */
+    uint32_t updates_coalesced;     /**< Updates a subscriber skipped */
+    uint32_t slow_drops;            /**< Connections dropped for stalling */
+} lan_status_stats_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize LAN status server
+ *
+ * @param bind_address IPv4 address to listen on (NULL or empty for all)
+ * @param port TCP port (0 picks a free port, see lan_status_server_get_port)
+ * @return 0 on success, -1 on failure
+ */
+int lan_status_server_init(const char *bind_address, int port);
+
+/**
+ * @brief Get the port the server listens on
+ *
+ * @return Port, or -1 if not initialized
+ */
+int lan_status_server_get_port(void);
+
+/**
+ * @brief Set the cached status
+ *
+ * Only records the value; subscribers are written in
+ * lan_status_server_process().
+ *
+ * @param json Status as a JSON object
+ * @return 0 on success, -1 on failure
+ */
+int lan_status_server_update(const char *json);
+
+/**
+ * @brief Serve LAN clients
+ *
+ * Accept connections, answer requests and flush pending updates without
+ * blocking. Call from the main loop.
+ */
+void lan_status_server_process(void);
+
+/**
+ * @brief Get number of event-stream subscribers
+ *
+ * @return Current subscribers
+ */
+int lan_status_server_get_subscriber_count(void);
+
+/**
+ * @brief Get LAN status server statistics
+ *
+ * @param stats Output statistics
+ * @return 0 on success, -1 on failure
+ */
+int lan_status_server_get_stats(lan_status_stats_t *stats);
+
+/**
+ * @brief Clean up LAN status server
+ */
+void lan_status_server_cleanup(void);
+
+/** @} */ // end of LanStatusServer group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LAN_STATUS_SERVER_H */
@@ -15,9 +15,12 @@
  */
 
 #include "client_state_machine.h"
-#include "button_handler.h"
 #include "vpn_controller.h"
 #include "websocket_client.h"
+#include "control_server.h"
+#include "lan_status_server.h"
+#include "usage_predictor.h"
+#include "path_cache.h"
 
 #ifndef TESTING
   #ifdef OPENWRT_BUILD
@@ -39,6 +42,8 @@
 #include <signal.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <time.h>
+#include <sys/time.h>
 
 /* ============================================================
  *  Constants
@@ -54,9 +59,21 @@
 #define DEFAULT_LED_PIN_G           23
 #define DEFAULT_LED_PIN_B           24
 #define DEFAULT_VPN_SOCKET_PATH     "/var/run/vpn-agent.sock"
+#define DEFAULT_VPN_SHM_NAME        "/vpn-agent-state"
 #define DEFAULT_WS_SERVER_HOST      "192.168.1.1"
 #define DEFAULT_WS_SERVER_PORT      8080
 
+// Control interface
+#define CONTROL_METRICS_INTERVAL_MS 1000
+
+// Usage prediction
+#define USAGE_CHECK_INTERVAL_MS     30000
+#define USAGE_SAVE_INTERVAL_MS      3600000     // Profile lives on flash
+
+// Per-network path cache
+#define NETWORK_CHECK_INTERVAL_MS   10000
+#define PATH_SAVE_INTERVAL_MS       3600000     // Cache lives on flash
+
 /* ============================================================
  *  Global Variables
  * ============================================================ */
@@ -64,6 +81,33 @@
 static volatile sig_atomic_t g_running = 1;
 static client_context_t *g_client_ctx = NULL;
 
+// Last values pushed to control subscribers
+static ps5_status_t g_published_ps5 = PS5_STATUS_UNKNOWN;
+static ps5_status_t g_lan_status = PS5_STATUS_UNKNOWN;
+static time_t g_lan_query_time = 0;
+static client_stats_t g_published_stats;
+static uint32_t g_last_metrics_time = 0;
+static uint32_t g_published_failures = 0;
+static uint32_t g_published_recoveries = 0;
+
+// Learned usage and pre-warm
+static usage_predictor_t g_usage;
+static char g_usage_path[128];
+static uint32_t g_prewarm_lead_ms = 0;
+static uint32_t g_last_usage_check = 0;
+static uint32_t g_last_usage_save = 0;
+static int g_prewarm_slot = -1;
+
+// Best server per network
+static path_cache_t g_paths;
+static char g_paths_path[128];
+static char g_configured_host[256];
+static int g_configured_port = 0;
+static uint32_t g_network = 0;              // Fingerprint, 0 until first probe
+static bool g_network_applied = true;       // Primary server matches the network
+static uint32_t g_last_network_check = 0;
+static uint32_t g_last_paths_save = 0;
+
 /* ============================================================
  *  LED Configuration Structure
  *  (分離出來避免與 client_config_t 混淆)
@@ -85,11 +129,13 @@ static void signal_handler(int signum) {
         case SIGINT:
             logger_info("Received signal %d, shutting down gracefully...", signum);
             g_running = 0;
+            if (g_client_ctx) {
+                client_sm_stop(g_client_ctx);
+            }
             break;
             
         case SIGUSR1:
-            // Simulate button press for testing
-            logger_info("Received SIGUSR1, simulating button press");
+            // Simulate button press for testing; only recorded here
             if (g_client_ctx) {
                 // 使用正確的 API: client_sm_trigger_button
                 client_sm_trigger_button(g_client_ctx, false);
@@ -120,18 +166,256 @@ static void setup_signal_handlers(void) {
  *  Callback Functions
  * ============================================================ */
 
+/**
+ * @brief Remember which server answered the press first on this network
+ */
+static void record_press_path(void) {
+    fanout_entry_t table[1 + FANOUT_MAX_SERVERS];
+    const fanout_entry_t *winner = NULL;
+    
+    if (g_client_ctx == NULL || g_network == 0 || g_paths_path[0] == '\0') {
+        return;
+    }
+    
+    int count = client_sm_get_status_table(g_client_ctx, table, 1 + FANOUT_MAX_SERVERS);
+    for (int i = 0; i < count; i++) {
+        if (table[i].result == FANOUT_RESULT_OK &&
+            (winner == NULL || table[i].latency_ms < winner->latency_ms)) {
+            winner = &table[i];
+        }
+    }
+    
+    if (winner != NULL) {
+        path_cache_record(&g_paths, g_network, winner->host, winner->port, winner->latency_ms);
+    }
+}
+
 static void on_state_change(client_state_t old_state, 
                            client_state_t new_state, 
                            void *user_data) {
     logger_info("Client state: %s -> %s",
                 client_state_to_string(old_state),
                 client_state_to_string(new_state));
+    
+    char event[128];
+    snprintf(event, sizeof(event), "{\"from\":\"%s\",\"to\":\"%s\"}",
+             client_state_to_string(old_state), client_state_to_string(new_state));
+    control_server_publish(CONTROL_TOPIC_STATE, event);
+    
+    // Every press teaches the usage histogram
+    if (old_state == CLIENT_STATE_IDLE && new_state == CLIENT_STATE_PRESS_START) {
+        usage_predictor_record(&g_usage, usage_predictor_slot(time(NULL)));
+    }
+    
+    // Only a reply to this press's query, not a cached fallback
+    if (old_state == CLIENT_STATE_QUERYING_PS5 && new_state == CLIENT_STATE_LED_UPDATE) {
+        record_press_path();
+    }
 }
 
 static void on_error(client_error_t error, const char *message, void *user_data) {
     logger_error("Client error: %s - %s", client_error_to_string(error), message);
 }
 
+/* ============================================================
+ *  Control Interface
+ * ============================================================ */
+
+static uint32_t get_current_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+static int write_status_snapshot(char *buffer, size_t size, void *user_data) {
+    client_stats_t stats;
+    
+    if (g_client_ctx == NULL || client_sm_get_stats(g_client_ctx, &stats) != 0) {
+        return -1;
+    }
+    
+    return snprintf(buffer, size,
+                    "{\"state\":\"%s\",\"ps5\":\"%s\",\"presses\":%u,"
+                    "\"successful_queries\":%u,\"failed_queries\":%u,\"errors\":%u,"
+                    "\"lan_subscribers\":%d}",
+                    client_state_to_string(client_sm_get_state(g_client_ctx)),
+                    ps5_status_to_string(client_sm_get_ps5_status(g_client_ctx)),
+                    stats.button_press_count, stats.successful_queries,
+                    stats.failed_queries, stats.error_count,
+                    lan_status_server_get_subscriber_count());
+}
+
+static int press_from_control(void *user_data) {
+    return (g_client_ctx != NULL) ? client_sm_trigger_button(g_client_ctx, false) : -1;
+}
+
+/**
+ * @brief Publish PS5 status changes and metric deltas to control subscribers
+ */
+static void publish_control_updates(void) {
+    if (g_client_ctx == NULL) {
+        return;
+    }
+    
+    ps5_status_t ps5 = client_sm_get_ps5_status(g_client_ctx);
+    if (ps5 != g_published_ps5) {
+        char event[64];
+        snprintf(event, sizeof(event), "{\"status\":\"%s\"}", ps5_status_to_string(ps5));
+        if (control_server_publish(CONTROL_TOPIC_PS5, event) == 0) {
+            g_published_ps5 = ps5;
+        }
+    }
+    
+    // LAN clients get the last known status, not the UNKNOWN of a press in flight
+    client_stats_t stats;
+    if (ps5 != PS5_STATUS_UNKNOWN && client_sm_get_stats(g_client_ctx, &stats) == 0 &&
+        (ps5 != g_lan_status || stats.last_query_time != g_lan_query_time)) {
+        char status[LAN_STATUS_MAX_LENGTH];
+        snprintf(status, sizeof(status), "{\"status\":\"%s\",\"updated\":%ld}",
+                 ps5_status_to_string(ps5), (long)stats.last_query_time);
+        if (lan_status_server_update(status) == 0) {
+            g_lan_status = ps5;
+            g_lan_query_time = stats.last_query_time;
+        }
+    }
+    
+    uint32_t now = get_current_time_ms();
+    if (now - g_last_metrics_time < CONTROL_METRICS_INTERVAL_MS) {
+        return;
+    }
+    g_last_metrics_time = now;
+    
+    if (client_sm_get_stats(g_client_ctx, &stats) != 0) {
+        return;
+    }
+    
+    // Only counters that moved since the last update are sent
+    char event[CONTROL_EVENT_MAX];
+    int len = snprintf(event, sizeof(event), "{");
+    const struct { const char *name; uint32_t now; uint32_t before; } counters[] = {
+        { "presses",            stats.button_press_count,  g_published_stats.button_press_count },
+        { "successful_queries", stats.successful_queries,  g_published_stats.successful_queries },
+        { "failed_queries",     stats.failed_queries,      g_published_stats.failed_queries },
+        { "vpn_connects",       stats.vpn_connect_count,   g_published_stats.vpn_connect_count },
+        { "errors",             stats.error_count,         g_published_stats.error_count },
+        { "restarted",          stats.restarted_workflows, g_published_stats.restarted_workflows },
+        { "cancelled",          stats.cancelled_workflows, g_published_stats.cancelled_workflows },
+    };
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+        if (counters[i].now != counters[i].before) {
+            len += snprintf(event + len, sizeof(event) - (size_t)len, "%s\"%s\":%u",
+                            len > 1 ? "," : "", counters[i].name,
+                            counters[i].now - counters[i].before);
+        }
+    }
+    
+    if (len > 1) {
+        snprintf(event + len, sizeof(event) - (size_t)len, "}");
+        control_server_publish(CONTROL_TOPIC_METRICS, event);
+        g_published_stats = stats;
+    }
+    
+    // Failure table, whenever a failure or a recovery was recorded
+    failure_stats_t failures;
+    if (client_sm_get_failure_stats(g_client_ctx, &failures) != 0) {
+        return;
+    }
+    
+    uint32_t recoveries = 0;
+    for (int i = 0; i < FAILURE_CAUSE_COUNT; i++) {
+        recoveries += failures.causes[i].recovered;
+    }
+    
+    if (failures.log_count != g_published_failures || recoveries != g_published_recoveries) {
+        failure_stats_to_json(&failures, event, sizeof(event));
+        control_server_publish(CONTROL_TOPIC_FAILURES, event);
+        g_published_failures = failures.log_count;
+        g_published_recoveries = recoveries;
+    }
+}
+
+/* ============================================================
+ *  Usage Prediction
+ * ============================================================ */
+
+/**
+ * @brief Pre-warm ahead of likely use and save what was learned
+ */
+static void update_usage_prediction(void) {
+    uint32_t now = get_current_time_ms();
+    
+    if (g_client_ctx == NULL || g_usage_path[0] == '\0' ||
+        now - g_last_usage_check < USAGE_CHECK_INTERVAL_MS) {
+        return;
+    }
+    g_last_usage_check = now;
+    
+    time_t wall = time(NULL);
+    usage_predictor_tick(&g_usage, usage_predictor_slot(wall));
+    
+    // Once per likely slot; the hold covers the lead and the slot itself
+    if (g_prewarm_lead_ms > 0) {
+        int slot = usage_predictor_slot(wall + (time_t)(g_prewarm_lead_ms / 1000));
+        if (slot != g_prewarm_slot && usage_predictor_is_likely(&g_usage, slot) &&
+            client_sm_prewarm(g_client_ctx,
+                              g_prewarm_lead_ms + USAGE_SLOT_MINUTES * 60 * 1000) == 0) {
+            g_prewarm_slot = slot;
+        }
+    }
+    
+    if (g_usage.dirty && now - g_last_usage_save >= USAGE_SAVE_INTERVAL_MS) {
+        if (usage_predictor_save(&g_usage, g_usage_path) != 0) {
+            logger_warning("Failed to save usage profile %s", g_usage_path);
+        }
+        g_last_usage_save = now;
+    }
+}
+
+/**
+ * @brief Follow the network the router is on and use its best server
+ */
+static void update_network_path(void) {
+    uint32_t now = get_current_time_ms();
+    uint32_t network;
+    
+    if (g_client_ctx == NULL || g_paths_path[0] == '\0' ||
+        now - g_last_network_check < NETWORK_CHECK_INTERVAL_MS) {
+        return;
+    }
+    g_last_network_check = now;
+    
+    // The last network stays while a new gateway is being resolved
+    if (path_cache_probe(PATH_CACHE_ROUTE_TABLE, PATH_CACHE_ARP_TABLE, &network) == 0 &&
+        network != g_network) {
+        const path_cache_entry_t *known = path_cache_lookup(&g_paths, network);
+        if (known != NULL) {
+            logger_info("Known network %08x: %s:%u answered first, typical reply %u ms "
+                        "(%u presses)", network, known->host, known->port, known->rtt_ms,
+                        known->presses);
+        } else {
+            logger_info("New network %08x, using configured server", network);
+        }
+        g_network = network;
+        g_network_applied = false;
+    }
+    
+    // A press or pre-warm keeps its links; retried on the next check
+    if (!g_network_applied) {
+        const path_cache_entry_t *known = path_cache_lookup(&g_paths, g_network);
+        int result = (known != NULL)
+            ? client_sm_set_primary_server(g_client_ctx, known->host, known->port)
+            : client_sm_set_primary_server(g_client_ctx, g_configured_host, g_configured_port);
+        g_network_applied = (result == 0);
+    }
+    
+    if (g_paths.dirty && now - g_last_paths_save >= PATH_SAVE_INTERVAL_MS) {
+        if (path_cache_save(&g_paths, g_paths_path) != 0) {
+            logger_warning("Failed to save path cache %s", g_paths_path);
+        }
+        g_last_paths_save = now;
+    }
+}
+
 /* ============================================================
  *  Configuration Loading
  * ============================================================ */
@@ -145,10 +429,25 @@ static int load_configuration(client_config_t *config, led_config_local_t *led_c
     config->button_pin = DEFAULT_BUTTON_PIN;
     config->button_debounce_ms = DEFAULT_BUTTON_DEBOUNCE_MS;
     strncpy(config->vpn_socket_path, DEFAULT_VPN_SOCKET_PATH, sizeof(config->vpn_socket_path) - 1);
+    strncpy(config->vpn_shm_name, DEFAULT_VPN_SHM_NAME, sizeof(config->vpn_shm_name) - 1);
     strncpy(config->ws_server_host, DEFAULT_WS_SERVER_HOST, sizeof(config->ws_server_host) - 1);
     config->ws_server_port = DEFAULT_WS_SERVER_PORT;
+    config->fanout_servers[0] = '\0';
+    strncpy(config->control_socket_path, CONTROL_DEFAULT_SOCKET_PATH,
+            sizeof(config->control_socket_path) - 1);
+    config->lan_status_bind[0] = '\0';
+    config->lan_status_port = 0;
     config->auto_retry = true;
     config->max_retry_attempts = 3;
+    config->vpn_linger_ms = VPN_DEFAULT_LINGER_MS;
+    config->ws_weighted_scheduling = false;
+    config->ws_batching = true;
+    config->press_budget_ms = PRESS_BUDGET_DEFAULT_MS;
+    config->idle_release_ms = 0;
+    strncpy(config->usage_profile_path, USAGE_DEFAULT_PROFILE_PATH,
+            sizeof(config->usage_profile_path) - 1);
+    config->prewarm_lead_ms = USAGE_DEFAULT_LEAD_S * 1000;
+    strncpy(config->path_cache_path, PATH_CACHE_DEFAULT_PATH, sizeof(config->path_cache_path) - 1);
     
     led_config->led_pin_r = DEFAULT_LED_PIN_R;
     led_config->led_pin_g = DEFAULT_LED_PIN_G;
@@ -190,6 +489,16 @@ static int load_configuration(client_config_t *config, led_config_local_t *led_c
         strncpy(config->vpn_socket_path, str_value, sizeof(config->vpn_socket_path) - 1);
     }
     
+    if (config_parser_get_string("gaming-client", "network", "vpn_shm_name",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->vpn_shm_name, str_value, sizeof(config->vpn_shm_name) - 1);
+    }
+    
+    if (config_parser_get_int("gaming-client", "network", "vpn_linger_ms", &value) == 0 &&
+        value >= 0) {
+        config->vpn_linger_ms = (uint32_t)value;
+    }
+    
     // WebSocket configuration
     if (config_parser_get_string("gaming-client", "network", "ws_server_host",
                                  str_value, sizeof(str_value)) == 0) {
@@ -200,8 +509,39 @@ static int load_configuration(client_config_t *config, led_config_local_t *led_c
         config->ws_server_port = value;
     }
     
-    // Retry configuration
+    if (config_parser_get_string("gaming-client", "network", "fanout_servers",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->fanout_servers, str_value, sizeof(config->fanout_servers) - 1);
+    }
+    
+    // Control interface (empty path disables it)
+    if (config_parser_get_string("gaming-client", "network", "control_socket_path",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->control_socket_path, str_value, sizeof(config->control_socket_path) - 1);
+        config->control_socket_path[sizeof(config->control_socket_path) - 1] = '\0';
+    }
+    
+    if (config_parser_get_string("gaming-client", "network", "lan_status_bind",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->lan_status_bind, str_value, sizeof(config->lan_status_bind) - 1);
+    }
+    
+    if (config_parser_get_int("gaming-client", "network", "lan_status_port", &value) == 0 &&
+        value >= 0 && value <= 65535) {
+        config->lan_status_port = value;
+    }
+    
     bool bool_value;
+    if (config_parser_get_bool("gaming-client", "network", "ws_weighted_scheduling",
+                               &bool_value) == 0) {
+        config->ws_weighted_scheduling = bool_value;
+    }
+    
+    if (config_parser_get_bool("gaming-client", "network", "ws_batching", &bool_value) == 0) {
+        config->ws_batching = bool_value;
+    }
+    
+    // Retry configuration
     if (config_parser_get_bool("gaming-client", "network", "auto_retry", &bool_value) == 0) {
         config->auto_retry = bool_value;
     }
@@ -210,6 +550,34 @@ static int load_configuration(client_config_t *config, led_config_local_t *led_c
         config->max_retry_attempts = value;
     }
     
+    if (config_parser_get_int("gaming-client", "network", "press_budget_ms", &value) == 0 &&
+        value >= 0) {
+        config->press_budget_ms = (uint32_t)value;
+    }
+    
+    // Low-memory devices: free agent link and WS context between presses
+    if (config_parser_get_int("gaming-client", "network", "idle_release_s", &value) == 0 &&
+        value >= 0) {
+        config->idle_release_ms = (uint32_t)value * 1000;
+    }
+    
+    if (config_parser_get_string("gaming-client", "network", "usage_profile_path",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->usage_profile_path, str_value, sizeof(config->usage_profile_path) - 1);
+        config->usage_profile_path[sizeof(config->usage_profile_path) - 1] = '\0';
+    }
+    
+    if (config_parser_get_int("gaming-client", "network", "prewarm_lead_s", &value) == 0 &&
+        value >= 0) {
+        config->prewarm_lead_ms = (uint32_t)value * 1000;
+    }
+    
+    if (config_parser_get_string("gaming-client", "network", "path_cache_path",
+                                 str_value, sizeof(str_value)) == 0) {
+        strncpy(config->path_cache_path, str_value, sizeof(config->path_cache_path) - 1);
+        config->path_cache_path[sizeof(config->path_cache_path) - 1] = '\0';
+    }
+    
     return 0;
 }
 
@@ -227,6 +595,10 @@ static int initialize_system(const client_config_t *config,
     logger_info("=== Gaming Client Starting ===");
     logger_info("Version: %s", PROGRAM_VERSION);
     logger_info("Mode: %s", use_mock ? "MOCK" : "REAL");
+    logger_info("Features: button %s, LED %s, VPN %s",
+                CLIENT_FEATURE_BUTTON ? "on" : "off",
+                CLIENT_FEATURE_LED ? "on" : "off",
+                CLIENT_FEATURE_VPN ? "on" : "off");
     
     // 2. Initialize HAL
     #ifndef TESTING
@@ -239,7 +611,7 @@ static int initialize_system(const client_config_t *config,
     #endif
     
     // 3. Initialize LED controller
-    #ifndef TESTING
+    #if !defined(TESTING) && CLIENT_FEATURE_LED
     led_config_t led_cfg = {
         .pin_r = led_config->led_pin_r,
         .pin_g = led_config->led_pin_g,
@@ -261,7 +633,9 @@ static int initialize_system(const client_config_t *config,
     if (g_client_ctx == NULL) {
         logger_error("Failed to create client context");
         #ifndef TESTING
+        #if CLIENT_FEATURE_LED
         led_controller_deinit();
+        #endif
         hal_cleanup();
         #endif
         return -1;
@@ -275,49 +649,66 @@ static int initialize_system(const client_config_t *config,
         client_sm_destroy(g_client_ctx);
         g_client_ctx = NULL;
         #ifndef TESTING
+        #if CLIENT_FEATURE_LED
         led_controller_deinit();
+        #endif
         hal_cleanup();
         #endif
         return -1;
     }
     logger_info("State machine initialized");
+    #if CLIENT_FEATURE_BUTTON
+    logger_info("Button handler initialized (pin:%d, debounce:%dms)",
+                config->button_pin, config->button_debounce_ms);
+    #endif
+    #if CLIENT_FEATURE_VPN
+    logger_info("VPN controller initialized (socket:%s)", config->vpn_socket_path);
+    #endif
     
     // 6. Set callbacks
     client_sm_set_state_callback(g_client_ctx, on_state_change, NULL);
     client_sm_set_error_callback(g_client_ctx, on_error, NULL);
     
-    // 7. Initialize button handler
-    result = button_handler_init(config->button_pin, config->button_debounce_ms);
-    if (result != 0) {
-        logger_error("Failed to initialize button handler");
-        client_sm_destroy(g_client_ctx);
-        g_client_ctx = NULL;
-        #ifndef TESTING
-        led_controller_deinit();
-        hal_cleanup();
-        #endif
-        return -1;
+    // 7. Configure WebSocket client (initialized by the state machine)
+    ws_client_set_scheduling(config->ws_weighted_scheduling ? WS_SCHED_WEIGHTED : WS_SCHED_STRICT,
+                             NULL);
+    ws_client_set_batching(config->ws_batching);
+    logger_info("WebSocket client configured (server:%s:%d, %s scheduling)",
+                config->ws_server_host, config->ws_server_port,
+                config->ws_weighted_scheduling ? "weighted" : "strict");
+    
+    // 8. Start local control interface
+    if (config->control_socket_path[0] != '\0') {
+        if (control_server_init(config->control_socket_path, write_status_snapshot, NULL) == 0) {
+            control_server_set_press_handler(press_from_control, NULL);
+        } else {
+            logger_warning("Control interface unavailable (%s)", config->control_socket_path);
+            // Not fatal - only local tools lose live updates
+        }
     }
-    logger_info("Button handler initialized (pin:%d, debounce:%dms)",
-                config->button_pin, config->button_debounce_ms);
     
-    // 8. Initialize VPN controller
-    result = vpn_controller_init(config->vpn_socket_path);
-    if (result != 0) {
-        logger_warning("Failed to initialize VPN controller (will retry later)");
-        // Not fatal - VPN might not be running yet
-    } else {
-        logger_info("VPN controller initialized (socket:%s)", config->vpn_socket_path);
+    // 9. Serve cached status to the LAN
+    if (config->lan_status_port > 0 &&
+        lan_status_server_init(config->lan_status_bind, config->lan_status_port) != 0) {
+        logger_warning("LAN status endpoint unavailable (port %d)", config->lan_status_port);
+        // Not fatal - LAN clients fall back to the gaming-server
     }
     
-    // 9. Initialize WebSocket client
-    result = ws_client_init(config->ws_server_host, config->ws_server_port);
-    if (result != 0) {
-        logger_warning("Failed to initialize WebSocket client (will retry later)");
-        // Not fatal - server might not be running yet
-    } else {
-        logger_info("WebSocket client initialized (server:%s:%d)",
-                    config->ws_server_host, config->ws_server_port);
+    // 10. Load learned usage (a new device starts empty)
+    usage_predictor_init(&g_usage);
+    strncpy(g_usage_path, config->usage_profile_path, sizeof(g_usage_path) - 1);
+    g_prewarm_lead_ms = config->prewarm_lead_ms;
+    if (g_usage_path[0] != '\0' && usage_predictor_load(&g_usage, g_usage_path) == 0) {
+        logger_info("Usage profile loaded (%u presses)", g_usage.total);
+    }
+    
+    // 11. Load best servers of known networks
+    path_cache_init(&g_paths);
+    strncpy(g_paths_path, config->path_cache_path, sizeof(g_paths_path) - 1);
+    strncpy(g_configured_host, config->ws_server_host, sizeof(g_configured_host) - 1);
+    g_configured_port = config->ws_server_port;
+    if (g_paths_path[0] != '\0' && path_cache_load(&g_paths, g_paths_path) == 0) {
+        logger_info("Path cache loaded (%s)", g_paths_path);
     }
     
     logger_info("=== System initialization complete ===");
@@ -331,16 +722,92 @@ static int initialize_system(const client_config_t *config,
 static void cleanup_system(void) {
     logger_info("=== Gaming Client Shutting Down ===");
     
-    // Cleanup in reverse order
-    ws_client_cleanup();
-    logger_info("WebSocket client cleaned up");
+    // Report press budget overruns per phase
+    press_budget_stats_t bs;
+    if (g_client_ctx && client_sm_get_budget_stats(g_client_ctx, &bs) == 0 && bs.presses > 0) {
+        logger_info("Press budget: %u presses, %u exhausted, %u cached fallbacks",
+                    bs.presses, bs.exhausted, bs.cached_fallbacks);
+        for (int i = 0; i < PRESS_PHASE_COUNT; i++) {
+            logger_info("Press phase %s: %u overruns, max %u ms",
+                        press_budget_phase_to_string((press_phase_t)i),
+                        bs.overruns[i], bs.max_phase_ms[i]);
+        }
+    }
     
-    vpn_controller_cleanup();
-    logger_info("VPN controller cleaned up");
+    // Report outbound queue metrics before they are reset
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        ws_queue_stats_t qs;
+        if (ws_client_get_queue_stats((ws_priority_t)i, &qs) == 0 && qs.enqueued > 0) {
+            logger_info("WS queue %s: sent %u (%u batched), dropped %u, max depth %u, "
+                        "wait avg %u ms / max %u ms",
+                        ws_client_priority_to_string((ws_priority_t)i),
+                        qs.sent, qs.batched, qs.dropped, qs.max_depth,
+                        qs.sent > 0 ? qs.total_wait_ms / qs.sent : 0, qs.max_wait_ms);
+        }
+    }
     
-    button_handler_cleanup();
-    logger_info("Button handler cleaned up");
+    // Report load-shedding requests from the server
+    ws_hint_state_t hs;
+    if (ws_client_get_hint_state(&hs) == 0 && hs.hints_received > 0) {
+        logger_info("WS server hints: %u received, %u redirects", hs.hints_received, hs.redirects);
+    }
     
+    // Report what idle release saved and what cold presses paid for it
+    client_idle_stats_t is;
+    if (g_client_ctx && client_sm_get_idle_stats(g_client_ctx, &is) == 0 && is.releases > 0) {
+        logger_info("Idle release: %u releases, max %u KB freed, restore max %u ms, "
+                    "connect avg %u ms cold (%u) / %u ms warm (%u)",
+                    is.releases, is.max_saved_kb, is.max_restore_ms,
+                    is.cold_connects > 0 ? is.cold_connect_ms_total / is.cold_connects : 0,
+                    is.cold_connects,
+                    is.warm_connects > 0 ? is.warm_connect_ms_total / is.warm_connects : 0,
+                    is.warm_connects);
+    }
+    
+    // Report failure causes, most time lost first
+    failure_stats_t fs;
+    if (g_client_ctx && client_sm_get_failure_stats(g_client_ctx, &fs) == 0 && fs.log_count > 0) {
+        failure_cause_t ranked[FAILURE_CAUSE_COUNT];
+        int count = failure_stats_rank(&fs, ranked, FAILURE_CAUSE_COUNT);
+        for (int i = 0; i < count; i++) {
+            const failure_cause_stats_t *c = &fs.causes[ranked[i]];
+            logger_info("Failures %s: %u (%u outages, %u recovered), "
+                        "time to recover avg %u ms / max %u ms",
+                        failure_cause_to_string(ranked[i]), c->count, c->outages, c->recovered,
+                        c->recovered > 0 ? c->ttr_total_ms / c->recovered : 0, c->ttr_max_ms);
+        }
+    }
+    
+    // Report pre-warm effectiveness and keep what was learned
+    client_stats_t cs;
+    if (g_client_ctx && client_sm_get_stats(g_client_ctx, &cs) == 0 && cs.prewarms > 0) {
+        logger_info("Pre-warm: %u started, %u used by a press, %u unused",
+                    cs.prewarms, cs.prewarm_hits, cs.prewarms_unused);
+    }
+    if (g_usage_path[0] != '\0' && g_usage.dirty &&
+        usage_predictor_save(&g_usage, g_usage_path) != 0) {
+        logger_warning("Failed to save usage profile %s", g_usage_path);
+    }
+    if (g_paths_path[0] != '\0' && g_paths.dirty &&
+        path_cache_save(&g_paths, g_paths_path) != 0) {
+        logger_warning("Failed to save path cache %s", g_paths_path);
+    }
+    
+    // Report LAN offload
+    lan_status_stats_t ls;
+    if (lan_status_server_get_stats(&ls) == 0 && (ls.status_requests > 0 || ls.event_streams > 0)) {
+        logger_info("LAN status: %u requests, %u streams (peak %u subscribers), "
+                    "%u updates pushed, %u coalesced, %u slow drops",
+                    ls.status_requests, ls.event_streams, ls.peak_subscribers,
+                    ls.updates_pushed, ls.updates_coalesced, ls.slow_drops);
+    }
+    
+    // Cleanup in reverse order
+    lan_status_server_cleanup();
+    
+    control_server_cleanup();
+    
+    // The state machine releases the button, VPN and WebSocket modules
     if (g_client_ctx) {
         client_sm_destroy(g_client_ctx);
         g_client_ctx = NULL;
@@ -348,8 +815,10 @@ static void cleanup_system(void) {
     }
     
     #ifndef TESTING
+    #if CLIENT_FEATURE_LED
     led_controller_deinit();
     logger_info("LED controller cleaned up");
+    #endif
     
     hal_cleanup();
     logger_info("HAL cleaned up");
@@ -369,16 +838,21 @@ static void run_main_loop(void) {
     logger_info("Entering main event loop");
     
     while (g_running) {
-        // Update state machine
+        // Update state machine (also runs the button and WebSocket services)
         if (g_client_ctx) {
             client_sm_update(g_client_ctx);
         }
         
-        // Process button events
-        button_handler_process();
+        // Pre-warm ahead of likely presses
+        update_usage_prediction();
+        
+        // Use the best-known server of the current network
+        update_network_path();
         
-        // Service WebSocket
-        ws_client_service(10);  // 10ms timeout
+        // Serve local control clients
+        publish_control_updates();
+        control_server_process();
+        lan_status_server_process();
         
         // Small delay to prevent CPU hogging
         usleep(10000);  // 10ms
@@ -0,0 +1,298 @@
+/**
+ * @file path_cache.c
+ * @brief Path Cache Implementation
+ *
+ * Cache arithmetic is pure; only path_cache_probe() reads the kernel
+ * tables, and the caller decides when.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#include "path_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+#define PATH_CACHE_MAGIC        "GCPC"
+#define PATH_CACHE_VERSION      1
+
+/** RTF_GATEWAY of the route table flags */
+#define PATH_ROUTE_GATEWAY      0x2
+
+/**
+ * @brief Cache file header, followed by the entries
+ */
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t entries;
+    uint16_t host_max;
+    uint32_t clock;
+} path_cache_header_t;
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief FNV-1a over a string, continuing from hash
+ */
+static uint32_t hash_string(uint32_t hash, const char *text) {
+    for (; *text != '\0'; text++) {
+        hash ^= (uint8_t)*text;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Find the interface and gateway of the default route
+ *
+ * @return 0 on success, -1 if there is none
+ */
+static int read_default_route(const char *route_path, char *iface, size_t iface_size,
+                              uint32_t *gateway) {
+    char line[256];
+    int found = -1;
+
+    FILE *file = fopen(route_path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    while (found < 0 && fgets(line, sizeof(line), file) != NULL) {
+        char name[32];
+        unsigned int destination, via, flags, mask;
+        int refcnt, use, metric;
+
+        // Header line and partial routes fail the scan or the checks
+        if (sscanf(line, "%31s %x %x %x %d %d %d %x", name, &destination, &via, &flags,
+                   &refcnt, &use, &metric, &mask) != 8) {
+            continue;
+        }
+        if (destination != 0 || mask != 0 || !(flags & PATH_ROUTE_GATEWAY)) {
+            continue;
+        }
+
+        snprintf(iface, iface_size, "%s", name);
+        *gateway = via;
+        found = 0;
+    }
+
+    fclose(file);
+    return found;
+}
+
+/**
+ * @brief Find the MAC of a neighbour on an interface
+ *
+ * @return 0 on success, -1 if it has not been resolved
+ */
+static int read_neighbour_mac(const char *arp_path, const char *iface, const char *address,
+                              char *mac, size_t mac_size) {
+    char line[256];
+    int found = -1;
+
+    FILE *file = fopen(arp_path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    while (found < 0 && fgets(line, sizeof(line), file) != NULL) {
+        char ip[48], hw[32], device[32];
+        unsigned int type, flags;
+
+        if (sscanf(line, "%47s %x %x %31s %*s %31s", ip, &type, &flags, hw, device) != 5) {
+            continue;
+        }
+        // Flags 0 is an incomplete entry
+        if (flags == 0 || strcmp(ip, address) != 0 || strcmp(device, iface) != 0) {
+            continue;
+        }
+
+        snprintf(mac, mac_size, "%s", hw);
+        found = 0;
+    }
+
+    fclose(file);
+    return found;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void path_cache_init(path_cache_t *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+}
+
+int path_cache_probe(const char *route_path, const char *arp_path, uint32_t *fingerprint) {
+    char iface[32];
+    char address[16];
+    char mac[32];
+    uint32_t gateway;
+
+    if (route_path == NULL || arp_path == NULL || fingerprint == NULL) {
+        return -1;
+    }
+
+    if (read_default_route(route_path, iface, sizeof(iface), &gateway) < 0) {
+        return -1;
+    }
+
+    // The table holds the address in network byte order, printed as a host integer
+    const uint8_t *octets = (const uint8_t *)&gateway;
+    snprintf(address, sizeof(address), "%u.%u.%u.%u",
+             octets[0], octets[1], octets[2], octets[3]);
+
+    if (read_neighbour_mac(arp_path, iface, address, mac, sizeof(mac)) < 0) {
+        return -1;
+    }
+
+    uint32_t hash = hash_string(2166136261u, iface);
+    hash = hash_string(hash ^ '/', mac);
+    *fingerprint = (hash != 0) ? hash : 1;
+    return 0;
+}
+
+const path_cache_entry_t* path_cache_lookup(const path_cache_t *cache, uint32_t fingerprint) {
+    if (cache == NULL || fingerprint == 0) {
+        return NULL;
+    }
+
+    for (int i = 0; i < PATH_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].fingerprint == fingerprint) {
+            return &cache->entries[i];
+        }
+    }
+    return NULL;
+}
+
+int path_cache_record(path_cache_t *cache, uint32_t fingerprint, const char *host, int port,
+                      uint32_t rtt_ms) {
+    if (cache == NULL || fingerprint == 0 || host == NULL || host[0] == '\0' ||
+        port <= 0 || port > 65535 || strlen(host) >= PATH_CACHE_HOST_MAX) {
+        return -1;
+    }
+
+    if (rtt_ms > UINT16_MAX) {
+        rtt_ms = UINT16_MAX;
+    }
+
+    // The network's own slot, else a free one, else the least recently used
+    path_cache_entry_t *entry = &cache->entries[0];
+    for (int i = 0; i < PATH_CACHE_ENTRIES; i++) {
+        path_cache_entry_t *candidate = &cache->entries[i];
+        if (candidate->fingerprint == fingerprint) {
+            entry = candidate;
+            break;
+        }
+        if (entry->fingerprint != 0 &&
+            (candidate->fingerprint == 0 || candidate->last_used < entry->last_used)) {
+            entry = candidate;
+        }
+    }
+
+    if (entry->fingerprint != fingerprint) {
+        memset(entry, 0, sizeof(*entry));
+        entry->fingerprint = fingerprint;
+    }
+
+    if (entry->presses == 0 || entry->port != port || strcmp(entry->host, host) != 0) {
+        snprintf(entry->host, sizeof(entry->host), "%s", host);
+        entry->port = (uint16_t)port;
+        entry->rtt_ms = (uint16_t)rtt_ms;
+    } else {
+        int32_t delta = (int32_t)rtt_ms - (int32_t)entry->rtt_ms;
+        entry->rtt_ms = (uint16_t)((int32_t)entry->rtt_ms + delta / PATH_CACHE_RTT_SMOOTHING);
+    }
+
+    entry->presses++;
+    entry->last_used = ++cache->clock;
+    cache->dirty = true;
+    return 0;
+}
+
+int path_cache_load(path_cache_t *cache, const char *path) {
+    path_cache_header_t header;
+
+    if (cache == NULL || path == NULL) {
+        return -1;
+    }
+
+    path_cache_init(cache);
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, PATH_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == PATH_CACHE_VERSION &&
+                 header.entries == PATH_CACHE_ENTRIES &&
+                 header.host_max == PATH_CACHE_HOST_MAX &&
+                 fread(cache->entries, sizeof(cache->entries), 1, file) == 1;
+    fclose(file);
+
+    for (int i = 0; valid && i < PATH_CACHE_ENTRIES; i++) {
+        const path_cache_entry_t *entry = &cache->entries[i];
+        if (entry->fingerprint != 0 &&
+            (memchr(entry->host, '\0', sizeof(entry->host)) == NULL || entry->port == 0)) {
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        path_cache_init(cache);
+        return -1;
+    }
+
+    cache->clock = header.clock;
+    return 0;
+}
+
+int path_cache_save(path_cache_t *cache, const char *path) {
+    path_cache_header_t header;
+    char tmp_path[256];
+
+    if (cache == NULL || path == NULL) {
+        return -1;
+    }
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PATH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = PATH_CACHE_VERSION;
+    header.entries = PATH_CACHE_ENTRIES;
+    header.host_max = PATH_CACHE_HOST_MAX;
+    header.clock = cache->clock;
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(cache->entries, sizeof(cache->entries), 1, file) == 1;
+    if (fclose(file) != 0 || !written || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+
+    cache->dirty = false;
+    return 0;
+}
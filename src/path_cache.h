@@ -0,0 +1,160 @@
+/**
+ * @file path_cache.h
+ * @brief Path Cache - best-known server per network
+ *
+ * A travel router keeps coming back to the same few networks. The cache
+ * remembers, per network, which server answered a press first and how
+ * long its replies take, so the first press on a known network goes to
+ * the winning server straight away instead of rediscovering it.
+ * Features include:
+ * - Networks told apart by uplink interface and gateway MAC
+ * - Smoothed reply latency of the winning server
+ * - Least recently used eviction, persisted as a small profile
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup PathCache Path Cache
+ * @brief Per-network server choice and latency
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Networks remembered */
+#define PATH_CACHE_ENTRIES              8
+
+/** Longest server host that can be cached, including the terminator */
+#define PATH_CACHE_HOST_MAX             64
+
+/** Weight of a new latency sample is 1/PATH_CACHE_RTT_SMOOTHING */
+#define PATH_CACHE_RTT_SMOOTHING        4
+
+/** Default cache location, kept across reboots */
+#define PATH_CACHE_DEFAULT_PATH         "/etc/gaming-client.paths"
+
+/** Kernel tables the network fingerprint is read from */
+#define PATH_CACHE_ROUTE_TABLE          "/proc/net/route"
+#define PATH_CACHE_ARP_TABLE            "/proc/net/arp"
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief What is known about one network
+ */
+typedef struct {
+    uint32_t fingerprint;               /**< Network, 0 if the slot is free */
+    char host[PATH_CACHE_HOST_MAX];     /**< Server that answered first */
+    uint16_t port;                      /**< Its port */
+    uint16_t rtt_ms;                    /**< Smoothed query to reply latency */
+    uint32_t presses;                   /**< Answered presses on this network */
+    uint32_t last_used;                 /**< Cache clock of the last press */
+} path_cache_entry_t;
+
+/**
+ * @brief Path cache
+ */
+typedef struct {
+    path_cache_entry_t entries[PATH_CACHE_ENTRIES];
+    uint32_t clock;                     /**< Advances with every recorded press */
+    bool dirty;                         /**< Changed since last load or save */
+} path_cache_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize an empty cache
+ *
+ * @param cache Cache to initialize
+ */
+void path_cache_init(path_cache_t *cache);
+
+/**
+ * @brief Identify the network the router is attached to
+ *
+ * Takes the interface and gateway of the default route, then the
+ * gateway's MAC from the ARP table. Tunnels have neither a gateway nor
+ * an ARP entry, so a VPN coming up does not change the answer.
+ *
+ * @param route_path Route table, normally PATH_CACHE_ROUTE_TABLE
+ * @param arp_path ARP table, normally PATH_CACHE_ARP_TABLE
+ * @param fingerprint Network fingerprint, never 0
+ * @return 0 on success, -1 if there is no default route or its gateway
+ *         has not been resolved yet
+ */
+int path_cache_probe(const char *route_path, const char *arp_path, uint32_t *fingerprint);
+
+/**
+ * @brief Find what is known about a network
+ *
+ * @param cache Cache
+ * @param fingerprint Network fingerprint
+ * @return Entry, or NULL if the network is unknown
+ */
+const path_cache_entry_t* path_cache_lookup(const path_cache_t *cache, uint32_t fingerprint);
+
+/**
+ * @brief Record the server that answered a press first
+ *
+ * A different winner replaces the cached one along with its latency;
+ * the same winner folds the sample into the smoothed latency. An
+ * unknown network takes the least recently used slot.
+ *
+ * @param cache Cache
+ * @param fingerprint Network fingerprint
+ * @param host Server host
+ * @param port Server port
+ * @param rtt_ms Query to reply latency of this press
+ * @return 0 on success, -1 on invalid arguments or a host too long to cache
+ */
+int path_cache_record(path_cache_t *cache, uint32_t fingerprint, const char *host, int port,
+                      uint32_t rtt_ms);
+
+/**
+ * @brief Load a saved cache
+ *
+ * @param cache Cache, left empty on failure
+ * @param path Cache file
+ * @return 0 on success, -1 if missing or not a valid cache
+ */
+int path_cache_load(path_cache_t *cache, const char *path);
+
+/**
+ * @brief Save the cache
+ *
+ * Written to a temporary file and renamed, so a power cut keeps either
+ * the old or the new cache.
+ *
+ * @param cache Cache
+ * @param path Cache file
+ * @return 0 on success, -1 on failure
+ */
+int path_cache_save(path_cache_t *cache, const char *path);
+
+/** @} */ // end of PathCache group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PATH_CACHE_H */
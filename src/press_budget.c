@@ -0,0 +1,158 @@
+/**
+ * @file press_budget.c
+ * @brief Press Budget Implementation
+ * 
+ * Pure arithmetic on caller-supplied millisecond timestamps; the state
+ * machine owns the clock.
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#include "press_budget.h"
+
+#include <string.h>
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Time held back for the phases after the given one
+ */
+static uint32_t later_reserves(const press_budget_t *budget, press_phase_t phase) {
+    uint32_t reserve = 0;
+    
+    for (int i = (int)phase + 1; i < PRESS_PHASE_COUNT; i++) {
+        reserve += budget->reserve_ms[i];
+    }
+    
+    return reserve;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void press_budget_init(press_budget_t *budget, uint32_t total_ms) {
+    if (budget == NULL) {
+        return;
+    }
+    
+    memset(budget, 0, sizeof(*budget));
+    budget->total_ms = total_ms;
+    budget->phase = -1;
+    
+    for (int i = 0; i < PRESS_PHASE_COUNT; i++) {
+        budget->cap_ms[i] = UINT32_MAX;
+    }
+    budget->reserve_ms[PRESS_PHASE_WS] = PRESS_BUDGET_RESERVE_WS_MS;
+    budget->reserve_ms[PRESS_PHASE_QUERY] = PRESS_BUDGET_RESERVE_QUERY_MS;
+}
+
+int press_budget_set_phase(press_budget_t *budget, press_phase_t phase,
+                           uint32_t cap_ms, uint32_t reserve_ms) {
+    if (budget == NULL || phase < 0 || phase >= PRESS_PHASE_COUNT) {
+        return -1;
+    }
+    
+    budget->cap_ms[phase] = cap_ms;
+    budget->reserve_ms[phase] = reserve_ms;
+    return 0;
+}
+
+void press_budget_start(press_budget_t *budget, uint32_t now_ms) {
+    if (budget == NULL) {
+        return;
+    }
+    
+    budget->active = true;
+    budget->start_ms = now_ms;
+    budget->phase = -1;
+    budget->stats.presses++;
+}
+
+uint32_t press_budget_remaining(const press_budget_t *budget, uint32_t now_ms) {
+    if (budget == NULL || budget->total_ms == 0 || !budget->active) {
+        return UINT32_MAX;
+    }
+    
+    uint32_t elapsed = now_ms - budget->start_ms;
+    return (elapsed >= budget->total_ms) ? 0 : budget->total_ms - elapsed;
+}
+
+uint32_t press_budget_begin_phase(press_budget_t *budget, press_phase_t phase, uint32_t now_ms) {
+    if (budget == NULL || phase < 0 || phase >= PRESS_PHASE_COUNT) {
+        return 0;
+    }
+    
+    uint32_t allowance = budget->cap_ms[phase];
+    
+    if (budget->total_ms > 0 && budget->active) {
+        uint32_t remaining = press_budget_remaining(budget, now_ms);
+        uint32_t reserve = later_reserves(budget, phase);
+        uint32_t share = (remaining > reserve) ? remaining - reserve : 0;
+        
+        if (share < allowance) {
+            allowance = share;
+        }
+    }
+    
+    budget->phase = (int)phase;
+    budget->phase_start_ms = now_ms;
+    budget->phase_allowance_ms = allowance;
+    return allowance;
+}
+
+void press_budget_end_phase(press_budget_t *budget, uint32_t now_ms, bool overrun) {
+    if (budget == NULL || budget->phase < 0) {
+        return;
+    }
+    
+    int phase = budget->phase;
+    uint32_t elapsed = now_ms - budget->phase_start_ms;
+    
+    budget->stats.last_phase_ms[phase] = elapsed;
+    if (elapsed > budget->stats.max_phase_ms[phase]) {
+        budget->stats.max_phase_ms[phase] = elapsed;
+    }
+    if (overrun) {
+        budget->stats.overruns[phase]++;
+    }
+    
+    budget->phase = -1;
+}
+
+void press_budget_finish(press_budget_t *budget, bool exhausted, bool cached) {
+    if (budget == NULL || !budget->active) {
+        return;
+    }
+    
+    if (exhausted) {
+        budget->stats.exhausted++;
+    }
+    if (cached) {
+        budget->stats.cached_fallbacks++;
+    }
+    
+    budget->active = false;
+    budget->phase = -1;
+}
+
+bool press_budget_is_limited(const press_budget_t *budget) {
+    if (budget == NULL || budget->phase < 0) {
+        return false;
+    }
+    
+    return budget->phase_allowance_ms < budget->cap_ms[budget->phase];
+}
+
+const char* press_budget_phase_to_string(press_phase_t phase) {
+    switch (phase) {
+        case PRESS_PHASE_VPN:       return "VPN";
+        case PRESS_PHASE_WS:        return "WS";
+        case PRESS_PHASE_QUERY:     return "QUERY";
+        default:                    return "UNKNOWN";
+    }
+}
@@ -0,0 +1,184 @@
+/**
+ * @file press_budget.h
+ * @brief Press Budget - End-to-end deadline for one button press
+ * 
+ * A press has one total budget from button to LED. Each workflow phase
+ * gets what is left of it, minus reserves held back for the phases that
+ * still have to run, and never more than its own cap.
+ * Features include:
+ * - Per-phase allowance derived from the remaining budget
+ * - Per-phase overrun and duration statistics
+ * - Disabled mode (total of 0) that falls back to the phase caps
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef PRESS_BUDGET_H
+#define PRESS_BUDGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup PressBudget Press Budget
+ * @brief Deadline budget split across workflow phases
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Default total budget per press in milliseconds */
+#define PRESS_BUDGET_DEFAULT_MS         8000
+
+/** Default time held back for the WebSocket phase */
+#define PRESS_BUDGET_RESERVE_WS_MS      1500
+
+/** Default time held back for the PS5 query phase */
+#define PRESS_BUDGET_RESERVE_QUERY_MS   1000
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Budgeted workflow phases, in execution order
+ */
+typedef enum {
+    PRESS_PHASE_VPN = 0,            /**< VPN connect or resume */
+    PRESS_PHASE_WS,                 /**< WebSocket connect */
+    PRESS_PHASE_QUERY,              /**< PS5 status query */
+    PRESS_PHASE_COUNT,
+} press_phase_t;
+
+/**
+ * @brief Budget statistics
+ */
+typedef struct {
+    uint32_t presses;                           /**< Presses started */
+    uint32_t exhausted;                         /**< Presses that ran out of budget */
+    uint32_t cached_fallbacks;                  /**< Presses answered from the cached status */
+    uint32_t overruns[PRESS_PHASE_COUNT];       /**< Times each phase hit its allowance */
+    uint32_t last_phase_ms[PRESS_PHASE_COUNT];  /**< Duration of the last run of each phase */
+    uint32_t max_phase_ms[PRESS_PHASE_COUNT];   /**< Longest run of each phase */
+} press_budget_stats_t;
+
+/**
+ * @brief Press budget state
+ */
+typedef struct {
+    uint32_t total_ms;                          /**< Budget per press (0 = disabled) */
+    uint32_t cap_ms[PRESS_PHASE_COUNT];         /**< Ceiling for each phase */
+    uint32_t reserve_ms[PRESS_PHASE_COUNT];     /**< Held back for each phase while earlier ones run */
+    
+    bool active;                                /**< Press in progress */
+    uint32_t start_ms;                          /**< Press start time */
+    int phase;                                  /**< Running phase, -1 if none */
+    uint32_t phase_start_ms;                    /**< Running phase start time */
+    uint32_t phase_allowance_ms;                /**< Running phase allowance */
+    
+    press_budget_stats_t stats;
+} press_budget_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize a budget
+ * 
+ * Caps start unlimited and reserves at the defaults above.
+ * 
+ * @param budget Budget to initialize
+ * @param total_ms Budget per press in milliseconds (0 to disable)
+ */
+void press_budget_init(press_budget_t *budget, uint32_t total_ms);
+
+/**
+ * @brief Set cap and reserve of a phase
+ * 
+ * @param budget Budget
+ * @param phase Phase to configure
+ * @param cap_ms Longest the phase may run
+ * @param reserve_ms Time held back for this phase while earlier phases run
+ * @return 0 on success, negative on invalid phase
+ */
+int press_budget_set_phase(press_budget_t *budget, press_phase_t phase,
+                           uint32_t cap_ms, uint32_t reserve_ms);
+
+/**
+ * @brief Start the budget for a new press
+ * 
+ * @param budget Budget
+ * @param now_ms Current time in milliseconds
+ */
+void press_budget_start(press_budget_t *budget, uint32_t now_ms);
+
+/**
+ * @brief Enter a phase
+ * 
+ * @param budget Budget
+ * @param phase Phase being entered
+ * @param now_ms Current time in milliseconds
+ * @return Allowance for the phase in milliseconds; 0 if the budget is
+ *         already spent
+ */
+uint32_t press_budget_begin_phase(press_budget_t *budget, press_phase_t phase, uint32_t now_ms);
+
+/**
+ * @brief Leave the running phase
+ * 
+ * @param budget Budget
+ * @param now_ms Current time in milliseconds
+ * @param overrun true if the phase ran out of its allowance
+ */
+void press_budget_end_phase(press_budget_t *budget, uint32_t now_ms, bool overrun);
+
+/**
+ * @brief Finish the press
+ * 
+ * @param budget Budget
+ * @param exhausted true if the press failed on the budget
+ * @param cached true if the press was answered from a cached value
+ */
+void press_budget_finish(press_budget_t *budget, bool exhausted, bool cached);
+
+/**
+ * @brief Get remaining budget
+ * 
+ * @param budget Budget
+ * @param now_ms Current time in milliseconds
+ * @return Milliseconds left for this press (UINT32_MAX if disabled or idle)
+ */
+uint32_t press_budget_remaining(const press_budget_t *budget, uint32_t now_ms);
+
+/**
+ * @brief Check if the running phase allowance was cut by the budget
+ * 
+ * @param budget Budget
+ * @return true if the allowance is below the phase cap
+ */
+bool press_budget_is_limited(const press_budget_t *budget);
+
+/**
+ * @brief Get phase string
+ * 
+ * @param phase Phase
+ * @return Phase name
+ */
+const char* press_budget_phase_to_string(press_phase_t phase);
+
+/** @} */ // end of PressBudget group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRESS_BUDGET_H */
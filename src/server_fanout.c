@@ -0,0 +1,440 @@
+/**
+ * @file server_fanout.c
+ * @brief Server Fan-out Implementation
+ * 
+ * Each extra server has its own WebSocket session on the shared event
+ * loop. A query is sent to every server at once; replies, errors and
+ * deadlines fill in the status table independently, so one slow server
+ * never holds back the others.
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#include "server_fanout.h"
+
+#ifndef TESTING
+  #ifdef OPENWRT_BUILD
+    #include <gaming/logger.h>
+  #else
+    #include "../../gaming-core/src/logger.h"
+  #endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/time.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+/**
+ * @brief One extra server
+ */
+typedef struct {
+    fanout_entry_t entry;
+    ws_session_t *session;
+    bool query_sent;
+    uint32_t query_start_time;
+    uint32_t query_timeout;
+} fanout_server_t;
+
+/**
+ * @brief Fan-out context
+ */
+typedef struct {
+    bool initialized;
+    fanout_server_t servers[FANOUT_MAX_SERVERS];
+    int server_count;
+    
+    fanout_parse_fn parse;
+    fanout_result_callback_t on_result;
+    void *user_data;
+} fanout_ctx_t;
+
+/* ============================================================
+ *  Global Variables
+ * ============================================================ */
+
+static fanout_ctx_t g_fanout_ctx = {
+    .initialized = false,
+};
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+/**
+ * @brief Get current time in milliseconds
+ */
+static uint32_t get_current_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+/**
+ * @brief Record the result of a pending query and report it
+ */
+static void finish_query(fanout_server_t *server, fanout_result_t result, int status) {
+    fanout_entry_t *entry = &server->entry;
+    
+    if (entry->result != FANOUT_RESULT_PENDING) {
+        return;
+    }
+    
+    entry->result = result;
+    entry->status = status;
+    entry->latency_ms = get_current_time_ms() - server->query_start_time;
+    server->query_sent = false;
+    
+    switch (result) {
+        case FANOUT_RESULT_OK:      entry->replies++;   break;
+        case FANOUT_RESULT_TIMEOUT: entry->timeouts++;  break;
+        case FANOUT_RESULT_ERROR:   entry->errors++;    break;
+        default:                                        break;
+    }
+    
+    #ifndef TESTING
+    logger_info("Fan-out %s:%d: %s in %u ms", entry->host, entry->port,
+             server_fanout_result_to_string(result), entry->latency_ms);
+    #endif
+    
+    if (g_fanout_ctx.on_result != NULL) {
+        g_fanout_ctx.on_result((int)(server - g_fanout_ctx.servers), entry,
+                               g_fanout_ctx.user_data);
+    }
+}
+
+/**
+ * @brief Send the query of a pending server
+ */
+static void send_query(fanout_server_t *server) {
+    if (ws_session_query_ps5_status(server->session) == 0) {
+        server->query_sent = true;
+    } else {
+        finish_query(server, FANOUT_RESULT_ERROR, -1);
+    }
+}
+
+static void on_session_connected(void *user_data) {
+    fanout_server_t *server = (fanout_server_t *)user_data;
+    
+    if (server->entry.result == FANOUT_RESULT_PENDING && !server->query_sent) {
+        send_query(server);
+    }
+}
+
+static void on_session_disconnected(const char *reason, void *user_data) {
+    fanout_server_t *server = (fanout_server_t *)user_data;
+    
+    // Only a query already on the wire is lost; one still waiting for
+    // the connection keeps its deadline
+    if (server->query_sent) {
+        finish_query(server, FANOUT_RESULT_ERROR, -1);
+    }
+}
+
+static void on_session_message(const char *message, size_t length, void *user_data) {
+    fanout_server_t *server = (fanout_server_t *)user_data;
+    int status = g_fanout_ctx.parse(message, length);
+    
+    if (status >= 0) {
+        finish_query(server, FANOUT_RESULT_OK, status);
+    }
+}
+
+static void on_session_error(ws_error_t error, const char *message, void *user_data) {
+    fanout_server_t *server = (fanout_server_t *)user_data;
+    
+    finish_query(server, FANOUT_RESULT_ERROR, -1);
+}
+
+static void on_session_redirect(const char *host, int port, void *user_data) {
+    fanout_server_t *server = (fanout_server_t *)user_data;
+    
+    if (strlen(host) >= sizeof(server->entry.host)) {
+        return;
+    }
+    
+    // Keep the table on the server the session talks to; the next
+    // connect_all reconnects it there
+    ws_session_disconnect(server->session);
+    if (ws_session_set_server(server->session, host, port) == 0) {
+        strcpy(server->entry.host, host);
+        server->entry.port = port;
+    }
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+int server_fanout_init(fanout_parse_fn parse, fanout_result_callback_t on_result,
+                       void *user_data) {
+    if (g_fanout_ctx.initialized) {
+        return -1;  // Already initialized
+    }
+    
+    if (parse == NULL) {
+        return -1;
+    }
+    
+    memset(&g_fanout_ctx, 0, sizeof(g_fanout_ctx));
+    g_fanout_ctx.parse = parse;
+    g_fanout_ctx.on_result = on_result;
+    g_fanout_ctx.user_data = user_data;
+    g_fanout_ctx.initialized = true;
+    
+    return 0;
+}
+
+int server_fanout_add_server(const char *host, int port) {
+    if (!g_fanout_ctx.initialized || host == NULL || host[0] == '\0') {
+        return -1;
+    }
+    
+    if (port <= 0 || port > 65535) {
+        return -1;
+    }
+    
+    if (g_fanout_ctx.server_count >= FANOUT_MAX_SERVERS) {
+        return -1;  // Table full
+    }
+    
+    int index = g_fanout_ctx.server_count;
+    fanout_server_t *server = &g_fanout_ctx.servers[index];
+    
+    memset(server, 0, sizeof(*server));
+    strncpy(server->entry.host, host, sizeof(server->entry.host) - 1);
+    server->entry.port = port;
+    server->entry.status = -1;
+    g_fanout_ctx.server_count++;
+    
+    #ifndef TESTING
+    logger_info("Fan-out server added: %s:%d", host, port);
+    #endif
+    
+    return index;
+}
+
+int server_fanout_add_servers(const char *list) {
+    if (list == NULL) {
+        return -1;
+    }
+    
+    int added = 0;
+    const char *p = list;
+    
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        
+        const char *start = p;
+        while (*p != '\0' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        
+        char host[256];
+        size_t length = (size_t)(p - start);
+        if (length >= sizeof(host)) {
+            return -1;
+        }
+        memcpy(host, start, length);
+        host[length] = '\0';
+        
+        int port = WS_DEFAULT_SERVER_PORT;
+        char *colon = strrchr(host, ':');
+        if (colon != NULL) {
+            char *end;
+            long value = strtol(colon + 1, &end, 10);
+            if (*end != '\0' || end == colon + 1) {
+                return -1;
+            }
+            port = (int)value;
+            *colon = '\0';
+        }
+        
+        if (server_fanout_add_server(host, port) < 0) {
+            return -1;
+        }
+        added++;
+    }
+    
+    return added;
+}
+
+int server_fanout_set_server(int index, const char *host, int port) {
+    if (index < 0 || index >= g_fanout_ctx.server_count || host == NULL || host[0] == '\0' ||
+        strlen(host) >= sizeof(g_fanout_ctx.servers[0].entry.host) ||
+        port <= 0 || port > 65535) {
+        return -1;
+    }
+    
+    fanout_server_t *server = &g_fanout_ctx.servers[index];
+    
+    if (server->entry.result == FANOUT_RESULT_PENDING) {
+        return -1;
+    }
+    
+    ws_session_close(server->session);
+    memset(server, 0, sizeof(*server));
+    strcpy(server->entry.host, host);
+    server->entry.port = port;
+    server->entry.status = -1;
+    
+    #ifndef TESTING
+    logger_info("Fan-out server %d replaced by %s:%d", index, host, port);
+    #endif
+    
+    return 0;
+}
+
+int server_fanout_get_count(void) {
+    return g_fanout_ctx.server_count;
+}
+
+int server_fanout_connect_all(void) {
+    int result = 0;
+    
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        fanout_server_t *server = &g_fanout_ctx.servers[i];
+        
+        if (server->session == NULL) {
+            server->session = ws_session_open(server->entry.host, server->entry.port);
+            if (server->session == NULL) {
+                result = -1;
+                continue;
+            }
+            ws_session_set_callbacks(server->session, on_session_connected,
+                                     on_session_disconnected, on_session_message,
+                                     on_session_error, server);
+            ws_session_set_redirect_callback(server->session, on_session_redirect, server);
+        }
+        
+        ws_state_t state = ws_session_get_state(server->session);
+        if (state != WS_STATE_CONNECTED && state != WS_STATE_CONNECTING) {
+            ws_session_connect(server->session);
+        }
+    }
+    
+    return result;
+}
+
+int server_fanout_query_all(uint32_t timeout_ms) {
+    uint32_t now = get_current_time_ms();
+    int queried = 0;
+    
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        fanout_server_t *server = &g_fanout_ctx.servers[i];
+        
+        server->entry.result = FANOUT_RESULT_PENDING;
+        server->query_sent = false;
+        server->query_start_time = now;
+        server->query_timeout = timeout_ms;
+        queried++;
+        
+        if (server->session == NULL) {
+            finish_query(server, FANOUT_RESULT_ERROR, -1);
+        } else if (ws_session_get_state(server->session) == WS_STATE_CONNECTED) {
+            send_query(server);
+        }
+        // Otherwise the connected callback sends it
+    }
+    
+    return queried;
+}
+
+void server_fanout_process(void) {
+    uint32_t now = get_current_time_ms();
+    
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        fanout_server_t *server = &g_fanout_ctx.servers[i];
+        
+        if (server->entry.result == FANOUT_RESULT_PENDING &&
+            now - server->query_start_time >= server->query_timeout) {
+            finish_query(server, FANOUT_RESULT_TIMEOUT, -1);
+        }
+    }
+}
+
+bool server_fanout_is_complete(void) {
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        if (g_fanout_ctx.servers[i].entry.result == FANOUT_RESULT_PENDING) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int server_fanout_get_results(fanout_entry_t *entries, int max_entries) {
+    if (entries == NULL || max_entries <= 0) {
+        return 0;
+    }
+    
+    int count = g_fanout_ctx.server_count;
+    if (count > max_entries) {
+        count = max_entries;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        entries[i] = g_fanout_ctx.servers[i].entry;
+    }
+    
+    return count;
+}
+
+void server_fanout_disconnect_all(void) {
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        fanout_server_t *server = &g_fanout_ctx.servers[i];
+        
+        if (server->entry.result == FANOUT_RESULT_PENDING) {
+            server->entry.result = FANOUT_RESULT_IDLE;
+        }
+        server->query_sent = false;
+        
+        if (server->session != NULL) {
+            ws_session_disconnect(server->session);
+        }
+    }
+}
+
+void server_fanout_cleanup(void) {
+    if (!g_fanout_ctx.initialized) {
+        return;
+    }
+    
+    for (int i = 0; i < g_fanout_ctx.server_count; i++) {
+        ws_session_close(g_fanout_ctx.servers[i].session);
+    }
+    
+    memset(&g_fanout_ctx, 0, sizeof(g_fanout_ctx));
+}
+
+const char* server_fanout_result_to_string(fanout_result_t result) {
+    switch (result) {
+        case FANOUT_RESULT_IDLE:    return "IDLE";
+        case FANOUT_RESULT_PENDING: return "PENDING";
+        case FANOUT_RESULT_OK:      return "OK";
+        case FANOUT_RESULT_TIMEOUT: return "TIMEOUT";
+        case FANOUT_RESULT_ERROR:   return "ERROR";
+        default:                    return "UNKNOWN";
+    }
+}
+
+#ifdef TESTING
+ws_session_t* server_fanout_test_get_session(int index) {
+    if (index < 0 || index >= g_fanout_ctx.server_count) {
+        return NULL;
+    }
+    return g_fanout_ctx.servers[index].session;
+}
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @file server_fanout.h
+ * @brief Server Fan-out - PS5 queries to additional gaming-servers
+ * 
+ * Consoles can sit behind more than one gaming-server (for example home
+ * and a friend's place). This module keeps a WebSocket session to each
+ * extra server on the client's event loop, sends a press's query to all
+ * of them at once and collects the replies into one status table.
+ * Features include:
+ * - One WebSocket session per server, opened on first use
+ * - Parallel queries with a per-server deadline
+ * - Result table filled in as replies arrive
+ * - Per-reply callback so the caller never waits for the slowest server
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef SERVER_FANOUT_H
+#define SERVER_FANOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "websocket_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup ServerFanout Server Fan-out
+ * @brief Parallel queries to additional servers
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Maximum extra servers (the primary session takes one WebSocket slot) */
+#define FANOUT_MAX_SERVERS          (WS_MAX_SESSIONS - 1)
+
+/** Default per-server query deadline in milliseconds */
+#define FANOUT_QUERY_TIMEOUT_MS     3000
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Query result of one server
+ */
+typedef enum {
+    FANOUT_RESULT_IDLE = 0,         /**< No query in progress */
+    FANOUT_RESULT_PENDING,          /**< Query sent or waiting for the connection */
+    FANOUT_RESULT_OK,               /**< Reply received */
+    FANOUT_RESULT_TIMEOUT,          /**< No reply before the deadline */
+    FANOUT_RESULT_ERROR,            /**< Connection failed or dropped */
+} fanout_result_t;
+
+/**
+ * @brief Status table entry for one server
+ */
+typedef struct {
+    char host[256];                 /**< Server hostname or IP */
+    int port;                       /**< Server port */
+    fanout_result_t result;         /**< Result of the last query */
+    int status;                     /**< Parsed reply, valid when result is OK */
+    uint32_t latency_ms;            /**< Query to reply, timeout or error */
+    uint32_t replies;               /**< Replies received */
+    uint32_t timeouts;              /**< Queries that hit the deadline */
+    uint32_t errors;                /**< Queries lost to connection errors */
+} fanout_entry_t;
+
+/**
+ * @brief Reply parser
+ * 
+ * @param message Received message (not null-terminated)
+ * @param length Message length in bytes
+ * @return Parsed status, or negative if the message is not a status reply
+ */
+typedef int (*fanout_parse_fn)(const char *message, size_t length);
+
+/**
+ * @brief Result callback, called once per server and query
+ * 
+ * @param index Server index
+ * @param entry Table entry of the server
+ * @param user_data User-provided data pointer
+ */
+typedef void (*fanout_result_callback_t)(int index, const fanout_entry_t *entry,
+                                         void *user_data);
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize fan-out
+ * 
+ * @param parse Reply parser
+ * @param on_result Result callback (can be NULL)
+ * @param user_data User data for the callback
+ * @return 0 on success, negative error code on failure
+ */
+int server_fanout_init(fanout_parse_fn parse, fanout_result_callback_t on_result,
+                       void *user_data);
+
+/**
+ * @brief Add a server
+ * 
+ * @param host Server hostname or IP address
+ * @param port Server port number
+ * @return Server index, or negative if the table is full or on invalid arguments
+ */
+int server_fanout_add_server(const char *host, int port);
+
+/**
+ * @brief Add servers from a list
+ * 
+ * @param list Space-separated "host:port" entries (port defaults to
+ *             WS_DEFAULT_SERVER_PORT)
+ * @return Number of servers added, or negative on a malformed entry
+ *         (entries before it have been added)
+ */
+int server_fanout_add_servers(const char *list);
+
+/**
+ * @brief Replace a server
+ * 
+ * Its session is closed and the table entry starts over; the next
+ * server_fanout_connect_all() opens a session to the new server.
+ * 
+ * @param index Server index
+ * @param host Server hostname or IP address
+ * @param port Server port number
+ * @return 0 on success, -1 while a query is pending or on invalid arguments
+ */
+int server_fanout_set_server(int index, const char *host, int port);
+
+/**
+ * @brief Get number of servers
+ * 
+ * @return Number of servers added
+ */
+int server_fanout_get_count(void);
+
+/**
+ * @brief Connect all servers (non-blocking)
+ * 
+ * Sessions that are connected or connecting are left as they are.
+ * 
+ * @return 0 on success, negative if a session could not be opened
+ */
+int server_fanout_connect_all(void);
+
+/**
+ * @brief Query all servers
+ * 
+ * Servers that are not connected yet get the query as soon as they are.
+ * Each server's deadline runs from this call.
+ * 
+ * @param timeout_ms Per-server deadline in milliseconds
+ * @return Number of servers queried
+ */
+int server_fanout_query_all(uint32_t timeout_ms);
+
+/**
+ * @brief Expire overdue queries
+ * 
+ * Should be called regularly from the main event loop, after
+ * ws_client_service().
+ */
+void server_fanout_process(void);
+
+/**
+ * @brief Check if every server has a result
+ * 
+ * @return true if no query is pending
+ */
+bool server_fanout_is_complete(void);
+
+/**
+ * @brief Get the status table
+ * 
+ * @param entries Output array
+ * @param max_entries Capacity of entries
+ * @return Number of entries written
+ */
+int server_fanout_get_results(fanout_entry_t *entries, int max_entries);
+
+/**
+ * @brief Disconnect all servers
+ * 
+ * Pending queries are abandoned without a result callback.
+ */
+void server_fanout_disconnect_all(void);
+
+/**
+ * @brief Clean up fan-out
+ * 
+ * Close all sessions and forget the servers.
+ */
+void server_fanout_cleanup(void);
+
+/**
+ * @brief Get result string
+ * 
+ * @param result Query result
+ * @return Result name
+ */
+const char* server_fanout_result_to_string(fanout_result_t result);
+
+#ifdef TESTING
+/**
+ * @brief Get a server's session (test builds only)
+ * 
+ * @param index Server index
+ * @return Session, or NULL if not open
+ */
+ws_session_t* server_fanout_test_get_session(int index);
+#endif
+
+/** @} */ // end of ServerFanout group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SERVER_FANOUT_H */
@@ -0,0 +1,188 @@
+/**
+ * @file usage_predictor.c
+ * @brief Usage Predictor Implementation
+ *
+ * Histogram arithmetic works on caller-supplied slots; only
+ * usage_predictor_slot() looks at the clock.
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+// POSIX headers for localtime_r
+#define _POSIX_C_SOURCE 200112L
+
+#include "usage_predictor.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+#define USAGE_PROFILE_MAGIC     "GCUP"
+#define USAGE_PROFILE_VERSION   1
+
+/**
+ * @brief Profile file header, followed by the slot counts
+ */
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t slot_minutes;
+    int16_t last_slot;
+} usage_profile_header_t;
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+static bool is_valid_slot(int slot) {
+    return slot >= 0 && slot < USAGE_SLOTS;
+}
+
+/**
+ * @brief Recompute the total after counts changed in bulk
+ */
+static void update_total(usage_predictor_t *predictor) {
+    predictor->total = 0;
+    for (int i = 0; i < USAGE_SLOTS; i++) {
+        predictor->total += predictor->counts[i];
+    }
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void usage_predictor_init(usage_predictor_t *predictor) {
+    if (predictor == NULL) {
+        return;
+    }
+
+    memset(predictor, 0, sizeof(*predictor));
+    predictor->last_slot = -1;
+}
+
+int usage_predictor_slot(time_t when) {
+    struct tm local;
+
+    if (localtime_r(&when, &local) == NULL) {
+        return 0;
+    }
+
+    int day = (local.tm_wday + 6) % 7;  // Monday first
+    int minute = local.tm_hour * 60 + local.tm_min;
+    return day * (USAGE_SLOTS / 7) + minute / USAGE_SLOT_MINUTES;
+}
+
+void usage_predictor_record(usage_predictor_t *predictor, int slot) {
+    if (predictor == NULL || !is_valid_slot(slot)) {
+        return;
+    }
+
+    if (predictor->counts[slot] == UINT8_MAX) {
+        for (int i = 0; i < USAGE_SLOTS; i++) {
+            predictor->counts[i] /= 2;
+        }
+        update_total(predictor);
+    }
+
+    predictor->counts[slot]++;
+    predictor->total++;
+    predictor->dirty = true;
+}
+
+void usage_predictor_tick(usage_predictor_t *predictor, int slot) {
+    if (predictor == NULL || !is_valid_slot(slot)) {
+        return;
+    }
+
+    if (predictor->last_slot >= 0 && slot < predictor->last_slot) {
+        for (int i = 0; i < USAGE_SLOTS; i++) {
+            // Round up, so small counts fade out too
+            predictor->counts[i] -= (predictor->counts[i] + 7) / 8;
+        }
+        update_total(predictor);
+        predictor->dirty = true;
+    }
+
+    predictor->last_slot = slot;
+}
+
+bool usage_predictor_is_likely(const usage_predictor_t *predictor, int slot) {
+    if (predictor == NULL || !is_valid_slot(slot)) {
+        return false;
+    }
+
+    uint32_t count = predictor->counts[slot];
+    return count >= USAGE_MIN_PRESSES &&
+           count * USAGE_SLOTS >= USAGE_LIKELY_FACTOR * predictor->total;
+}
+
+int usage_predictor_load(usage_predictor_t *predictor, const char *path) {
+    usage_profile_header_t header;
+
+    if (predictor == NULL || path == NULL) {
+        return -1;
+    }
+
+    usage_predictor_init(predictor);
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, USAGE_PROFILE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == USAGE_PROFILE_VERSION &&
+                 header.slot_minutes == USAGE_SLOT_MINUTES &&
+                 fread(predictor->counts, sizeof(predictor->counts), 1, file) == 1;
+    fclose(file);
+
+    if (!valid) {
+        usage_predictor_init(predictor);
+        return -1;
+    }
+
+    predictor->last_slot = is_valid_slot(header.last_slot) ? header.last_slot : -1;
+    update_total(predictor);
+    return 0;
+}
+
+int usage_predictor_save(usage_predictor_t *predictor, const char *path) {
+    usage_profile_header_t header;
+    char tmp_path[256];
+
+    if (predictor == NULL || path == NULL) {
+        return -1;
+    }
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, USAGE_PROFILE_MAGIC, sizeof(header.magic));
+    header.version = USAGE_PROFILE_VERSION;
+    header.slot_minutes = USAGE_SLOT_MINUTES;
+    header.last_slot = (int16_t)predictor->last_slot;
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(predictor->counts, sizeof(predictor->counts), 1, file) == 1;
+    if (fclose(file) != 0 || !written || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+
+    predictor->dirty = false;
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file usage_predictor.h
+ * @brief Usage Predictor - learned button usage by time of week
+ *
+ * Most devices are used at the same times every week. The predictor
+ * counts presses per half hour of the week and tells the client when a
+ * press is likely soon, so the VPN and WebSocket can be brought up ahead
+ * of it instead of being kept up all the time.
+ * Features include:
+ * - 7 x 48 histogram of one byte per slot, persisted as a small profile
+ * - Halving on saturation and weekly aging so patterns can move
+ * - Only slots well above the device's average count as likely use
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef USAGE_PREDICTOR_H
+#define USAGE_PREDICTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup UsagePredictor Usage Predictor
+ * @brief Time-of-week press histogram
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Length of one histogram slot */
+#define USAGE_SLOT_MINUTES              30
+
+/** Slots in one week */
+#define USAGE_SLOTS                     (7 * 24 * 60 / USAGE_SLOT_MINUTES)
+
+/** Presses a slot needs before it can count as likely use */
+#define USAGE_MIN_PRESSES               3
+
+/** A likely slot holds at least this many times the average slot */
+#define USAGE_LIKELY_FACTOR             4
+
+/** Default profile location, kept across reboots */
+#define USAGE_DEFAULT_PROFILE_PATH      "/etc/gaming-client.usage"
+
+/** Default time a pre-warm starts ahead of a likely slot */
+#define USAGE_DEFAULT_LEAD_S            300
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Usage histogram
+ */
+typedef struct {
+    uint8_t counts[USAGE_SLOTS];    /**< Presses per slot, Monday 00:00 first */
+    uint32_t total;                 /**< Sum of counts */
+    int last_slot;                  /**< Slot of the last tick, -1 if none */
+    bool dirty;                     /**< Changed since last load or save */
+} usage_predictor_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Initialize an empty histogram
+ *
+ * @param predictor Predictor to initialize
+ */
+void usage_predictor_init(usage_predictor_t *predictor);
+
+/**
+ * @brief Get the slot of a point in time
+ *
+ * @param when Wall-clock time, interpreted in local time
+ * @return Slot index in [0, USAGE_SLOTS)
+ */
+int usage_predictor_slot(time_t when);
+
+/**
+ * @brief Count a press
+ *
+ * When a slot saturates, all slots are halved.
+ *
+ * @param predictor Predictor
+ * @param slot Slot of the press
+ */
+void usage_predictor_record(usage_predictor_t *predictor, int slot);
+
+/**
+ * @brief Advance the clock of the histogram
+ *
+ * Ages all slots by one eighth, rounded up, each time the week wraps,
+ * so habits that stopped fade out.
+ *
+ * @param predictor Predictor
+ * @param slot Current slot
+ */
+void usage_predictor_tick(usage_predictor_t *predictor, int slot);
+
+/**
+ * @brief Check if a press is likely in a slot
+ *
+ * @param predictor Predictor
+ * @param slot Slot to check
+ * @return true if the slot is well above the average slot
+ */
+bool usage_predictor_is_likely(const usage_predictor_t *predictor, int slot);
+
+/**
+ * @brief Load a saved histogram
+ *
+ * @param predictor Predictor, left empty on failure
+ * @param path Profile file
+ * @return 0 on success, -1 if missing or not a valid profile
+ */
+int usage_predictor_load(usage_predictor_t *predictor, const char *path);
+
+/**
+ * @brief Save the histogram
+ *
+ * Written to a temporary file and renamed, so a power cut keeps either
+ * the old or the new profile.
+ *
+ * @param predictor Predictor
+ * @param path Profile file
+ * @return 0 on success, -1 on failure
+ */
+int usage_predictor_save(usage_predictor_t *predictor, const char *path);
+
+/** @} */ // end of UsagePredictor group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USAGE_PREDICTOR_H */
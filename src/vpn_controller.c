@@ -7,7 +7,9 @@
  * - Non-blocking socket communication
  * - Automatic retry with exponential backoff
  * - State management with callbacks
- * - Timeout detection
+ * - Timeout detection with per-stage connect deadlines
+ * - Session suspend/resume with fallback to full connect
+ * - Shared-memory state reads with eventfd doorbell
  * - JSON command/response handling
  * 
  * @author Gaming System Development Team
@@ -16,6 +18,7 @@
  */
 
 #include "vpn_controller.h"
+#include "vpn_shm.h"
 
 #ifndef TESTING
   #ifdef OPENWRT_BUILD
@@ -53,6 +56,16 @@ typedef struct {
     vpn_state_callback_t callback;
     void *user_data;
     
+    // Connect progress
+    vpn_progress_callback_t progress_callback;
+    void *progress_user_data;
+    vpn_connect_stage_t connect_stage;
+    uint32_t stage_start_time;
+    bool agent_reports_progress;
+    
+    // Why the last operation failed
+    vpn_error_t last_error;
+    
     // Connection info
     vpn_info_t info;
     
@@ -65,9 +78,22 @@ typedef struct {
     uint32_t operation_start_time;
     uint32_t operation_timeout;
     
+    // Suspended session
+    uint32_t suspend_linger_ms;
+    uint32_t suspend_time;
+    
     // Pending operation
     bool operation_pending;
     char pending_command[VPN_MAX_MESSAGE_SIZE];
+    
+    // Shared-memory state channel
+    const vpn_shm_region_t *shm;
+    uint32_t shm_sequence;
+    int doorbell_fd;
+    
+    // Partial line received from agent
+    char rx_buffer[VPN_MAX_MESSAGE_SIZE];
+    size_t rx_len;
 } vpn_controller_ctx_t;
 
 /* ============================================================
@@ -81,11 +107,22 @@ static vpn_controller_ctx_t g_vpn_ctx = {
     .previous_state = VPN_STATE_UNKNOWN,
     .callback = NULL,
     .user_data = NULL,
+    .progress_callback = NULL,
+    .progress_user_data = NULL,
+    .connect_stage = VPN_STAGE_NONE,
+    .last_error = VPN_ERROR_NONE,
     .retry_count = 0,
     .retry_interval = VPN_RETRY_INTERVAL_MS,
     .operation_pending = false,
+    .shm = NULL,
+    .doorbell_fd = -1,
 };
 
+#ifdef TESTING
+static vpn_test_send_fn g_test_send = NULL;
+static vpn_test_recv_fn g_test_recv = NULL;
+#endif
+
 /* ============================================================
  *  Internal Helper Functions
  * ============================================================ */
@@ -154,6 +191,7 @@ static int connect_to_agent(void) {
         #ifndef TESTING
         logger_error("Failed to connect to VPN agent: %s", g_vpn_ctx.socket_path);
         #endif
+        g_vpn_ctx.last_error = VPN_ERROR_AGENT_UNREACHABLE;
         return -1;
     }
     
@@ -178,18 +216,25 @@ static int send_command(const char *action) {
     
     // Build JSON command
     char command[VPN_MAX_MESSAGE_SIZE];
-    snprintf(command, sizeof(command), "{\"action\":\"%s\"}\n", action);
+    if (strcmp(action, "suspend") == 0) {
+        snprintf(command, sizeof(command), "{\"action\":\"%s\",\"linger_ms\":%u}\n",
+                 action, g_vpn_ctx.suspend_linger_ms);
+    } else {
+        snprintf(command, sizeof(command), "{\"action\":\"%s\"}\n", action);
+    }
     
     #ifndef TESTING
     ssize_t sent = socket_helper_send(g_vpn_ctx.sockfd, command, strlen(command));
     #else
-    ssize_t sent = strlen(command);  // Mock send
+    ssize_t sent = g_test_send ? g_test_send(command, strlen(command))
+                               : (ssize_t)strlen(command);  // Mock send
     #endif
     
     if (sent < 0) {
         #ifndef TESTING
         logger_error("Failed to send VPN command: %s", action);
         #endif
+        g_vpn_ctx.last_error = VPN_ERROR_SOCKET;
         return -1;
     }
     
@@ -211,10 +256,21 @@ static int receive_response(char *response, size_t max_len) {
     #ifndef TESTING
     ssize_t received = socket_helper_recv(g_vpn_ctx.sockfd, response, max_len - 1);
     #else
-    // Mock response in test mode
-    const char *mock_response = "{\"status\":\"ok\",\"state\":\"connected\"}\n";
-    strncpy(response, mock_response, max_len - 1);
-    ssize_t received = strlen(response);
+    ssize_t received;
+    if (g_test_recv != NULL) {
+        received = g_test_recv(response, max_len - 1);
+        if (received == 0) {
+            errno = EAGAIN;   // Nothing pending
+            received = -1;
+        } else if (received < 0) {
+            errno = EIO;
+        }
+    } else {
+        // Mock response in test mode
+        const char *mock_response = "{\"status\":\"ok\",\"state\":\"connected\"}\n";
+        strncpy(response, mock_response, max_len - 1);
+        received = strlen(response);
+    }
     #endif
     
     if (received < 0) {
@@ -259,6 +315,8 @@ static vpn_state_t parse_state_from_response(const char *response) {
         return VPN_STATE_DISCONNECTED;
     } else if (strstr(response, "\"state\":\"error\"")) {
         return VPN_STATE_ERROR;
+    } else if (strstr(response, "\"state\":\"suspended\"")) {
+        return VPN_STATE_SUSPENDED;
     }
     
     return VPN_STATE_UNKNOWN;
@@ -300,6 +358,339 @@ static void parse_info_from_response(const char *response, vpn_info_t *info) {
     info->state = parse_state_from_response(response);
 }
 
+/**
+ * @brief Parse connect progress stage from agent event
+ * 
+ * @return Reported stage, or VPN_STAGE_NONE if the line is not a progress event
+ */
+static vpn_connect_stage_t parse_stage_from_event(const char *line) {
+    if (!strstr(line, "\"event\":\"progress\"")) {
+        return VPN_STAGE_NONE;
+    }
+    
+    if (strstr(line, "\"stage\":\"resolving\"")) {
+        return VPN_STAGE_RESOLVING;
+    } else if (strstr(line, "\"stage\":\"handshaking\"")) {
+        return VPN_STAGE_HANDSHAKING;
+    } else if (strstr(line, "\"stage\":\"handshake_done\"")) {
+        return VPN_STAGE_HANDSHAKE_DONE;
+    } else if (strstr(line, "\"stage\":\"routes_installed\"")) {
+        return VPN_STAGE_ROUTES_INSTALLED;
+    }
+    
+    return VPN_STAGE_NONE;
+}
+
+/**
+ * @brief Deadline for the stage a connect is currently in
+ */
+static uint32_t stage_timeout_ms(vpn_connect_stage_t stage) {
+    switch (stage) {
+        case VPN_STAGE_NONE:             return VPN_STAGE_START_TIMEOUT_MS;
+        case VPN_STAGE_RESOLVING:        return VPN_STAGE_RESOLVE_TIMEOUT_MS;
+        case VPN_STAGE_HANDSHAKING:      return VPN_STAGE_HANDSHAKE_TIMEOUT_MS;
+        case VPN_STAGE_HANDSHAKE_DONE:   return VPN_STAGE_ROUTES_TIMEOUT_MS;
+        case VPN_STAGE_ROUTES_INSTALLED: return VPN_STAGE_FINALIZE_TIMEOUT_MS;
+        default:                         return VPN_CONNECT_TIMEOUT_MS;
+    }
+}
+
+/**
+ * @brief Enter a connect stage and notify the progress callback
+ */
+static void change_stage(vpn_connect_stage_t stage) {
+    g_vpn_ctx.connect_stage = stage;
+    g_vpn_ctx.stage_start_time = get_current_time_ms();
+    
+    if (stage == VPN_STAGE_NONE) {
+        return;
+    }
+    
+    #ifndef TESTING
+    logger_info("VPN connect progress: %s", vpn_controller_stage_to_string(stage));
+    #endif
+    
+    if (g_vpn_ctx.progress_callback != NULL) {
+        g_vpn_ctx.progress_callback(stage, g_vpn_ctx.progress_user_data);
+    }
+}
+
+/**
+ * @brief Check if the in-flight connect has exceeded its stage deadline
+ * 
+ * Agents that never sent a progress event only get the overall
+ * connect timeout, so older agents keep their previous behaviour.
+ */
+static bool is_stage_timeout(void) {
+    if (strcmp(g_vpn_ctx.pending_command, "connect") != 0) {
+        return false;
+    }
+    
+    if (!g_vpn_ctx.agent_reports_progress) {
+        return false;
+    }
+    
+    return is_timeout(g_vpn_ctx.stage_start_time, stage_timeout_ms(g_vpn_ctx.connect_stage));
+}
+
+/**
+ * @brief Get the error for a connect that ran out of time
+ */
+static vpn_error_t timeout_error_for_stage(vpn_connect_stage_t stage) {
+    switch (stage) {
+        case VPN_STAGE_RESOLVING:   return VPN_ERROR_RESOLVE_TIMEOUT;
+        case VPN_STAGE_HANDSHAKING: return VPN_ERROR_HANDSHAKE_TIMEOUT;
+        default:                    return VPN_ERROR_TIMEOUT;
+    }
+}
+
+/**
+ * @brief Abandon the pending operation
+ * 
+ * The error is stored before the state changes, so state callbacks can
+ * already ask for it.
+ */
+static void fail_operation(vpn_error_t error) {
+    g_vpn_ctx.last_error = error;
+    change_state(VPN_STATE_ERROR);
+    change_stage(VPN_STAGE_NONE);
+    g_vpn_ctx.operation_pending = false;
+}
+
+/**
+ * @brief Send a command and track it as the pending operation
+ */
+static int start_operation(const char *action, vpn_state_t state, uint32_t timeout_ms) {
+    if (send_command(action) < 0) {
+        change_state(VPN_STATE_ERROR);
+        return -1;
+    }
+    
+    g_vpn_ctx.last_error = VPN_ERROR_NONE;
+    change_state(state);
+    
+    g_vpn_ctx.operation_start_time = get_current_time_ms();
+    g_vpn_ctx.operation_timeout = timeout_ms;
+    g_vpn_ctx.operation_pending = true;
+    g_vpn_ctx.retry_count = 0;
+    g_vpn_ctx.rx_len = 0;
+    change_stage(VPN_STAGE_NONE);
+    
+    strncpy(g_vpn_ctx.pending_command, action, sizeof(g_vpn_ctx.pending_command) - 1);
+    
+    return 0;
+}
+
+/**
+ * @brief Check if the pending operation is a suspend or resume
+ */
+static bool is_session_command_pending(void) {
+    return g_vpn_ctx.operation_pending &&
+           (strcmp(g_vpn_ctx.pending_command, "suspend") == 0 ||
+            strcmp(g_vpn_ctx.pending_command, "resume") == 0);
+}
+
+/**
+ * @brief Replace a failed suspend/resume with the full command
+ * 
+ * A resume the agent cannot honour becomes a full connect, a suspend
+ * becomes a full disconnect.
+ */
+static int fall_back_to_full_command(void) {
+    bool was_resume = (strcmp(g_vpn_ctx.pending_command, "resume") == 0);
+    
+    #ifndef TESTING
+    logger_info("VPN %s not available, falling back to full %s",
+             g_vpn_ctx.pending_command, was_resume ? "connect" : "disconnect");
+    #endif
+    
+    g_vpn_ctx.operation_pending = false;
+    
+    if (was_resume) {
+        return start_operation("connect", VPN_STATE_CONNECTING, VPN_CONNECT_TIMEOUT_MS);
+    }
+    return start_operation("disconnect", VPN_STATE_DISCONNECTING, VPN_COMMAND_TIMEOUT_MS);
+}
+
+/**
+ * @brief Resend the pending command as a new attempt
+ */
+static int resend_pending_command(void) {
+    g_vpn_ctx.retry_count++;
+    g_vpn_ctx.last_retry_time = get_current_time_ms();
+    g_vpn_ctx.operation_start_time = get_current_time_ms();
+    g_vpn_ctx.rx_len = 0;
+    change_stage(VPN_STAGE_NONE);
+    
+    #ifndef TESTING
+    logger_info("VPN retry attempt %d/%d", g_vpn_ctx.retry_count, VPN_MAX_RETRY_ATTEMPTS);
+    #endif
+    
+    if (send_command(g_vpn_ctx.pending_command) < 0) {
+        fail_operation(g_vpn_ctx.last_error);
+        return -1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Apply a state reported by the agent and finish the pending operation
+ */
+static void complete_operation(vpn_state_t new_state) {
+    if (new_state == VPN_STATE_SUSPENDED) {
+        g_vpn_ctx.suspend_time = get_current_time_ms();
+    }
+    if (new_state == VPN_STATE_ERROR) {
+        g_vpn_ctx.last_error = VPN_ERROR_REJECTED;
+    }
+    
+    change_state(new_state);
+    change_stage(VPN_STAGE_NONE);
+    g_vpn_ctx.operation_pending = false;
+    g_vpn_ctx.retry_count = 0;
+}
+
+/**
+ * @brief Check if a published state ends the pending operation
+ */
+static bool is_terminal_for_pending(vpn_state_t state) {
+    const char *cmd = g_vpn_ctx.pending_command;
+    
+    if (state == VPN_STATE_ERROR) {
+        return true;
+    }
+    if (strcmp(cmd, "connect") == 0 || strcmp(cmd, "resume") == 0) {
+        return state == VPN_STATE_CONNECTED;
+    }
+    if (strcmp(cmd, "suspend") == 0) {
+        return state == VPN_STATE_SUSPENDED;
+    }
+    if (strcmp(cmd, "disconnect") == 0) {
+        return state == VPN_STATE_DISCONNECTED;
+    }
+    return false;
+}
+
+/**
+ * @brief Pick up state changes published in shared memory
+ * 
+ * Only does a snapshot read when the doorbell rang or the sequence
+ * counter moved, so the common case is a single memory load.
+ */
+static void sync_from_shm(void) {
+    if (g_vpn_ctx.shm == NULL) {
+        return;
+    }
+    
+    bool rang = vpn_shm_doorbell_rang(g_vpn_ctx.doorbell_fd);
+    uint32_t sequence = vpn_shm_sequence(g_vpn_ctx.shm);
+    
+    if (!rang && sequence == g_vpn_ctx.shm_sequence) {
+        return;
+    }
+    
+    vpn_shm_snapshot_t snapshot;
+    if (vpn_shm_read(g_vpn_ctx.shm, &snapshot) < 0) {
+        return;  // Writer busy, try again next time
+    }
+    g_vpn_ctx.shm_sequence = sequence;
+    memcpy(&g_vpn_ctx.info, &snapshot.info, sizeof(vpn_info_t));
+    
+    if (g_vpn_ctx.operation_pending &&
+        strcmp(g_vpn_ctx.pending_command, "connect") == 0 &&
+        snapshot.stage != VPN_STAGE_NONE &&
+        snapshot.stage != g_vpn_ctx.connect_stage) {
+        g_vpn_ctx.agent_reports_progress = true;
+        change_stage(snapshot.stage);
+    }
+    
+    vpn_state_t state = snapshot.info.state;
+    if (state == VPN_STATE_UNKNOWN || state == g_vpn_ctx.current_state) {
+        return;
+    }
+    
+    if (!g_vpn_ctx.operation_pending || is_terminal_for_pending(state)) {
+        complete_operation(state);
+    } else {
+        change_state(state);
+    }
+}
+
+/**
+ * @brief Handle one complete line received from the agent
+ */
+static void handle_agent_line(const char *line) {
+    vpn_connect_stage_t stage = parse_stage_from_event(line);
+    
+    if (stage != VPN_STAGE_NONE) {
+        g_vpn_ctx.agent_reports_progress = true;
+        if (g_vpn_ctx.operation_pending &&
+            strcmp(g_vpn_ctx.pending_command, "connect") == 0) {
+            change_stage(stage);
+        }
+        return;
+    }
+    
+    // Parse state from response
+    vpn_state_t new_state = parse_state_from_response(line);
+    
+    // Agent rejected suspend/resume or lost the session
+    if (is_session_command_pending() &&
+        (strstr(line, "\"status\":\"error\"") ||
+         (new_state == VPN_STATE_DISCONNECTED &&
+          strcmp(g_vpn_ctx.pending_command, "resume") == 0))) {
+        fall_back_to_full_command();
+        return;
+    }
+    
+    if (new_state != VPN_STATE_UNKNOWN) {
+        complete_operation(new_state);
+    }
+}
+
+/**
+ * @brief Split received agent data into lines and handle each one
+ * 
+ * The agent terminates every message with a newline. A trailing chunk
+ * without newline is kept for the next read unless it already looks
+ * like a complete JSON object.
+ */
+static void handle_agent_data(const char *data, size_t len) {
+    if (g_vpn_ctx.rx_len + len >= sizeof(g_vpn_ctx.rx_buffer)) {
+        // Oversized line, drop what we have buffered
+        g_vpn_ctx.rx_len = 0;
+        if (len >= sizeof(g_vpn_ctx.rx_buffer)) {
+            return;
+        }
+    }
+    
+    memcpy(g_vpn_ctx.rx_buffer + g_vpn_ctx.rx_len, data, len);
+    g_vpn_ctx.rx_len += len;
+    g_vpn_ctx.rx_buffer[g_vpn_ctx.rx_len] = '\0';
+    
+    char *line = g_vpn_ctx.rx_buffer;
+    char *newline;
+    
+    while ((newline = strchr(line, '\n')) != NULL) {
+        *newline = '\0';
+        if (newline > line) {
+            handle_agent_line(line);
+        }
+        line = newline + 1;
+    }
+    
+    size_t remaining = strlen(line);
+    if (remaining > 0 && line[remaining - 1] == '}') {
+        handle_agent_line(line);
+        remaining = 0;
+    }
+    
+    memmove(g_vpn_ctx.rx_buffer, line, remaining);
+    g_vpn_ctx.rx_len = remaining;
+    g_vpn_ctx.rx_buffer[remaining] = '\0';
+}
+
 /**
  * @brief Handle retry logic
  */
@@ -339,6 +730,10 @@ int vpn_controller_init(const char *socket_path) {
     g_vpn_ctx.previous_state = VPN_STATE_UNKNOWN;
     g_vpn_ctx.retry_count = 0;
     g_vpn_ctx.operation_pending = false;
+    g_vpn_ctx.connect_stage = VPN_STAGE_NONE;
+    g_vpn_ctx.agent_reports_progress = false;
+    g_vpn_ctx.last_error = VPN_ERROR_NONE;
+    g_vpn_ctx.rx_len = 0;
     g_vpn_ctx.initialized = true;
     
     memset(&g_vpn_ctx.info, 0, sizeof(vpn_info_t));
@@ -356,6 +751,11 @@ void vpn_controller_set_callback(vpn_state_callback_t callback, void *user_data)
     g_vpn_ctx.user_data = user_data;
 }
 
+void vpn_controller_set_progress_callback(vpn_progress_callback_t callback, void *user_data) {
+    g_vpn_ctx.progress_callback = callback;
+    g_vpn_ctx.progress_user_data = user_data;
+}
+
 int vpn_controller_connect(void) {
     if (!g_vpn_ctx.initialized) {
         return -1;
@@ -369,60 +769,113 @@ int vpn_controller_connect(void) {
         return -1;  // Connection in progress
     }
     
-    // Send connect command
-    if (send_command("connect") < 0) {
-        change_state(VPN_STATE_ERROR);
+    // Resume a suspended session while the agent still holds it
+    if (g_vpn_ctx.current_state == VPN_STATE_SUSPENDED &&
+        !is_timeout(g_vpn_ctx.suspend_time, g_vpn_ctx.suspend_linger_ms)) {
+        return start_operation("resume", VPN_STATE_CONNECTING, VPN_RESUME_TIMEOUT_MS);
+    }
+    
+    return start_operation("connect", VPN_STATE_CONNECTING, VPN_CONNECT_TIMEOUT_MS);
+}
+
+int vpn_controller_disconnect(void) {
+    if (!g_vpn_ctx.initialized) {
         return -1;
     }
     
-    // Update state
-    change_state(VPN_STATE_CONNECTING);
+    if (g_vpn_ctx.current_state == VPN_STATE_DISCONNECTED) {
+        return 0;  // Already disconnected
+    }
     
-    g_vpn_ctx.operation_start_time = get_current_time_ms();
-    g_vpn_ctx.operation_timeout = VPN_CONNECT_TIMEOUT_MS;
-    g_vpn_ctx.operation_pending = true;
-    g_vpn_ctx.retry_count = 0;
+    return start_operation("disconnect", VPN_STATE_DISCONNECTING, VPN_COMMAND_TIMEOUT_MS);
+}
+
+int vpn_controller_suspend(uint32_t linger_ms) {
+    if (!g_vpn_ctx.initialized) {
+        return -1;
+    }
     
-    strncpy(g_vpn_ctx.pending_command, "connect", sizeof(g_vpn_ctx.pending_command) - 1);
+    if (g_vpn_ctx.current_state == VPN_STATE_SUSPENDED) {
+        return 0;  // Already suspended
+    }
     
-    return 0;
+    if (linger_ms == 0 || g_vpn_ctx.current_state != VPN_STATE_CONNECTED) {
+        return vpn_controller_disconnect();
+    }
+    
+    g_vpn_ctx.suspend_linger_ms = linger_ms;
+    
+    return start_operation("suspend", VPN_STATE_DISCONNECTING, VPN_COMMAND_TIMEOUT_MS);
 }
 
-int vpn_controller_disconnect(void) {
+int vpn_controller_attach_shm(const char *shm_name) {
     if (!g_vpn_ctx.initialized) {
         return -1;
     }
     
-    if (g_vpn_ctx.current_state == VPN_STATE_DISCONNECTED) {
-        return 0;  // Already disconnected
+    if (g_vpn_ctx.shm != NULL) {
+        return 0;  // Already attached
     }
     
-    // Send disconnect command
-    if (send_command("disconnect") < 0) {
-        change_state(VPN_STATE_ERROR);
+    g_vpn_ctx.shm = vpn_shm_map(shm_name);
+    if (g_vpn_ctx.shm == NULL) {
+        #ifndef TESTING
+        logger_info("VPN agent publishes no shared state, using socket queries");
+        #endif
         return -1;
     }
     
-    change_state(VPN_STATE_DISCONNECTING);
+    // Force the first sync to read the region
+    g_vpn_ctx.shm_sequence = vpn_shm_sequence(g_vpn_ctx.shm) - 2;
     
-    g_vpn_ctx.operation_start_time = get_current_time_ms();
-    g_vpn_ctx.operation_timeout = VPN_COMMAND_TIMEOUT_MS;
-    g_vpn_ctx.operation_pending = true;
+    #ifndef TESTING
+    // Ask the agent for its doorbell; without it we poll the sequence counter
+    if (send_command("subscribe") == 0) {
+        char reply[VPN_MAX_MESSAGE_SIZE];
+        if (vpn_shm_recv_doorbell(g_vpn_ctx.sockfd, reply, sizeof(reply),
+                                  VPN_COMMAND_TIMEOUT_MS, &g_vpn_ctx.doorbell_fd) < 0 ||
+            g_vpn_ctx.doorbell_fd < 0) {
+            logger_warning("VPN agent sent no doorbell, polling shared state");
+        }
+    }
     
-    strncpy(g_vpn_ctx.pending_command, "disconnect", sizeof(g_vpn_ctx.pending_command) - 1);
+    logger_info("VPN shared state attached: %s",
+             shm_name != NULL ? shm_name : VPN_SHM_DEFAULT_NAME);
+    #endif
+    
+    sync_from_shm();
     
     return 0;
 }
 
+int vpn_controller_get_doorbell_fd(void) {
+    return g_vpn_ctx.doorbell_fd;
+}
+
 vpn_state_t vpn_controller_get_state(void) {
+    sync_from_shm();
     return g_vpn_ctx.current_state;
 }
 
+vpn_connect_stage_t vpn_controller_get_connect_stage(void) {
+    return g_vpn_ctx.connect_stage;
+}
+
 int vpn_controller_get_info(vpn_info_t *info) {
     if (!g_vpn_ctx.initialized || info == NULL) {
         return -1;
     }
     
+    // Shared state needs no round trip
+    if (g_vpn_ctx.shm != NULL) {
+        vpn_shm_snapshot_t snapshot;
+        if (vpn_shm_read(g_vpn_ctx.shm, &snapshot) == 0) {
+            memcpy(info, &snapshot.info, sizeof(vpn_info_t));
+            memcpy(&g_vpn_ctx.info, info, sizeof(vpn_info_t));
+            return 0;
+        }
+    }
+    
     // Send status query
     if (send_command("status") < 0) {
         return -1;
@@ -453,10 +906,26 @@ const char* vpn_controller_state_to_string(vpn_state_t state) {
         case VPN_STATE_CONNECTED:      return "CONNECTED";
         case VPN_STATE_DISCONNECTING:  return "DISCONNECTING";
         case VPN_STATE_ERROR:          return "ERROR";
+        case VPN_STATE_SUSPENDED:      return "SUSPENDED";
         default:                       return "INVALID";
     }
 }
 
+const char* vpn_controller_stage_to_string(vpn_connect_stage_t stage) {
+    switch (stage) {
+        case VPN_STAGE_NONE:             return "NONE";
+        case VPN_STAGE_RESOLVING:        return "RESOLVING";
+        case VPN_STAGE_HANDSHAKING:      return "HANDSHAKING";
+        case VPN_STAGE_HANDSHAKE_DONE:   return "HANDSHAKE_DONE";
+        case VPN_STAGE_ROUTES_INSTALLED: return "ROUTES_INSTALLED";
+        default:                         return "INVALID";
+    }
+}
+
+vpn_error_t vpn_controller_get_last_error(void) {
+    return g_vpn_ctx.last_error;
+}
+
 const char* vpn_controller_error_to_string(vpn_error_t error) {
     switch (error) {
         case VPN_ERROR_NONE:                return "NO_ERROR";
@@ -467,6 +936,9 @@ const char* vpn_controller_error_to_string(vpn_error_t error) {
         case VPN_ERROR_ALREADY_CONNECTED:   return "ALREADY_CONNECTED";
         case VPN_ERROR_NOT_CONNECTED:       return "NOT_CONNECTED";
         case VPN_ERROR_MAX_RETRIES:         return "MAX_RETRIES_EXCEEDED";
+        case VPN_ERROR_REJECTED:            return "REJECTED";
+        case VPN_ERROR_RESOLVE_TIMEOUT:     return "RESOLVE_TIMEOUT";
+        case VPN_ERROR_HANDSHAKE_TIMEOUT:   return "HANDSHAKE_TIMEOUT";
         default:                            return "UNKNOWN_ERROR";
     }
 }
@@ -479,39 +951,53 @@ int vpn_controller_process(int timeout_ms) {
     // Note: timeout_ms parameter is for future use with select/poll
     // Currently using simple timeout checking
     
+    // Transitions published in shared memory
+    sync_from_shm();
+    
+    // Agent drops a suspended session once the linger window is over
+    if (g_vpn_ctx.current_state == VPN_STATE_SUSPENDED &&
+        is_timeout(g_vpn_ctx.suspend_time, g_vpn_ctx.suspend_linger_ms)) {
+        change_state(VPN_STATE_DISCONNECTED);
+    }
+    
     // Check if there's a pending operation
     if (!g_vpn_ctx.operation_pending) {
         return 0;
     }
     
+    // Check for a stalled connect stage
+    if (is_stage_timeout()) {
+        #ifndef TESTING
+        logger_warning("VPN connect stalled in stage %s",
+                       vpn_controller_stage_to_string(g_vpn_ctx.connect_stage));
+        #endif
+        
+        // Stage deadlines are short, retry right away within the attempt budget
+        if (g_vpn_ctx.retry_count < VPN_MAX_RETRY_ATTEMPTS) {
+            return resend_pending_command();
+        }
+        
+        fail_operation(timeout_error_for_stage(g_vpn_ctx.connect_stage));
+        return -1;
+    }
+    
     // Check for timeout
     if (is_timeout(g_vpn_ctx.operation_start_time, g_vpn_ctx.operation_timeout)) {
         #ifndef TESTING
         logger_warning("VPN operation timeout");
         #endif
         
+        // Suspend/resume are optimisations, never retry them
+        if (is_session_command_pending()) {
+            return fall_back_to_full_command();
+        }
+        
         // Retry if possible
         if (should_retry()) {
-            g_vpn_ctx.retry_count++;
-            g_vpn_ctx.last_retry_time = get_current_time_ms();
-            g_vpn_ctx.operation_start_time = get_current_time_ms();
-            
-            #ifndef TESTING
-            logger_info("VPN retry attempt %d/%d", g_vpn_ctx.retry_count, VPN_MAX_RETRY_ATTEMPTS);
-            #endif
-            
-            // Resend command
-            if (send_command(g_vpn_ctx.pending_command) < 0) {
-                change_state(VPN_STATE_ERROR);
-                g_vpn_ctx.operation_pending = false;
-                return -1;
-            }
-            
-            return 0;
+            return resend_pending_command();
         } else {
             // Max retries exceeded
-            change_state(VPN_STATE_ERROR);
-            g_vpn_ctx.operation_pending = false;
+            fail_operation(timeout_error_for_stage(g_vpn_ctx.connect_stage));
             return -1;
         }
     }
@@ -522,8 +1008,7 @@ int vpn_controller_process(int timeout_ms) {
     
     if (received < 0) {
         // Error occurred
-        change_state(VPN_STATE_ERROR);
-        g_vpn_ctx.operation_pending = false;
+        fail_operation(VPN_ERROR_SOCKET);
         return -1;
     }
     
@@ -532,15 +1017,41 @@ int vpn_controller_process(int timeout_ms) {
         return 0;
     }
     
-    // Parse state from response
-    vpn_state_t new_state = parse_state_from_response(response);
+    // Handle progress events and state updates
+    handle_agent_data(response, (size_t)received);
     
-    if (new_state != VPN_STATE_UNKNOWN) {
-        change_state(new_state);
-        g_vpn_ctx.operation_pending = false;
-        g_vpn_ctx.retry_count = 0;
+    return 0;
+}
+
+int vpn_controller_release(void) {
+    if (!g_vpn_ctx.initialized) {
+        return -1;
     }
     
+    vpn_state_t state = vpn_controller_get_state();
+    if ((state != VPN_STATE_DISCONNECTED && state != VPN_STATE_UNKNOWN) ||
+        g_vpn_ctx.operation_pending) {
+        return -1;  // Agent still holds a session for us
+    }
+    
+    if (g_vpn_ctx.sockfd >= 0) {
+        #ifndef TESTING
+        socket_helper_close(g_vpn_ctx.sockfd);
+        #else
+        close(g_vpn_ctx.sockfd);
+        #endif
+        g_vpn_ctx.sockfd = -1;
+    }
+    g_vpn_ctx.rx_len = 0;
+    
+    // Shared state and the doorbell stay attached: re-subscribing would
+    // cost the next press a blocking round trip. A doorbell the agent
+    // stops ringing is covered by the sequence check in sync_from_shm().
+    
+    #ifndef TESTING
+    logger_info("VPN agent connection released while idle");
+    #endif
+    
     return 0;
 }
 
@@ -559,14 +1070,32 @@ void vpn_controller_cleanup(void) {
         g_vpn_ctx.sockfd = -1;
     }
     
+    // Detach shared state
+    vpn_shm_unmap(g_vpn_ctx.shm);
+    g_vpn_ctx.shm = NULL;
+    if (g_vpn_ctx.doorbell_fd >= 0) {
+        close(g_vpn_ctx.doorbell_fd);
+        g_vpn_ctx.doorbell_fd = -1;
+    }
+    
     // Reset state
     g_vpn_ctx.initialized = false;
     g_vpn_ctx.current_state = VPN_STATE_UNKNOWN;
     g_vpn_ctx.callback = NULL;
     g_vpn_ctx.user_data = NULL;
+    g_vpn_ctx.progress_callback = NULL;
+    g_vpn_ctx.progress_user_data = NULL;
+    g_vpn_ctx.connect_stage = VPN_STAGE_NONE;
     g_vpn_ctx.operation_pending = false;
     
     #ifndef TESTING
     logger_info("VPN controller cleaned up");
     #endif
 }
+
+#ifdef TESTING
+void vpn_controller_set_test_transport(vpn_test_send_fn send_fn, vpn_test_recv_fn recv_fn) {
+    g_test_send = send_fn;
+    g_test_recv = recv_fn;
+}
+#endif
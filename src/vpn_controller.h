@@ -5,6 +5,8 @@
  * This module provides communication with the VPN agent to control
  * VPN connections. Features include:
  * - Connect/Disconnect commands
+ * - Suspend/resume of the agent session for fast reconnects
+ * - Optional shared-memory state channel (see vpn_shm.h)
  * - State query
  * - Timeout and retry mechanism
  * - Non-blocking I/O
@@ -19,6 +21,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +55,27 @@ extern "C" {
 /** Maximum message size */
 #define VPN_MAX_MESSAGE_SIZE        1024
 
+/** Resume command timeout in milliseconds (falls back to full connect) */
+#define VPN_RESUME_TIMEOUT_MS       2000
+
+/** Default time the agent keeps a suspended session */
+#define VPN_DEFAULT_LINGER_MS       60000
+
+/** Deadline for the first progress event after a connect is sent */
+#define VPN_STAGE_START_TIMEOUT_MS      2000
+
+/** Deadline for server address resolution */
+#define VPN_STAGE_RESOLVE_TIMEOUT_MS    5000
+
+/** Deadline for the tunnel handshake */
+#define VPN_STAGE_HANDSHAKE_TIMEOUT_MS  3000
+
+/** Deadline between handshake completion and route installation */
+#define VPN_STAGE_ROUTES_TIMEOUT_MS     3000
+
+/** Deadline between route installation and the final connected state */
+#define VPN_STAGE_FINALIZE_TIMEOUT_MS   2000
+
 /* ============================================================
  *  Type Definitions
  * ============================================================ */
@@ -66,6 +90,7 @@ typedef enum {
     VPN_STATE_CONNECTED,            /**< VPN is connected */
     VPN_STATE_DISCONNECTING,        /**< VPN is disconnecting */
     VPN_STATE_ERROR,                /**< VPN is in error state */
+    VPN_STATE_SUSPENDED,            /**< Tunnel down, agent keeps session for resume */
 } vpn_state_t;
 
 /**
@@ -80,8 +105,25 @@ typedef enum {
     VPN_ERROR_ALREADY_CONNECTED,    /**< Already connected */
     VPN_ERROR_NOT_CONNECTED,        /**< Not connected */
     VPN_ERROR_MAX_RETRIES,          /**< Maximum retries exceeded */
+    VPN_ERROR_REJECTED,             /**< Agent reported the operation failed */
+    VPN_ERROR_RESOLVE_TIMEOUT,      /**< Connect stalled resolving the server */
+    VPN_ERROR_HANDSHAKE_TIMEOUT,    /**< Connect stalled in the tunnel handshake */
 } vpn_error_t;
 
+/**
+ * @brief VPN connect progress stages reported by the agent
+ * 
+ * Agents that support progress reporting send one event per stage while
+ * a connect is in flight, e.g. {"event":"progress","stage":"handshaking"}.
+ */
+typedef enum {
+    VPN_STAGE_NONE = 0,             /**< No progress reported yet */
+    VPN_STAGE_RESOLVING,            /**< Resolving VPN server address */
+    VPN_STAGE_HANDSHAKING,          /**< Tunnel handshake in progress */
+    VPN_STAGE_HANDSHAKE_DONE,       /**< Handshake completed */
+    VPN_STAGE_ROUTES_INSTALLED,     /**< Routes installed */
+} vpn_connect_stage_t;
+
 /**
  * @brief VPN connection information
  */
@@ -105,6 +147,15 @@ typedef void (*vpn_state_callback_t)(vpn_state_t old_state,
                                      vpn_state_t new_state, 
                                      void *user_data);
 
+/**
+ * @brief VPN connect progress callback
+ * 
+ * @param stage Stage the agent has just entered
+ * @param user_data User-provided data pointer
+ */
+typedef void (*vpn_progress_callback_t)(vpn_connect_stage_t stage,
+                                        void *user_data);
+
 /* ============================================================
  *  Public Function Declarations
  * ============================================================ */
@@ -131,6 +182,16 @@ int vpn_controller_init(const char *socket_path);
  */
 void vpn_controller_set_callback(vpn_state_callback_t callback, void *user_data);
 
+/**
+ * @brief Set VPN connect progress callback
+ * 
+ * Register a callback function to be notified of connect progress events.
+ * 
+ * @param callback Callback function pointer
+ * @param user_data User data to pass to callback (can be NULL)
+ */
+void vpn_controller_set_progress_callback(vpn_progress_callback_t callback, void *user_data);
+
 /**
  * @brief Connect to VPN
  * 
@@ -153,6 +214,42 @@ int vpn_controller_connect(void);
  */
 int vpn_controller_disconnect(void);
 
+/**
+ * @brief Suspend the VPN session
+ * 
+ * Ask the agent to take the tunnel down but keep keys and peer state
+ * for linger_ms. A vpn_controller_connect() within that window is sent
+ * as a resume and skips the handshake. Falls back to a full disconnect
+ * when the VPN is not connected, linger_ms is 0 or the agent does not
+ * support suspend. This function is non-blocking.
+ * 
+ * @param linger_ms Time the agent keeps the session in milliseconds
+ * @return 0 on success, negative error code on failure
+ */
+int vpn_controller_suspend(uint32_t linger_ms);
+
+/**
+ * @brief Attach to the agent's shared-memory state region
+ * 
+ * Once attached, state and info are read from the region instead of
+ * the socket, and transitions are picked up from the eventfd doorbell.
+ * The socket is then only used for commands.
+ * 
+ * @param shm_name Shared-memory object name (NULL for default)
+ * @return 0 on success, negative if the agent does not publish a region
+ */
+int vpn_controller_attach_shm(const char *shm_name);
+
+/**
+ * @brief Get the doorbell descriptor
+ * 
+ * Becomes readable when the agent publishes a state change. Can be
+ * added to a poll set to wake the main loop on VPN transitions.
+ * 
+ * @return eventfd descriptor, -1 if no doorbell is attached
+ */
+int vpn_controller_get_doorbell_fd(void);
+
 /**
  * @brief Get current VPN state
  * 
@@ -162,10 +259,20 @@ int vpn_controller_disconnect(void);
  */
 vpn_state_t vpn_controller_get_state(void);
 
+/**
+ * @brief Get current connect stage
+ * 
+ * @return Last progress stage reported for the in-flight connect,
+ *         VPN_STAGE_NONE if no connect is in progress
+ */
+vpn_connect_stage_t vpn_controller_get_connect_stage(void);
+
 /**
  * @brief Get detailed VPN information
  * 
- * Retrieve detailed information about the VPN connection.
+ * Retrieve detailed information about the VPN connection. Served from
+ * the shared-memory region when attached, otherwise a blocking status
+ * round trip to the agent.
  * 
  * @param info Pointer to vpn_info_t structure to fill
  * @return 0 on success, negative error code on failure
@@ -228,6 +335,29 @@ const char* vpn_controller_error_to_string(vpn_error_t error);
  */
 const char* vpn_controller_state_to_string(vpn_state_t state);
 
+/**
+ * @brief Get connect stage string
+ * 
+ * Convert connect stage to human-readable string.
+ * 
+ * @param stage Connect stage
+ * @return Stage description string
+ */
+const char* vpn_controller_stage_to_string(vpn_connect_stage_t stage);
+
+/**
+ * @brief Release the agent connection while idle
+ * 
+ * Close the agent socket to free its buffers between presses. The socket
+ * is reopened by the next command. Shared state and the doorbell stay
+ * attached, so nothing has to be re-subscribed before the next press.
+ * Refused while the agent holds a session (connected, suspended or in a
+ * transition).
+ * 
+ * @return 0 on success, negative if a session is still active
+ */
+int vpn_controller_release(void);
+
 /**
  * @brief Clean up VPN controller resources
  * 
@@ -235,6 +365,37 @@ const char* vpn_controller_state_to_string(vpn_state_t state);
  */
 void vpn_controller_cleanup(void);
 
+#ifdef TESTING
+/**
+ * @brief Agent send hook (unit tests only)
+ * 
+ * @param data Command line sent to the agent
+ * @param length Command length in bytes
+ * @return Bytes sent, negative on failure
+ */
+typedef int (*vpn_test_send_fn)(const char *data, size_t length);
+
+/**
+ * @brief Agent receive hook (unit tests only)
+ * 
+ * @param buffer Buffer to fill with agent output
+ * @param max_len Buffer size in bytes
+ * @return Bytes received, 0 if nothing pending, negative on failure
+ */
+typedef int (*vpn_test_recv_fn)(char *buffer, size_t max_len);
+
+/**
+ * @brief Replace the agent socket with test hooks
+ * 
+ * Pass NULL for both hooks to restore the built-in mock agent that
+ * answers every command with a connected state.
+ * 
+ * @param send_fn Send hook (can be NULL)
+ * @param recv_fn Receive hook (can be NULL)
+ */
+void vpn_controller_set_test_transport(vpn_test_send_fn send_fn, vpn_test_recv_fn recv_fn);
+#endif
+
 /** @} */ // end of VPNController group
 
 #ifdef __cplusplus
@@ -0,0 +1,220 @@
+/**
+ * @file vpn_shm.c
+ * @brief VPN Shared State Implementation
+ * 
+ * Seqlock reader/writer for the agent-published state region and the
+ * eventfd doorbell hand-over on the agent socket.
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+// shm_open, eventfd and SCM_RIGHTS helpers
+#define _GNU_SOURCE
+
+#include "vpn_shm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+static const char* region_name(const char *name) {
+    return name != NULL ? name : VPN_SHM_DEFAULT_NAME;
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+const vpn_shm_region_t* vpn_shm_map(const char *name) {
+    int fd = shm_open(region_name(name), O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(vpn_shm_region_t)) {
+        close(fd);
+        return NULL;
+    }
+    
+    void *addr = mmap(NULL, sizeof(vpn_shm_region_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    
+    const vpn_shm_region_t *region = (const vpn_shm_region_t *)addr;
+    if (region->magic != VPN_SHM_MAGIC || region->version != VPN_SHM_VERSION) {
+        munmap(addr, sizeof(vpn_shm_region_t));
+        return NULL;
+    }
+    
+    return region;
+}
+
+void vpn_shm_unmap(const vpn_shm_region_t *region) {
+    if (region != NULL) {
+        munmap((void *)region, sizeof(vpn_shm_region_t));
+    }
+}
+
+uint32_t vpn_shm_sequence(const vpn_shm_region_t *region) {
+    return __atomic_load_n(&region->sequence, __ATOMIC_ACQUIRE);
+}
+
+int vpn_shm_read(const vpn_shm_region_t *region, vpn_shm_snapshot_t *snapshot) {
+    if (region == NULL || snapshot == NULL) {
+        return -1;
+    }
+    
+    for (int attempt = 0; attempt < VPN_SHM_MAX_READ_RETRIES; attempt++) {
+        uint32_t begin = vpn_shm_sequence(region);
+        if (begin & 1u) {
+            continue;  // Writer in progress
+        }
+        
+        vpn_shm_region_t copy;
+        memcpy(&copy, region, sizeof(copy));
+        
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&region->sequence, __ATOMIC_RELAXED) != begin) {
+            continue;  // Torn read
+        }
+        
+        memset(snapshot, 0, sizeof(*snapshot));
+        snapshot->info.state = (vpn_state_t)copy.state;
+        snapshot->info.bytes_sent = copy.bytes_sent;
+        snapshot->info.bytes_received = copy.bytes_received;
+        snapshot->info.connect_time = copy.connect_time;
+        memcpy(snapshot->info.server_ip, copy.server_ip, sizeof(snapshot->info.server_ip) - 1);
+        memcpy(snapshot->info.local_ip, copy.local_ip, sizeof(snapshot->info.local_ip) - 1);
+        snapshot->stage = (vpn_connect_stage_t)copy.connect_stage;
+        snapshot->change_count = copy.change_count;
+        
+        return 0;
+    }
+    
+    return -1;
+}
+
+vpn_shm_region_t* vpn_shm_create(const char *name) {
+    int fd = shm_open(region_name(name), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    if (ftruncate(fd, sizeof(vpn_shm_region_t)) < 0) {
+        close(fd);
+        return NULL;
+    }
+    
+    void *addr = mmap(NULL, sizeof(vpn_shm_region_t), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    
+    vpn_shm_region_t *region = (vpn_shm_region_t *)addr;
+    memset(region, 0, sizeof(*region));
+    region->version = VPN_SHM_VERSION;
+    region->state = VPN_STATE_UNKNOWN;
+    
+    // Magic last, readers reject the region until it is initialised
+    __atomic_store_n(&region->magic, VPN_SHM_MAGIC, __ATOMIC_RELEASE);
+    
+    return region;
+}
+
+void vpn_shm_publish(vpn_shm_region_t *region, const vpn_shm_snapshot_t *snapshot) {
+    if (region == NULL || snapshot == NULL) {
+        return;
+    }
+    
+    uint32_t seq = __atomic_load_n(&region->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&region->sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    
+    region->state = (uint32_t)snapshot->info.state;
+    region->connect_stage = (uint32_t)snapshot->stage;
+    region->change_count++;
+    region->bytes_sent = snapshot->info.bytes_sent;
+    region->bytes_received = snapshot->info.bytes_received;
+    region->connect_time = snapshot->info.connect_time;
+    strncpy(region->server_ip, snapshot->info.server_ip, sizeof(region->server_ip) - 1);
+    strncpy(region->local_ip, snapshot->info.local_ip, sizeof(region->local_ip) - 1);
+    
+    __atomic_store_n(&region->sequence, seq + 2, __ATOMIC_RELEASE);
+}
+
+void vpn_shm_destroy(vpn_shm_region_t *region, const char *name) {
+    if (region != NULL) {
+        munmap(region, sizeof(vpn_shm_region_t));
+    }
+    shm_unlink(region_name(name));
+}
+
+int vpn_shm_recv_doorbell(int sockfd, char *buffer, size_t max_len,
+                          int timeout_ms, int *fd_out) {
+    if (buffer == NULL || max_len == 0 || fd_out == NULL) {
+        return -1;
+    }
+    
+    *fd_out = -1;
+    
+    struct pollfd pfd = { .fd = sockfd, .events = POLLIN };
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return -1;
+    }
+    
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { .iov_base = buffer, .iov_len = max_len - 1 };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    
+    ssize_t received = recvmsg(sockfd, &msg, 0);
+    if (received <= 0) {
+        return -1;
+    }
+    buffer[received] = '\0';
+    
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            memcpy(fd_out, CMSG_DATA(cmsg), sizeof(int));
+            fcntl(*fd_out, F_SETFL, fcntl(*fd_out, F_GETFL) | O_NONBLOCK);
+            break;
+        }
+    }
+    
+    return (int)received;
+}
+
+bool vpn_shm_doorbell_rang(int fd) {
+    if (fd < 0) {
+        return false;
+    }
+    
+    eventfd_t value;
+    return eventfd_read(fd, &value) == 0 && value > 0;
+}
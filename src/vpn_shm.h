@@ -0,0 +1,179 @@
+/**
+ * @file vpn_shm.h
+ * @brief VPN Shared State - Seqlock-protected state region published by the VPN agent
+ * 
+ * The VPN agent can publish its state in a POSIX shared-memory region so
+ * clients read it with a memory load instead of a JSON round trip.
+ * Features include:
+ * - Fixed-layout region shared between agent and client
+ * - Seqlock for torn-read-free snapshots without locking the writer
+ * - eventfd doorbell handed over the agent socket (SCM_RIGHTS)
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ * @version 1.0.0
+ */
+
+#ifndef VPN_SHM_H
+#define VPN_SHM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "vpn_controller.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup VPNShm VPN Shared State
+ * @brief Shared-memory state channel with the VPN agent
+ * @{
+ */
+
+/* ============================================================
+ *  Constants and Macros
+ * ============================================================ */
+
+/** Default shared-memory object published by the agent */
+#define VPN_SHM_DEFAULT_NAME        "/vpn-agent-state"
+
+/** Region magic ('VPNS') */
+#define VPN_SHM_MAGIC               0x56504E53u
+
+/** Region layout version */
+#define VPN_SHM_VERSION             1
+
+/** Read attempts before a snapshot is given up on */
+#define VPN_SHM_MAX_READ_RETRIES    64
+
+/* ============================================================
+ *  Type Definitions
+ * ============================================================ */
+
+/**
+ * @brief Shared-memory region layout
+ * 
+ * Written only by the agent. The sequence counter is odd while an
+ * update is in progress; readers retry until they see the same even
+ * value before and after copying.
+ */
+typedef struct {
+    uint32_t magic;                 /**< VPN_SHM_MAGIC */
+    uint32_t version;               /**< VPN_SHM_VERSION */
+    uint32_t sequence;              /**< Seqlock counter */
+    uint32_t state;                 /**< vpn_state_t */
+    uint32_t connect_stage;         /**< vpn_connect_stage_t */
+    uint32_t change_count;          /**< Number of published updates */
+    uint32_t bytes_sent;            /**< Bytes sent through VPN */
+    uint32_t bytes_received;        /**< Bytes received through VPN */
+    uint32_t connect_time;          /**< Connection timestamp */
+    char server_ip[64];             /**< Connected server IP */
+    char local_ip[64];              /**< Local VPN IP */
+} vpn_shm_region_t;
+
+/**
+ * @brief Consistent copy of the shared state
+ */
+typedef struct {
+    vpn_info_t info;                /**< State, endpoints and counters */
+    vpn_connect_stage_t stage;      /**< Connect progress stage */
+    uint32_t change_count;          /**< Number of published updates */
+} vpn_shm_snapshot_t;
+
+/* ============================================================
+ *  Public Function Declarations
+ * ============================================================ */
+
+/**
+ * @brief Map an agent-published region read-only
+ * 
+ * @param name Shared-memory object name (NULL for default)
+ * @return Mapped region, or NULL if missing or incompatible
+ */
+const vpn_shm_region_t* vpn_shm_map(const char *name);
+
+/**
+ * @brief Unmap a region returned by vpn_shm_map()
+ * 
+ * @param region Mapped region (can be NULL)
+ */
+void vpn_shm_unmap(const vpn_shm_region_t *region);
+
+/**
+ * @brief Read a consistent snapshot
+ * 
+ * @param region Mapped region
+ * @param snapshot Snapshot to fill
+ * @return 0 on success, negative if no stable copy could be taken
+ */
+int vpn_shm_read(const vpn_shm_region_t *region, vpn_shm_snapshot_t *snapshot);
+
+/**
+ * @brief Get the current sequence counter
+ * 
+ * Cheap change check: the value differs from a previous call whenever
+ * the agent published an update in between.
+ * 
+ * @param region Mapped region
+ * @return Sequence counter
+ */
+uint32_t vpn_shm_sequence(const vpn_shm_region_t *region);
+
+/**
+ * @brief Create and map a region for writing (agent side)
+ * 
+ * @param name Shared-memory object name (NULL for default)
+ * @return Writable region, or NULL on failure
+ */
+vpn_shm_region_t* vpn_shm_create(const char *name);
+
+/**
+ * @brief Publish a new state (agent side)
+ * 
+ * @param region Writable region
+ * @param snapshot State to publish (change_count is ignored)
+ */
+void vpn_shm_publish(vpn_shm_region_t *region, const vpn_shm_snapshot_t *snapshot);
+
+/**
+ * @brief Unmap and remove a region created with vpn_shm_create()
+ * 
+ * @param region Writable region
+ * @param name Shared-memory object name (NULL for default)
+ */
+void vpn_shm_destroy(vpn_shm_region_t *region, const char *name);
+
+/**
+ * @brief Receive a message with an attached doorbell descriptor
+ * 
+ * Waits up to timeout_ms for the agent's reply to a subscribe command
+ * and extracts the eventfd passed with SCM_RIGHTS.
+ * 
+ * @param sockfd Agent socket
+ * @param buffer Buffer for the reply text
+ * @param max_len Buffer size in bytes
+ * @param timeout_ms Time to wait for the reply
+ * @param fd_out Received descriptor, -1 if none was attached
+ * @return Bytes received, negative on failure
+ */
+int vpn_shm_recv_doorbell(int sockfd, char *buffer, size_t max_len,
+                          int timeout_ms, int *fd_out);
+
+/**
+ * @brief Drain a doorbell eventfd
+ * 
+ * @param fd Doorbell descriptor
+ * @return true if the agent rang since the last call
+ */
+bool vpn_shm_doorbell_rang(int fd);
+
+/** @} */ // end of VPNShm group
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VPN_SHM_H */
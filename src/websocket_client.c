@@ -7,6 +7,8 @@
  * - Non-blocking WebSocket connection
  * - Automatic reconnection with exponential backoff
  * - Ping/Pong heartbeat mechanism
+ * - Per-class outbound queues served strictly or by weighted round robin
+ * - Negotiated batch envelopes packing several messages per frame
  * - JSON message handling
  * - Multiple callback support
  * 
@@ -16,6 +18,7 @@
  */
 
 #include "websocket_client.h"
+#include "json_scan.h"
 
 #ifndef TESTING
   #ifdef OPENWRT_BUILD
@@ -41,10 +44,66 @@
  *  Internal Structures
  * ============================================================ */
 
+/** Headroom libwebsockets needs in front of each frame */
+#ifndef TESTING
+#define WS_SEND_HEADROOM LWS_PRE
+#else
+#define WS_SEND_HEADROOM 0
+#endif
+
+/** Batch envelope framing (server batches must also put "type" first) */
+#define BATCH_PREFIX    "{\"type\":\"batch\",\"messages\":["
+#define BATCH_SUFFIX    "]}"
+
+/** Feature offer sent on every new connection when batching is enabled */
+#define HELLO_MESSAGE   "{\"type\":\"hello\",\"features\":[\"batch\"]}"
+
+/**
+ * @brief Queued outbound message
+ * 
+ * Payload is stored at buffer + WS_SEND_HEADROOM so it can be written
+ * without another copy.
+ */
+typedef struct {
+    unsigned char *buffer;
+    size_t length;
+    uint32_t enqueue_time;
+} ws_queued_msg_t;
+
+/**
+ * @brief Outbound queue for one priority class
+ */
+typedef struct {
+    ws_queued_msg_t slots[WS_SEND_QUEUE_DEPTH];
+    int head;
+    int count;
+    uint8_t weight;
+    uint8_t credits;                // Remaining sends in current WRR round
+    ws_queue_stats_t stats;
+} ws_send_queue_t;
+
 /**
- * @brief WebSocket client context
+ * @brief Server hint state of a session
  */
 typedef struct {
+    bool holding;                   // Connects refused until hold_until
+    uint32_t hold_until;
+    bool active;                    // Rate and push-only in force until expiry
+    uint32_t expiry;
+    uint32_t rate_percent;          // 100 = normal pace
+    bool push_only;
+    uint32_t jitter_state;          // xorshift32, 0 until first use
+    uint32_t hints_received;
+    uint32_t redirects;
+} ws_hint_t;
+
+/**
+ * @brief WebSocket session (one server connection)
+ * 
+ * The client API drives the primary session; extra sessions opened with
+ * ws_session_open() share its libwebsockets context and event loop.
+ */
+struct ws_session_t {
     bool initialized;
     char server_host[256];
     int server_port;
@@ -58,9 +117,12 @@ typedef struct {
     ws_error_callback_t on_error;
     ws_message_callback_t on_message;
     void *user_data;
+    ws_redirect_callback_t on_redirect;
+    void *redirect_user_data;
     
     // Reconnection
     bool auto_reconnect;
+    bool redirect_reconnect;        // Followed a redirect, connect once the hold ends
     int reconnect_attempts;
     uint32_t reconnect_interval;
     uint32_t last_reconnect_time;
@@ -71,6 +133,10 @@ typedef struct {
     uint32_t ping_interval;
     bool waiting_for_pong;
     
+    // Last failure, passed to the error callback
+    ws_error_t last_error;
+    char error_detail[64];
+    
     // libwebsockets context (only in real mode)
     #ifndef TESTING
     struct lws_context *ws_context;
@@ -80,20 +146,35 @@ typedef struct {
     void *ws_connection;
     #endif
     
-    // Message buffer
-    char send_buffer[WS_MAX_MESSAGE_SIZE];
-    size_t send_buffer_len;
+    // Outbound queues
+    ws_send_queue_t queues[WS_PRIORITY_COUNT];
+    ws_sched_mode_t sched_mode;
+    bool ping_pending;
+    
+    // Batch envelopes
+    bool batching_offered;          // Offer the feature on connect
+    bool batching_active;           // Server accepted the offer
+    unsigned char batch_buffer[WS_SEND_HEADROOM + WS_MAX_MESSAGE_SIZE];
     
-    char recv_buffer[WS_MAX_MESSAGE_SIZE];
-    size_t recv_buffer_len;
+    #ifdef TESTING
+    ws_test_write_fn test_write;
+    #endif
+    
+    // Reassembly of messages split across receive callbacks
+    char *rx_buffer;
+    size_t rx_buffer_len;
+    size_t rx_buffer_size;
+    bool rx_assembling;
     
-} ws_client_ctx_t;
+    // Load-shedding hints from the server
+    ws_hint_t hint;
+};
 
 /* ============================================================
  *  Global Variables
  * ============================================================ */
 
-static ws_client_ctx_t g_ws_ctx = {
+static ws_session_t g_ws_ctx = {
     .initialized = false,
     .current_state = WS_STATE_DISCONNECTED,
     .previous_state = WS_STATE_DISCONNECTED,
@@ -103,8 +184,17 @@ static ws_client_ctx_t g_ws_ctx = {
     .max_reconnect_interval = WS_MAX_RECONNECT_INTERVAL_MS,
     .ping_interval = WS_PING_INTERVAL_MS,
     .waiting_for_pong = false,
+    .sched_mode = WS_SCHED_STRICT,
+    .queues = {
+        [WS_PRIORITY_CONTROL]     = { .weight = WS_WEIGHT_CONTROL },
+        [WS_PRIORITY_INTERACTIVE] = { .weight = WS_WEIGHT_INTERACTIVE },
+        [WS_PRIORITY_BACKGROUND]  = { .weight = WS_WEIGHT_BACKGROUND },
+    },
 };
 
+/** Extra sessions opened with ws_session_open() */
+static ws_session_t g_ws_sessions[WS_MAX_SESSIONS - 1];
+
 /* ============================================================
  *  Internal Helper Functions
  * ============================================================ */
@@ -121,387 +211,1195 @@ static uint32_t get_current_time_ms(void) {
 /**
  * @brief Change WebSocket state and trigger callback
  */
-static void change_state(ws_state_t new_state) {
-    if (g_ws_ctx.current_state == new_state) {
+static void change_state(ws_session_t *ws, ws_state_t new_state) {
+    if (ws->current_state == new_state) {
         return;
     }
     
-    g_ws_ctx.previous_state = g_ws_ctx.current_state;
-    g_ws_ctx.current_state = new_state;
+    ws->previous_state = ws->current_state;
+    ws->current_state = new_state;
     
     #ifndef TESTING
-    logger_info("WebSocket state changed: %s -> %s",
-             ws_client_state_to_string(g_ws_ctx.previous_state),
+    logger_info("WebSocket state changed (%s): %s -> %s", ws->server_host,
+             ws_client_state_to_string(ws->previous_state),
              ws_client_state_to_string(new_state));
     #endif
     
+    // Offer features ahead of anything the connected callback queues
+    if (new_state == WS_STATE_CONNECTED && ws->batching_offered) {
+        ws_session_send_with_priority(ws, HELLO_MESSAGE, WS_PRIORITY_CONTROL);
+    }
+    
     // Trigger appropriate callbacks
-    if (new_state == WS_STATE_CONNECTED && g_ws_ctx.on_connected != NULL) {
-        g_ws_ctx.on_connected(g_ws_ctx.user_data);
-    } else if (new_state == WS_STATE_DISCONNECTED && g_ws_ctx.on_disconnected != NULL) {
+    if (new_state == WS_STATE_CONNECTED && ws->on_connected != NULL) {
+        ws->on_connected(ws->user_data);
+    } else if (new_state == WS_STATE_DISCONNECTED && ws->on_disconnected != NULL) {
         // 修正: 添加 reason 參數
-        g_ws_ctx.on_disconnected("Disconnected", g_ws_ctx.user_data);
-    } else if (new_state == WS_STATE_ERROR && g_ws_ctx.on_error != NULL) {
-        // 修正: 使用正確的錯誤碼 WS_ERROR_CONNECT
-        g_ws_ctx.on_error(WS_ERROR_CONNECT, "Connection error", g_ws_ctx.user_data);
+        ws->on_disconnected("Disconnected", ws->user_data);
+    } else if (new_state == WS_STATE_ERROR && ws->on_error != NULL) {
+        ws->on_error(ws->last_error, ws->error_detail, ws->user_data);
+    }
+}
+
+/**
+ * @brief Move a session to the error state with the failure behind it
+ */
+static void fail_session(ws_session_t *ws, ws_error_t error, const char *detail) {
+    ws->last_error = error;
+    snprintf(ws->error_detail, sizeof(ws->error_detail), "%s",
+             detail != NULL && detail[0] != '\0' ? detail : "Connection error");
+    change_state(ws, WS_STATE_ERROR);
+}
+
+/**
+ * @brief Classify a connection error from the library's error text
+ * 
+ * libwebsockets only reports failed connects as text, so this goes by
+ * the wording of its resolver, socket and handshake messages.
+ */
+static ws_error_t classify_connection_error(const char *detail) {
+    if (detail == NULL) {
+        return WS_ERROR_CONNECT;
+    }
+    if (strstr(detail, "getaddrinfo") || strstr(detail, "DNS") || strstr(detail, "dns") ||
+        strstr(detail, "resolve")) {
+        return WS_ERROR_DNS;
+    }
+    if (strstr(detail, "refused")) {
+        return WS_ERROR_REFUSED;
+    }
+    if (strstr(detail, "timed out") || strstr(detail, "timeout")) {
+        return WS_ERROR_TIMEOUT;
+    }
+    if (strstr(detail, "HS:") || strstr(detail, "upgrade") || strstr(detail, "handshake") ||
+        strstr(detail, "tls") || strstr(detail, "TLS") || strstr(detail, "ssl") ||
+        strstr(detail, "SSL")) {
+        return WS_ERROR_HANDSHAKE;
+    }
+    return WS_ERROR_CONNECT;
+}
+
+/**
+ * @brief Handle a failed connect reported by the library
+ */
+static void handle_connection_error(ws_session_t *ws, const char *detail) {
+    ws->ws_connection = NULL;
+    fail_session(ws, classify_connection_error(detail), detail);
+}
+
+/**
+ * @brief Stretch a periodic interval by the server's rate hint
+ */
+static uint32_t scale_by_hint(const ws_session_t *ws, uint32_t interval) {
+    if (!ws->hint.active || ws->hint.rate_percent >= 100) {
+        return interval;
+    }
+    
+    uint64_t scaled = (uint64_t)interval * 100 / ws->hint.rate_percent;
+    return scaled > UINT32_MAX ? UINT32_MAX : (uint32_t)scaled;
+}
+
+/**
+ * @brief Random delay in [0, range) so a fleet spreads out its retries
+ */
+static uint32_t hint_jitter(ws_session_t *ws, uint32_t range) {
+    uint32_t x = ws->hint.jitter_state;
+    
+    if (x == 0) {
+        x = get_current_time_ms() ^ ((uint32_t)getpid() << 16) ^ (uint32_t)(uintptr_t)ws;
+        if (x == 0) {
+            x = 1;
+        }
+    }
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ws->hint.jitter_state = x;
+    
+    return range > 0 ? x % range : 0;
+}
+
+/**
+ * @brief Check if the server asked us not to connect yet
+ */
+static bool is_held_off(ws_session_t *ws, uint32_t now) {
+    if (ws->hint.holding && (int32_t)(now - ws->hint.hold_until) >= 0) {
+        ws->hint.holding = false;
+    }
+    return ws->hint.holding;
+}
+
+/**
+ * @brief Refuse connects for delay_ms, then start backoff afresh
+ */
+static void hold_off(ws_session_t *ws, uint32_t delay_ms) {
+    uint32_t until = get_current_time_ms() + delay_ms;
+    
+    // A later hold never shortens an earlier one
+    if (!ws->hint.holding || (int32_t)(until - ws->hint.hold_until) > 0) {
+        ws->hint.hold_until = until;
     }
+    ws->hint.holding = true;
+    ws->reconnect_attempts = 0;
+    ws->last_reconnect_time = 0;
 }
 
 /**
  * @brief Calculate reconnection interval with exponential backoff
  */
-static uint32_t calculate_reconnect_interval(void) {
-    uint32_t interval = g_ws_ctx.reconnect_interval * (1 << g_ws_ctx.reconnect_attempts);
+static uint32_t calculate_reconnect_interval(ws_session_t *ws) {
+    uint32_t interval = ws->reconnect_interval * (1 << ws->reconnect_attempts);
     
-    if (interval > g_ws_ctx.max_reconnect_interval) {
-        interval = g_ws_ctx.max_reconnect_interval;
+    if (interval > ws->max_reconnect_interval) {
+        interval = ws->max_reconnect_interval;
     }
     
-    return interval;
+    return scale_by_hint(ws, interval);
 }
 
 /**
  * @brief Check if should attempt reconnection
  */
-static bool should_reconnect(void) {
-    if (!g_ws_ctx.auto_reconnect) {
+static bool should_reconnect(ws_session_t *ws) {
+    if (!ws->auto_reconnect) {
         return false;
     }
     
-    if (g_ws_ctx.reconnect_attempts >= WS_MAX_RECONNECT_ATTEMPTS) {
+    if (ws->reconnect_attempts >= WS_MAX_RECONNECT_ATTEMPTS) {
         return false;
     }
     
     uint32_t current_time = get_current_time_ms();
-    uint32_t interval = calculate_reconnect_interval();
+    uint32_t interval = calculate_reconnect_interval(ws);
+    
+    if (is_held_off(ws, current_time)) {
+        return false;
+    }
     
-    if (current_time - g_ws_ctx.last_reconnect_time < interval) {
+    if (current_time - ws->last_reconnect_time < interval) {
         return false;
     }
     
     return true;
 }
 
+/**
+ * @brief Release the oldest message of a queue
+ */
+static void queue_pop(ws_send_queue_t *queue) {
+    free(queue->slots[queue->head].buffer);
+    queue->slots[queue->head].buffer = NULL;
+    queue->head = (queue->head + 1) % WS_SEND_QUEUE_DEPTH;
+    queue->count--;
+    queue->stats.depth = (uint32_t)queue->count;
+}
+
+/**
+ * @brief Drop all queued messages (connection gone)
+ */
+static void flush_send_queues(ws_session_t *ws) {
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        ws_send_queue_t *queue = &ws->queues[i];
+        while (queue->count > 0) {
+            queue_pop(queue);
+            queue->stats.dropped++;
+        }
+        queue->credits = queue->weight;
+    }
+    ws->ping_pending = false;
+    ws->batching_active = false;  // Renegotiated on next connect
+}
+
 #ifndef TESTING
 /**
- * @brief libwebsockets callback
+ * @brief Check if a ping or any queued message is waiting
  */
-static int ws_callback(struct lws *wsi, enum lws_callback_reasons reason,
-                       void *user, void *in, size_t len) {
-    switch (reason) {
-        case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            change_state(WS_STATE_CONNECTED);
-            g_ws_ctx.reconnect_attempts = 0;
-            g_ws_ctx.last_ping_time = get_current_time_ms();
-            break;
-            
-        case LWS_CALLBACK_CLIENT_RECEIVE:
-            if (len > 0 && len < WS_MAX_MESSAGE_SIZE) {
-                memcpy(g_ws_ctx.recv_buffer, in, len);
-                g_ws_ctx.recv_buffer[len] = '\0';
-                g_ws_ctx.recv_buffer_len = len;
-                
-                if (g_ws_ctx.on_message != NULL) {
-                    // 修正: 添加 length 參數
-                    g_ws_ctx.on_message(g_ws_ctx.recv_buffer, len, g_ws_ctx.user_data);
+static bool has_pending_writes(ws_session_t *ws) {
+    if (ws->ping_pending) {
+        return true;
+    }
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        if (ws->queues[i].count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+/**
+ * @brief Pick the class to serve on this writable callback
+ * 
+ * @return Priority class, or -1 if all queues are empty
+ */
+static int select_queue(ws_session_t *ws) {
+    if (ws->sched_mode == WS_SCHED_WEIGHTED) {
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+                ws_send_queue_t *queue = &ws->queues[i];
+                if (queue->count > 0 && queue->credits > 0) {
+                    queue->credits--;
+                    return i;
                 }
             }
-            break;
-            
-        case LWS_CALLBACK_CLIENT_WRITEABLE:
-            if (g_ws_ctx.send_buffer_len > 0) {
-                unsigned char buf[LWS_PRE + WS_MAX_MESSAGE_SIZE];
-                memcpy(&buf[LWS_PRE], g_ws_ctx.send_buffer, g_ws_ctx.send_buffer_len);
-                
-                lws_write(wsi, &buf[LWS_PRE], g_ws_ctx.send_buffer_len, LWS_WRITE_TEXT);
-                g_ws_ctx.send_buffer_len = 0;
+            // Round exhausted: refill credits
+            for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+                ws->queues[i].credits = ws->queues[i].weight;
             }
-            break;
-            
-        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            logger_error("WebSocket connection error");
-            change_state(WS_STATE_ERROR);
-            break;
-            
-        case LWS_CALLBACK_CLOSED:
-            change_state(WS_STATE_DISCONNECTED);
-            g_ws_ctx.ws_connection = NULL;
-            break;
-            
-        case LWS_CALLBACK_CLIENT_RECEIVE_PONG:
-            g_ws_ctx.waiting_for_pong = false;
-            break;
-            
-        default:
-            break;
+        }
+        return -1;
     }
     
-    return 0;
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        if (ws->queues[i].count > 0) {
+            return i;
+        }
+    }
+    return -1;
 }
-#endif
 
 /**
- * @brief Attempt to connect to WebSocket server
+ * @brief Write one text frame
  */
-static int attempt_connect(void) {
+static int write_frame(ws_session_t *ws, unsigned char *buffer, size_t length) {
     #ifndef TESTING
-    struct lws_client_connect_info connect_info;
-    memset(&connect_info, 0, sizeof(connect_info));
-    
-    connect_info.context = g_ws_ctx.ws_context;
-    connect_info.address = g_ws_ctx.server_host;
-    connect_info.port = g_ws_ctx.server_port;
-    connect_info.path = "/";
-    connect_info.host = g_ws_ctx.server_host;
-    connect_info.origin = g_ws_ctx.server_host;
-    connect_info.protocol = NULL;
-    
-    g_ws_ctx.ws_connection = lws_client_connect_via_info(&connect_info);
-    
-    if (g_ws_ctx.ws_connection == NULL) {
-        logger_error("Failed to connect to WebSocket server");
+    if (ws->ws_connection == NULL) {
         return -1;
     }
+    int written = lws_write(ws->ws_connection, buffer + WS_SEND_HEADROOM,
+                            length, LWS_WRITE_TEXT);
+    return (written < (int)length) ? -1 : 0;
     #else
-    // Mock connection in test mode
-    g_ws_ctx.ws_connection = (void*)0x1234;  // Non-null pointer
-    change_state(WS_STATE_CONNECTED);
-    #endif
-    
+    if (ws->test_write != NULL) {
+        return ws->test_write((const char *)buffer, length);
+    }
     return 0;
+    #endif
 }
 
 /**
- * @brief Send ping to server
+ * @brief Account a message written to the socket
  */
-static void send_ping(void) {
-    #ifndef TESTING
-    if (g_ws_ctx.ws_connection != NULL) {
-        unsigned char buf[LWS_PRE + 125];
-        lws_write(g_ws_ctx.ws_connection, &buf[LWS_PRE], 0, LWS_WRITE_PING);
-        g_ws_ctx.waiting_for_pong = true;
+static void record_sent(ws_send_queue_t *queue, bool batched) {
+    ws_queued_msg_t *msg = &queue->slots[queue->head];
+    uint32_t wait_ms = get_current_time_ms() - msg->enqueue_time;
+    
+    queue->stats.sent++;
+    if (batched) {
+        queue->stats.batched++;
+    }
+    queue->stats.last_wait_ms = wait_ms;
+    queue->stats.total_wait_ms += wait_ms;
+    if (wait_ms > queue->stats.max_wait_ms) {
+        queue->stats.max_wait_ms = wait_ms;
     }
-    #endif
     
-    g_ws_ctx.last_ping_time = get_current_time_ms();
+    queue_pop(queue);
 }
 
-/* ============================================================
- *  Public API Implementation
- * ============================================================ */
-
-int ws_client_init(const char *server_host, int server_port) {
-    if (g_ws_ctx.initialized) {
-        return -1;  // Already initialized
+/**
+ * @brief Pack every ready message that fits into one envelope
+ * 
+ * Classes are drained in priority order, so control and interactive
+ * messages always ride in the first frame of the pass.
+ * 
+ * @return 0 if a batch was written, 1 if fewer than two messages fit,
+ *         -1 on write error
+ */
+static int write_batch(ws_session_t *ws) {
+    const size_t prefix_len = sizeof(BATCH_PREFIX) - 1;
+    const size_t suffix_len = sizeof(BATCH_SUFFIX) - 1;
+    unsigned char *out = ws->batch_buffer + WS_SEND_HEADROOM;
+    int taken[WS_PRIORITY_COUNT] = { 0 };
+    int packed = 0;
+    size_t len = prefix_len;
+    
+    memcpy(out, BATCH_PREFIX, prefix_len);
+    
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        ws_send_queue_t *queue = &ws->queues[i];
+        
+        for (; taken[i] < queue->count; taken[i]++) {
+            ws_queued_msg_t *msg = &queue->slots[(queue->head + taken[i]) % WS_SEND_QUEUE_DEPTH];
+            size_t separator = (packed > 0) ? 1 : 0;
+            
+            if (len + separator + msg->length + suffix_len > WS_MAX_MESSAGE_SIZE) {
+                goto full;
+            }
+            if (separator) {
+                out[len++] = ',';
+            }
+            memcpy(out + len, msg->buffer + WS_SEND_HEADROOM, msg->length);
+            len += msg->length;
+            packed++;
+        }
     }
     
-    if (server_host == NULL || server_port <= 0 || server_port > 65535) {
-        return -1;
+full:
+    if (packed < 2) {
+        return 1;
     }
     
-    // Copy server info
-    strncpy(g_ws_ctx.server_host, server_host, sizeof(g_ws_ctx.server_host) - 1);
-    g_ws_ctx.server_port = server_port;
+    memcpy(out + len, BATCH_SUFFIX, suffix_len);
+    len += suffix_len;
     
-    // Initialize state
-    g_ws_ctx.current_state = WS_STATE_DISCONNECTED;
-    g_ws_ctx.previous_state = WS_STATE_DISCONNECTED;
-    g_ws_ctx.reconnect_attempts = 0;
-    g_ws_ctx.send_buffer_len = 0;
-    g_ws_ctx.recv_buffer_len = 0;
+    if (write_frame(ws, ws->batch_buffer, len) < 0) {
+        #ifndef TESTING
+        logger_error("WebSocket batch write failed (%d messages)", packed);
+        #endif
+        return -1;
+    }
     
-    #ifndef TESTING
-    // Create libwebsockets context
-    struct lws_context_creation_info info;
-    memset(&info, 0, sizeof(info));
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        while (taken[i]-- > 0) {
+            record_sent(&ws->queues[i], true);
+        }
+    }
     
-    info.port = CONTEXT_PORT_NO_LISTEN;
-    info.protocols = NULL;
-    info.gid = -1;
-    info.uid = -1;
-    info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+    return 0;
+}
+
+/**
+ * @brief Serve one writable callback
+ * 
+ * @return 0 if a frame was written, -1 if nothing was pending or on error
+ */
+static int service_writable(ws_session_t *ws) {
+    #ifndef TESTING
+    // Protocol pings go ahead of all queued messages
+    if (ws->ping_pending && ws->ws_connection != NULL) {
+        unsigned char buf[LWS_PRE + 125];
+        ws->ping_pending = false;
+        lws_write(ws->ws_connection, &buf[LWS_PRE], 0, LWS_WRITE_PING);
+        ws->waiting_for_pong = true;
+        return 0;
+    }
+    #endif
     
-    g_ws_ctx.ws_context = lws_create_context(&info);
+    if (ws->batching_active) {
+        int result = write_batch(ws);
+        if (result <= 0) {
+            return result;
+        }
+    }
     
-    if (g_ws_ctx.ws_context == NULL) {
-        logger_error("Failed to create WebSocket context");
+    int index = select_queue(ws);
+    if (index < 0) {
         return -1;
     }
-    #else
-    g_ws_ctx.ws_context = (void*)0x5678;  // Mock context
-    #endif
     
-    g_ws_ctx.initialized = true;
+    ws_send_queue_t *queue = &ws->queues[index];
+    ws_queued_msg_t *msg = &queue->slots[queue->head];
     
-    #ifndef TESTING
-    logger_info("WebSocket client initialized: %s:%d", server_host, server_port);
-    #endif
+    if (write_frame(ws, msg->buffer, msg->length) < 0) {
+        #ifndef TESTING
+        logger_error("WebSocket write failed (%s)",
+                     ws_client_priority_to_string((ws_priority_t)index));
+        #endif
+        return -1;
+    }
     
+    record_sent(queue, false);
     return 0;
 }
 
-void ws_client_set_callbacks(ws_connected_callback_t on_connected,
-                             ws_disconnected_callback_t on_disconnected,
-                             ws_message_callback_t on_message,
-                             ws_error_callback_t on_error,
-                             void *user_data) {
-    g_ws_ctx.on_connected = on_connected;
-    g_ws_ctx.on_disconnected = on_disconnected;
-    g_ws_ctx.on_message = on_message;
-    g_ws_ctx.on_error = on_error;
-    g_ws_ctx.user_data = user_data;
+/**
+ * @brief Check a message type view against a name
+ */
+static bool type_is(const char *type, size_t type_len, const char *name) {
+    return type_len == strlen(name) && memcmp(type, name, type_len) == 0;
 }
 
-int ws_client_connect(void) {
-    if (!g_ws_ctx.initialized) {
+/**
+ * @brief Check if a message is a bare protocol acknowledgement
+ * 
+ * Acks carry no status for the application, which would only count them
+ * as unparsable replies.
+ */
+static bool is_protocol_ack(const char *message, size_t len) {
+    const char *type;
+    size_t type_len;
+    
+    return json_scan_find_top_string(message, len, "type", &type, &type_len) == 0 &&
+           (type_is(type, type_len, "ack") || type_is(type, type_len, "hello_ack"));
+}
+
+/**
+ * @brief Deliver one message to the application
+ */
+static void deliver_message(ws_session_t *ws, const char *message, size_t length) {
+    if (ws->on_message != NULL) {
+        // 修正: 添加 length 參數
+        ws->on_message(message, length, ws->user_data);
+    }
+}
+
+static void deliver_batch_element(const char *element, size_t length, void *user_data) {
+    if (!is_protocol_ack(element, length)) {
+        deliver_message((ws_session_t *)user_data, element, length);
+    }
+}
+
+static void match_batch_feature(const char *element, size_t length, void *user_data) {
+    if (length == 7 && memcmp(element, "\"batch\"", 7) == 0) {
+        *(bool *)user_data = true;
+    }
+}
+
+/**
+ * @brief Move the session to the server named in a redirect hint
+ * 
+ * @return 0 on success, -1 if the target is malformed
+ */
+static int apply_redirect(ws_session_t *ws, const char *target, size_t length) {
+    char host[sizeof(ws->server_host)];
+    int port = ws->server_port;
+    const char *colon = memchr(target, ':', length);
+    size_t host_len = colon != NULL ? (size_t)(colon - target) : length;
+    
+    if (host_len == 0 || host_len >= sizeof(host)) {
         return -1;
     }
     
-    if (g_ws_ctx.current_state == WS_STATE_CONNECTED ||
-        g_ws_ctx.current_state == WS_STATE_CONNECTING) {
-        return -1;  // Already connected or connecting
+    if (colon != NULL) {
+        char *end;
+        char digits[8];
+        size_t digits_len = length - host_len - 1;
+        
+        if (digits_len == 0 || digits_len >= sizeof(digits)) {
+            return -1;
+        }
+        memcpy(digits, colon + 1, digits_len);
+        digits[digits_len] = '\0';
+        long value = strtol(digits, &end, 10);
+        if (*end != '\0' || value <= 0 || value > 65535) {
+            return -1;
+        }
+        port = (int)value;
     }
     
-    change_state(WS_STATE_CONNECTING);
+    memcpy(host, target, host_len);
+    host[host_len] = '\0';
     
-    if (attempt_connect() < 0) {
-        change_state(WS_STATE_ERROR);
-        return -1;
-    }
+    #ifndef TESTING
+    logger_info("WebSocket server %s:%d redirects to %s:%d",
+                ws->server_host, ws->server_port, host, port);
+    #endif
+    
+    ws->hint.redirects++;
     
-    g_ws_ctx.last_reconnect_time = get_current_time_ms();
+    // Do not move the whole fleet onto the new server in the same instant
+    hold_off(ws, hint_jitter(ws, WS_HINT_REDIRECT_SPREAD_MS));
+    
+    // An owner keeps its own record of the server, let it do the move
+    if (ws->on_redirect != NULL) {
+        ws->on_redirect(host, port, ws->redirect_user_data);
+        return 0;
+    }
     
+    ws_session_disconnect(ws);
+    memcpy(ws->server_host, host, host_len + 1);
+    ws->server_port = port;
+    ws->redirect_reconnect = true;
     return 0;
 }
 
-int ws_client_send(const char *message) {
-    if (!g_ws_ctx.initialized || message == NULL) {
-        return -1;
-    }
+/**
+ * @brief Apply a load-shedding hint from the server
+ * 
+ * {"type":"hint", "retry_after_ms":N, "rate_percent":P, "mode":"push"|"poll",
+ *  "ttl_ms":T, "redirect":"host[:port]"}. Rate and mode replace the
+ * previous hint and revert after ttl_ms; absent fields mean normal pace.
+ */
+static void apply_hint(ws_session_t *ws, const char *message, size_t len) {
+    long value;
+    const char *str;
+    size_t str_len;
     
-    if (g_ws_ctx.current_state != WS_STATE_CONNECTED) {
-        return -1;  // Not connected
+    ws->hint.hints_received++;
+    
+    long rate = 100;
+    if (json_scan_find_top_int(message, len, "rate_percent", &value) == 0) {
+        rate = value < WS_HINT_MIN_RATE_PERCENT ? WS_HINT_MIN_RATE_PERCENT :
+               value > 100 ? 100 : value;
     }
     
-    size_t len = strlen(message);
-    if (len >= WS_MAX_MESSAGE_SIZE) {
-        return -1;  // Message too large
+    bool push_only = json_scan_find_top_string(message, len, "mode", &str, &str_len) == 0 &&
+                     str_len == 4 && memcmp(str, "push", 4) == 0;
+    
+    long ttl = WS_HINT_DEFAULT_TTL_MS;
+    if (json_scan_find_top_int(message, len, "ttl_ms", &value) == 0 && value > 0) {
+        ttl = value > WS_HINT_MAX_HOLD_MS ? WS_HINT_MAX_HOLD_MS : value;
     }
     
-    // Copy to send buffer
-    strncpy(g_ws_ctx.send_buffer, message, sizeof(g_ws_ctx.send_buffer) - 1);
-    g_ws_ctx.send_buffer_len = len;
+    ws->hint.rate_percent = (uint32_t)rate;
+    ws->hint.push_only = push_only;
+    ws->hint.active = rate < 100 || push_only;
+    ws->hint.expiry = get_current_time_ms() + (uint32_t)ttl;
     
-    #ifndef TESTING
-    // Request callback to send
-    if (g_ws_ctx.ws_connection != NULL) {
-        lws_callback_on_writable(g_ws_ctx.ws_connection);
+    if (json_scan_find_top_int(message, len, "retry_after_ms", &value) == 0 && value > 0) {
+        uint32_t delay = value > WS_HINT_MAX_HOLD_MS ? WS_HINT_MAX_HOLD_MS : (uint32_t)value;
+        // Up to a quarter more, so clients told the same thing return apart
+        hold_off(ws, delay + hint_jitter(ws, delay / 4 + 1));
     }
     
-    logger_debug("WebSocket message queued: %s", message);
+    #ifndef TESTING
+    logger_info("WebSocket hint from %s: rate %ld%%, %s, hold %s",
+                ws->server_host, rate, push_only ? "push-only" : "polling",
+                ws->hint.holding ? "yes" : "no");
     #endif
     
-    return 0;
+    if (json_scan_find_top_string(message, len, "redirect", &str, &str_len) == 0 &&
+        apply_redirect(ws, str, str_len) != 0) {
+        #ifndef TESTING
+        logger_warning("Ignoring malformed redirect from %s", ws->server_host);
+        #endif
+    }
 }
 
-int ws_client_service(int timeout_ms) {
-    if (!g_ws_ctx.initialized) {
-        return -1;
+/**
+ * @brief Handle a complete received message
+ * 
+ * Protocol messages (hello and its ack, other acks, batch, hint) are
+ * consumed here; everything else goes to the message callback as a view
+ * over the receive buffer.
+ */
+static void dispatch_message(ws_session_t *ws, const char *message, size_t len) {
+    const char *type;
+    size_t type_len;
+    
+    if (json_scan_find_top_string(message, len, "type", &type, &type_len) < 0) {
+        deliver_message(ws, message, len);
+        return;
+    }
+    
+    if (type_is(type, type_len, "hint")) {
+        apply_hint(ws, message, len);
+    } else if (type_is(type, type_len, "hello") || type_is(type, type_len, "hello_ack")) {
+        bool accepted = false;
+        json_scan_for_each_top_element(message, len, "features",
+                                       match_batch_feature, &accepted);
+        ws->batching_active = ws->batching_offered && accepted;
+        #ifndef TESTING
+        logger_info("WebSocket batching %s", ws->batching_active ? "enabled" : "disabled");
+        #endif
+    } else if (type_is(type, type_len, "batch")) {
+        if (json_scan_for_each_top_element(message, len, "messages",
+                                       deliver_batch_element, ws) < 0) {
+            #ifndef TESTING
+            logger_warning("Malformed batch from server (%zu bytes)", len);
+            #endif
+        }
+    } else if (!type_is(type, type_len, "ack")) {
+        deliver_message(ws, message, len);
+    }
+}
+
+/**
+ * @brief Handle one receive callback
+ * 
+ * A message that arrives in a single callback is dispatched straight from
+ * the caller's buffer. Only messages split across callbacks are copied,
+ * into a reassembly buffer that grows up to WS_MAX_REASSEMBLY_SIZE.
+ * 
+ * @param in Received bytes
+ * @param len Number of bytes
+ * @param final true if this completes the message
+ * @param binary true for binary messages (skips UTF-8 validation)
+ * @return 0 on success, -1 if the text is not valid UTF-8,
+ *         -2 if the message exceeds WS_MAX_REASSEMBLY_SIZE
+ */
+static int handle_receive(ws_session_t *ws, const char *in, size_t len, bool final, bool binary) {
+    if (!ws->rx_assembling && final) {
+        // RFC 6455 5.6: text frames must carry valid UTF-8
+        if (!binary && !json_scan_utf8_valid(in, len)) {
+            return -1;
+        }
+        if (len > 0) {
+            dispatch_message(ws, in, len);
+        }
+        return 0;
+    }
+    
+    size_t needed = ws->rx_buffer_len + len;
+    if (needed > WS_MAX_REASSEMBLY_SIZE) {
+        ws->rx_buffer_len = 0;
+        ws->rx_assembling = false;
+        return -2;
+    }
+    
+    if (needed > ws->rx_buffer_size) {
+        size_t size = ws->rx_buffer_size ? ws->rx_buffer_size : WS_MAX_MESSAGE_SIZE;
+        while (size < needed) {
+            size *= 2;
+        }
+        char *buffer = realloc(ws->rx_buffer, size);
+        if (buffer == NULL) {
+            ws->rx_buffer_len = 0;
+            ws->rx_assembling = false;
+            return -2;
+        }
+        ws->rx_buffer = buffer;
+        ws->rx_buffer_size = size;
+    }
+    
+    memcpy(ws->rx_buffer + ws->rx_buffer_len, in, len);
+    ws->rx_buffer_len = needed;
+    ws->rx_assembling = !final;
+    
+    if (final) {
+        ws->rx_buffer_len = 0;
+        if (!binary && !json_scan_utf8_valid(ws->rx_buffer, needed)) {
+            return -1;
+        }
+        dispatch_message(ws, ws->rx_buffer, needed);
+    }
+    
+    return 0;
+}
+
+#ifndef TESTING
+/**
+ * @brief libwebsockets callback
+ */
+static int ws_callback(struct lws *wsi, enum lws_callback_reasons reason,
+                       void *user, void *in, size_t len) {
+    // Each connection carries its session as user data
+    ws_session_t *ws = (user != NULL) ? (ws_session_t *)user : &g_ws_ctx;
+    
+    switch (reason) {
+        case LWS_CALLBACK_CLIENT_ESTABLISHED:
+            if (ws->ws_connection != wsi) {
+                return -1;  // Session was disconnected while connecting
+            }
+            change_state(ws, WS_STATE_CONNECTED);
+            ws->reconnect_attempts = 0;
+            ws->last_ping_time = get_current_time_ms();
+            break;
+            
+        case LWS_CALLBACK_CLIENT_RECEIVE: {
+            if (ws->ws_connection != wsi) {
+                return -1;  // Stale connection, finish closing it
+            }
+            bool final = lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0;
+            int result = handle_receive(ws, (const char *)in, len, final, lws_frame_is_binary(wsi));
+            
+            if (result == -1) {
+                logger_warning("WebSocket text message is not valid UTF-8, closing");
+                lws_close_reason(wsi, LWS_CLOSE_STATUS_INVALID_PAYLOAD, NULL, 0);
+                return -1;
+            } else if (result == -2) {
+                logger_warning("WebSocket message exceeds %d bytes, closing", WS_MAX_REASSEMBLY_SIZE);
+                lws_close_reason(wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL, 0);
+                return -1;
+            }
+            break;
+        }
+            
+        case LWS_CALLBACK_CLIENT_WRITEABLE:
+            if (ws->ws_connection != wsi) {
+                return -1;  // Stale connection, finish closing it
+            }
+            // One frame per callback, ask again while anything is pending
+            if (service_writable(ws) == 0 && has_pending_writes(ws)) {
+                lws_callback_on_writable(wsi);
+            }
+            break;
+            
+        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+            logger_error("WebSocket connection error: %s (%s)", ws->server_host,
+                         in != NULL ? (const char *)in : "no detail");
+            // A stale connection's error must not fail the current one
+            if (ws->ws_connection == wsi) {
+                handle_connection_error(ws, (const char *)in);
+            }
+            break;
+            
+        case LWS_CALLBACK_CLOSED:
+            if (ws->ws_connection == wsi) {
+                change_state(ws, WS_STATE_DISCONNECTED);
+                ws->ws_connection = NULL;
+                flush_send_queues(ws);
+            }
+            break;
+            
+        case LWS_CALLBACK_CLIENT_RECEIVE_PONG:
+            ws->waiting_for_pong = false;
+            break;
+            
+        default:
+            break;
     }
     
+    return 0;
+}
+
+/**
+ * @brief Protocol table; client connections bind to the first entry
+ */
+static const struct lws_protocols g_ws_protocols[] = {
+    { "gaming-client", ws_callback, 0, WS_MAX_MESSAGE_SIZE, 0, NULL, 0 },
+    { NULL, NULL, 0, 0, 0, NULL, 0 }
+};
+#endif
+
+/**
+ * @brief Attempt to connect to WebSocket server
+ */
+static int attempt_connect(ws_session_t *ws) {
     #ifndef TESTING
-    // Service libwebsockets
-    if (g_ws_ctx.ws_context != NULL) {
-        lws_service(g_ws_ctx.ws_context, timeout_ms);
+    struct lws_client_connect_info connect_info;
+    memset(&connect_info, 0, sizeof(connect_info));
+    
+    connect_info.context = ws->ws_context;
+    connect_info.address = ws->server_host;
+    connect_info.port = ws->server_port;
+    connect_info.path = "/";
+    connect_info.host = ws->server_host;
+    connect_info.origin = ws->server_host;
+    connect_info.protocol = NULL;
+    connect_info.userdata = ws;
+    
+    // Set before lws can report an error from inside the connect call
+    connect_info.pwsi = &ws->ws_connection;
+    
+    ws->ws_connection = lws_client_connect_via_info(&connect_info);
+    
+    if (ws->ws_connection == NULL) {
+        logger_error("Failed to connect to WebSocket server");
+        return -1;
+    }
+    #else
+    // Mock connection in test mode
+    ws->ws_connection = (void*)0x1234;  // Non-null pointer
+    change_state(ws, WS_STATE_CONNECTED);
+    #endif
+    
+    return 0;
+}
+
+/**
+ * @brief Send ping to server
+ */
+static void send_ping(ws_session_t *ws) {
+    #ifndef TESTING
+    if (ws->ws_connection != NULL) {
+        // Written from the next writable callback, ahead of queued messages
+        ws->ping_pending = true;
+        lws_callback_on_writable(ws->ws_connection);
     }
     #endif
     
+    ws->last_ping_time = get_current_time_ms();
+}
+
+/**
+ * @brief Run reconnection and heartbeat of one session
+ */
+static void service_session(ws_session_t *ws) {
+    // Rate and push-only hints lapse unless the server renews them
+    if (ws->hint.active && (int32_t)(get_current_time_ms() - ws->hint.expiry) >= 0) {
+        ws->hint.active = false;
+        ws->hint.rate_percent = 100;
+        ws->hint.push_only = false;
+        #ifndef TESTING
+        logger_info("WebSocket hint from %s expired, normal pace", ws->server_host);
+        #endif
+    }
+    
+    // Follow a redirect once its hold-off is over
+    if (ws->redirect_reconnect && ws->current_state == WS_STATE_DISCONNECTED &&
+        !is_held_off(ws, get_current_time_ms())) {
+        ws->redirect_reconnect = false;
+        ws_session_connect(ws);
+    }
+    
     // Handle reconnection
-    if (g_ws_ctx.current_state == WS_STATE_DISCONNECTED ||
-        g_ws_ctx.current_state == WS_STATE_ERROR) {
-        if (should_reconnect()) {
+    if (ws->current_state == WS_STATE_DISCONNECTED ||
+        ws->current_state == WS_STATE_ERROR) {
+        if (should_reconnect(ws)) {
             #ifndef TESTING
-            logger_info("Attempting WebSocket reconnection (attempt %d/%d)",
-                    g_ws_ctx.reconnect_attempts + 1, WS_MAX_RECONNECT_ATTEMPTS);
+            logger_info("Attempting WebSocket reconnection to %s (attempt %d/%d)",
+                    ws->server_host, ws->reconnect_attempts + 1, WS_MAX_RECONNECT_ATTEMPTS);
             #endif
             
-            g_ws_ctx.reconnect_attempts++;
-            g_ws_ctx.last_reconnect_time = get_current_time_ms();
+            ws->reconnect_attempts++;
+            ws->last_reconnect_time = get_current_time_ms();
             
-            if (ws_client_connect() < 0) {
-                change_state(WS_STATE_ERROR);
+            if (ws_session_connect(ws) < 0) {
+                fail_session(ws, WS_ERROR_CONNECT, "Reconnect failed");
             }
         }
     }
     
     // Handle heartbeat
-    if (g_ws_ctx.current_state == WS_STATE_CONNECTED) {
+    if (ws->current_state == WS_STATE_CONNECTED) {
         uint32_t current_time = get_current_time_ms();
         
-        if (current_time - g_ws_ctx.last_ping_time >= g_ws_ctx.ping_interval) {
-            send_ping();
+        if (current_time - ws->last_ping_time >= scale_by_hint(ws, ws->ping_interval)) {
+            send_ping(ws);
         }
         
         // Check for pong timeout
-        if (g_ws_ctx.waiting_for_pong &&
-            current_time - g_ws_ctx.last_ping_time >= WS_PING_TIMEOUT_MS) {
+        if (ws->waiting_for_pong &&
+            current_time - ws->last_ping_time >= WS_PING_TIMEOUT_MS) {
             #ifndef TESTING
-            logger_warning("WebSocket pong timeout, disconnecting");
+            logger_warning("WebSocket pong timeout from %s, disconnecting", ws->server_host);
             #endif
-            ws_client_disconnect();
+            if (ws->on_error != NULL) {
+                ws->on_error(WS_ERROR_PONG_TIMEOUT, "Pong timeout", ws->user_data);
+            }
+            ws_session_disconnect(ws);
         }
     }
+}
+
+/**
+ * @brief Release the receive buffer of a session
+ */
+static void free_rx_buffer(ws_session_t *ws) {
+    free(ws->rx_buffer);
+    ws->rx_buffer = NULL;
+    ws->rx_buffer_size = 0;
+    ws->rx_buffer_len = 0;
+    ws->rx_assembling = false;
+}
+
+/**
+ * @brief Create the libwebsockets context shared by all sessions
+ */
+static int create_context(void) {
+    #ifndef TESTING
+    struct lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+    
+    info.port = CONTEXT_PORT_NO_LISTEN;
+    info.protocols = g_ws_protocols;
+    info.gid = -1;
+    info.uid = -1;
+    info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+    
+    g_ws_ctx.ws_context = lws_create_context(&info);
+    
+    if (g_ws_ctx.ws_context == NULL) {
+        logger_error("Failed to create WebSocket context");
+        return -1;
+    }
+    #else
+    g_ws_ctx.ws_context = (void*)0x5678;  // Mock context
+    #endif
+    
+    // Extra sessions borrow the primary's context
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        g_ws_sessions[i].ws_context = g_ws_ctx.ws_context;
+    }
     
     return 0;
 }
 
-// 修正: 返回值改為 int
-int ws_client_disconnect(void) {
+/**
+ * @brief Destroy the shared libwebsockets context
+ */
+static void destroy_context(void) {
+    #ifndef TESTING
+    if (g_ws_ctx.ws_context != NULL) {
+        lws_context_destroy(g_ws_ctx.ws_context);
+    }
+    #endif
+    
+    g_ws_ctx.ws_context = NULL;
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        g_ws_sessions[i].ws_context = NULL;
+    }
+}
+
+/**
+ * @brief Reset a free session slot for a new server
+ * 
+ * Default scheduling, no batching offer and no auto-reconnect; the
+ * owner decides when to connect.
+ */
+static void reset_session(ws_session_t *ws, const char *server_host, int server_port) {
+    memset(ws, 0, sizeof(*ws));
+    strncpy(ws->server_host, server_host, sizeof(ws->server_host) - 1);
+    ws->server_port = server_port;
+    ws->current_state = WS_STATE_DISCONNECTED;
+    ws->previous_state = WS_STATE_DISCONNECTED;
+    ws->auto_reconnect = false;
+    ws->reconnect_interval = WS_RECONNECT_INTERVAL_MS;
+    ws->max_reconnect_interval = WS_MAX_RECONNECT_INTERVAL_MS;
+    ws->ping_interval = WS_PING_INTERVAL_MS;
+    
+    ws->sched_mode = WS_SCHED_STRICT;
+    ws->queues[WS_PRIORITY_CONTROL].weight = WS_WEIGHT_CONTROL;
+    ws->queues[WS_PRIORITY_INTERACTIVE].weight = WS_WEIGHT_INTERACTIVE;
+    ws->queues[WS_PRIORITY_BACKGROUND].weight = WS_WEIGHT_BACKGROUND;
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        ws->queues[i].credits = ws->queues[i].weight;
+    }
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+int ws_client_init(const char *server_host, int server_port) {
+    ws_session_t *ws = &g_ws_ctx;
+    
+    if (ws->initialized) {
+        return -1;  // Already initialized
+    }
+    
+    if (server_host == NULL || server_port <= 0 || server_port > 65535) {
+        return -1;
+    }
+    
+    // Copy server info
+    strncpy(ws->server_host, server_host, sizeof(ws->server_host) - 1);
+    ws->server_port = server_port;
+    
+    // Initialize state
+    ws->current_state = WS_STATE_DISCONNECTED;
+    ws->previous_state = WS_STATE_DISCONNECTED;
+    ws->reconnect_attempts = 0;
+    ws->rx_buffer_len = 0;
+    ws->rx_assembling = false;
+    memset(&ws->hint, 0, sizeof(ws->hint));
+    flush_send_queues(ws);
+    
+    if (create_context() < 0) {
+        return -1;
+    }
+    
+    ws->initialized = true;
+    
+    #ifndef TESTING
+    logger_info("WebSocket client initialized: %s:%d", server_host, server_port);
+    #endif
+    
+    return 0;
+}
+
+void ws_client_set_callbacks(ws_connected_callback_t on_connected,
+                             ws_disconnected_callback_t on_disconnected,
+                             ws_message_callback_t on_message,
+                             ws_error_callback_t on_error,
+                             void *user_data) {
+    ws_session_set_callbacks(&g_ws_ctx, on_connected, on_disconnected,
+                             on_message, on_error, user_data);
+}
+
+void ws_client_set_redirect_callback(ws_redirect_callback_t on_redirect, void *user_data) {
+    ws_session_set_redirect_callback(&g_ws_ctx, on_redirect, user_data);
+}
+
+int ws_client_set_server(const char *server_host, int server_port) {
+    return ws_session_set_server(&g_ws_ctx, server_host, server_port);
+}
+
+int ws_client_connect(void) {
+    return ws_session_connect(&g_ws_ctx);
+}
+
+int ws_client_get_hint_state(ws_hint_state_t *state) {
+    return ws_session_get_hint_state(&g_ws_ctx, state);
+}
+
+int ws_client_send(const char *message) {
+    return ws_client_send_with_priority(message, WS_PRIORITY_INTERACTIVE);
+}
+
+int ws_client_send_with_priority(const char *message, ws_priority_t priority) {
+    return ws_session_send_with_priority(&g_ws_ctx, message, priority);
+}
+
+char* ws_client_retain(const char *message, size_t length) {
+    if (message == NULL) {
+        return NULL;
+    }
+    
+    char *copy = malloc(length + 1);
+    if (copy == NULL) {
+        return NULL;
+    }
+    
+    memcpy(copy, message, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void ws_client_release(char *message) {
+    free(message);
+}
+
+int ws_client_query_ps5_status(void) {
+    return ws_session_query_ps5_status(&g_ws_ctx);
+}
+
+int ws_client_send_heartbeat(void) {
+    return ws_client_send_with_priority("{\"type\":\"heartbeat\"}", WS_PRIORITY_CONTROL);
+}
+
+void ws_client_set_batching(bool enable) {
+    g_ws_ctx.batching_offered = enable;
+    if (!enable) {
+        g_ws_ctx.batching_active = false;
+    }
+}
+
+bool ws_client_is_batching(void) {
+    return g_ws_ctx.batching_active;
+}
+
+int ws_client_set_scheduling(ws_sched_mode_t mode, const uint8_t weights[WS_PRIORITY_COUNT]) {
+    if (mode != WS_SCHED_STRICT && mode != WS_SCHED_WEIGHTED) {
+        return -1;
+    }
+    
+    static const uint8_t default_weights[WS_PRIORITY_COUNT] = {
+        WS_WEIGHT_CONTROL, WS_WEIGHT_INTERACTIVE, WS_WEIGHT_BACKGROUND
+    };
+    if (weights == NULL) {
+        weights = default_weights;
+    }
+    
+    g_ws_ctx.sched_mode = mode;
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        // A zero weight would starve the class
+        g_ws_ctx.queues[i].weight = (weights[i] > 0) ? weights[i] : 1;
+        g_ws_ctx.queues[i].credits = g_ws_ctx.queues[i].weight;
+    }
+    
+    return 0;
+}
+
+int ws_client_get_queue_stats(ws_priority_t priority, ws_queue_stats_t *stats) {
+    if (stats == NULL || priority < 0 || priority >= WS_PRIORITY_COUNT) {
+        return -1;
+    }
+    
+    *stats = g_ws_ctx.queues[priority].stats;
+    return 0;
+}
+
+int ws_client_service(int timeout_ms) {
     if (!g_ws_ctx.initialized) {
         return -1;
     }
     
     #ifndef TESTING
-    if (g_ws_ctx.ws_connection != NULL) {
-        lws_close_reason(g_ws_ctx.ws_connection, LWS_CLOSE_STATUS_NORMAL, NULL, 0);
-        g_ws_ctx.ws_connection = NULL;
+    // Service libwebsockets (all sessions share the context)
+    if (g_ws_ctx.ws_context != NULL) {
+        lws_service(g_ws_ctx.ws_context, timeout_ms);
     }
-    #else
-    g_ws_ctx.ws_connection = NULL;
     #endif
     
-    change_state(WS_STATE_DISCONNECTED);
-    g_ws_ctx.auto_reconnect = false;
+    service_session(&g_ws_ctx);
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        if (g_ws_sessions[i].initialized) {
+            service_session(&g_ws_sessions[i]);
+        }
+    }
     
     return 0;
 }
 
-void ws_client_cleanup(void) {
+// 修正: 返回值改為 int
+int ws_client_disconnect(void) {
+    return ws_session_disconnect(&g_ws_ctx);
+}
+
+int ws_client_suspend(void) {
     if (!g_ws_ctx.initialized) {
-        return;
+        return -1;
     }
     
-    // Disconnect first
-    ws_client_disconnect();
+    if (g_ws_ctx.ws_context == NULL) {
+        return 0;  // Already suspended
+    }
+    
+    ws_session_t *all[WS_MAX_SESSIONS] = { &g_ws_ctx };
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        all[i + 1] = &g_ws_sessions[i];
+    }
+    
+    for (int i = 0; i < WS_MAX_SESSIONS; i++) {
+        if (all[i]->initialized &&
+            (all[i]->current_state == WS_STATE_CONNECTED ||
+             all[i]->current_state == WS_STATE_CONNECTING)) {
+            return -1;  // A session still uses the context
+        }
+    }
+    
+    for (int i = 0; i < WS_MAX_SESSIONS; i++) {
+        if (all[i]->initialized) {
+            flush_send_queues(all[i]);
+            free_rx_buffer(all[i]);
+        }
+    }
+    destroy_context();
     
     #ifndef TESTING
-    // Destroy context
+    logger_info("WebSocket context suspended while idle");
+    #endif
+    
+    return 0;
+}
+
+int ws_client_resume(void) {
+    if (!g_ws_ctx.initialized) {
+        return -1;
+    }
+    
     if (g_ws_ctx.ws_context != NULL) {
-        lws_context_destroy(g_ws_ctx.ws_context);
-        g_ws_ctx.ws_context = NULL;
+        return 0;  // Not suspended
+    }
+    
+    return create_context();
+}
+
+bool ws_client_is_suspended(void) {
+    return g_ws_ctx.initialized && g_ws_ctx.ws_context == NULL;
+}
+
+void ws_client_cleanup(void) {
+    ws_session_t *ws = &g_ws_ctx;
+    
+    if (!ws->initialized) {
+        return;
     }
-    #else
-    g_ws_ctx.ws_context = NULL;
-    #endif
+    
+    // Extra sessions borrow the context, close them first
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        ws_session_close(&g_ws_sessions[i]);
+    }
+    
+    // Disconnect first
+    ws_client_disconnect();
+    
+    destroy_context();
     
     // Reset state
-    g_ws_ctx.initialized = false;
-    g_ws_ctx.current_state = WS_STATE_DISCONNECTED;
-    g_ws_ctx.on_connected = NULL;
-    g_ws_ctx.on_disconnected = NULL;
-    g_ws_ctx.on_error = NULL;
-    g_ws_ctx.on_message = NULL;
-    g_ws_ctx.user_data = NULL;
+    ws->initialized = false;
+    ws->current_state = WS_STATE_DISCONNECTED;
+    ws->on_connected = NULL;
+    ws->on_disconnected = NULL;
+    ws->on_error = NULL;
+    ws->on_message = NULL;
+    ws->user_data = NULL;
+    
+    // Reset scheduling and queue statistics
+    ws_client_set_scheduling(WS_SCHED_STRICT, NULL);
+    for (int i = 0; i < WS_PRIORITY_COUNT; i++) {
+        memset(&ws->queues[i].stats, 0, sizeof(ws->queues[i].stats));
+    }
+    ws->batching_offered = false;
+    
+    free_rx_buffer(ws);
+    
+    #ifdef TESTING
+    ws->test_write = NULL;
+    #endif
     
     #ifndef TESTING
     logger_info("WebSocket client cleaned up");
@@ -516,6 +1414,273 @@ void ws_client_set_auto_reconnect(bool enable) {
     g_ws_ctx.auto_reconnect = enable;
 }
 
+/* ============================================================
+ *  Extra Sessions
+ * ============================================================ */
+
+ws_session_t* ws_session_open(const char *server_host, int server_port) {
+    if (!g_ws_ctx.initialized) {
+        return NULL;
+    }
+    
+    if (server_host == NULL || server_port <= 0 || server_port > 65535) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        ws_session_t *ws = &g_ws_sessions[i];
+        
+        if (ws->initialized) {
+            continue;
+        }
+        
+        reset_session(ws, server_host, server_port);
+        
+        // Same scheduling and feature offer as the primary session
+        ws->sched_mode = g_ws_ctx.sched_mode;
+        for (int j = 0; j < WS_PRIORITY_COUNT; j++) {
+            ws->queues[j].weight = g_ws_ctx.queues[j].weight;
+            ws->queues[j].credits = ws->queues[j].weight;
+        }
+        ws->batching_offered = g_ws_ctx.batching_offered;
+        
+        ws->ws_context = g_ws_ctx.ws_context;
+        ws->initialized = true;
+        
+        #ifndef TESTING
+        logger_info("WebSocket session opened: %s:%d", server_host, server_port);
+        #endif
+        
+        return ws;
+    }
+    
+    return NULL;
+}
+
+void ws_session_set_callbacks(ws_session_t *ws,
+                              ws_connected_callback_t on_connected,
+                              ws_disconnected_callback_t on_disconnected,
+                              ws_message_callback_t on_message,
+                              ws_error_callback_t on_error,
+                              void *user_data) {
+    if (ws == NULL) {
+        return;
+    }
+    
+    ws->on_connected = on_connected;
+    ws->on_disconnected = on_disconnected;
+    ws->on_message = on_message;
+    ws->on_error = on_error;
+    ws->user_data = user_data;
+}
+
+void ws_session_set_redirect_callback(ws_session_t *ws, ws_redirect_callback_t on_redirect,
+                                      void *user_data) {
+    if (ws == NULL) {
+        return;
+    }
+    
+    ws->on_redirect = on_redirect;
+    ws->redirect_user_data = user_data;
+}
+
+int ws_session_set_server(ws_session_t *ws, const char *server_host, int server_port) {
+    if (ws == NULL || !ws->initialized || server_host == NULL || server_host[0] == '\0' ||
+        strlen(server_host) >= sizeof(ws->server_host) ||
+        server_port <= 0 || server_port > 65535) {
+        return -1;
+    }
+    
+    if (ws->current_state != WS_STATE_DISCONNECTED && ws->current_state != WS_STATE_ERROR) {
+        return -1;  // Link in use
+    }
+    
+    strcpy(ws->server_host, server_host);
+    ws->server_port = server_port;
+    
+    #ifndef TESTING
+    logger_info("WebSocket server set to %s:%d", server_host, server_port);
+    #endif
+    
+    return 0;
+}
+
+int ws_session_connect(ws_session_t *ws) {
+    if (ws == NULL || !ws->initialized) {
+        return -1;
+    }
+    
+    if (ws->current_state == WS_STATE_CONNECTED ||
+        ws->current_state == WS_STATE_CONNECTING) {
+        return -1;  // Already connected or connecting
+    }
+    
+    // Rebuild the context after an idle suspend
+    if (g_ws_ctx.ws_context == NULL && ws_client_resume() < 0) {
+        return -1;
+    }
+    
+    if (is_held_off(ws, get_current_time_ms())) {
+        #ifndef TESTING
+        logger_warning("WebSocket connect to %s held off by server for %u ms", ws->server_host,
+                       ws->hint.hold_until - get_current_time_ms());
+        #endif
+        return -1;
+    }
+    
+    change_state(ws, WS_STATE_CONNECTING);
+    
+    if (attempt_connect(ws) < 0) {
+        // An error reported from inside the connect call has failed it already
+        if (ws->current_state != WS_STATE_ERROR) {
+            fail_session(ws, WS_ERROR_CONNECT, "Connect could not be started");
+        }
+        return -1;
+    }
+    
+    ws->last_reconnect_time = get_current_time_ms();
+    
+    return 0;
+}
+
+int ws_session_send_with_priority(ws_session_t *ws, const char *message,
+                                  ws_priority_t priority) {
+    if (ws == NULL || !ws->initialized || message == NULL) {
+        return -1;
+    }
+    
+    if (priority < 0 || priority >= WS_PRIORITY_COUNT) {
+        return -1;
+    }
+    
+    if (ws->current_state != WS_STATE_CONNECTED) {
+        return -1;  // Not connected
+    }
+    
+    size_t len = strlen(message);
+    if (len >= WS_MAX_MESSAGE_SIZE) {
+        return -1;  // Message too large
+    }
+    
+    ws_send_queue_t *queue = &ws->queues[priority];
+    
+    if (queue->count >= WS_SEND_QUEUE_DEPTH) {
+        queue->stats.dropped++;
+        if (priority != WS_PRIORITY_BACKGROUND) {
+            return -1;  // Queue full
+        }
+        queue_pop(queue);  // Stale telemetry makes room for fresh
+    }
+    
+    unsigned char *buffer = malloc(WS_SEND_HEADROOM + len);
+    if (buffer == NULL) {
+        queue->stats.dropped++;
+        return -1;
+    }
+    memcpy(buffer + WS_SEND_HEADROOM, message, len);
+    
+    int tail = (queue->head + queue->count) % WS_SEND_QUEUE_DEPTH;
+    queue->slots[tail].buffer = buffer;
+    queue->slots[tail].length = len;
+    queue->slots[tail].enqueue_time = get_current_time_ms();
+    queue->count++;
+    
+    queue->stats.enqueued++;
+    queue->stats.depth = (uint32_t)queue->count;
+    if (queue->stats.depth > queue->stats.max_depth) {
+        queue->stats.max_depth = queue->stats.depth;
+    }
+    
+    #ifndef TESTING
+    // Request callback to send
+    if (ws->ws_connection != NULL) {
+        lws_callback_on_writable(ws->ws_connection);
+    }
+    
+    logger_debug("WebSocket message queued (%s, depth %d): %s",
+                 ws_client_priority_to_string(priority), queue->count, message);
+    #endif
+    
+    return 0;
+}
+
+int ws_session_query_ps5_status(ws_session_t *ws) {
+    if (ws != NULL && ws->hint.active && ws->hint.push_only &&
+        ws->current_state == WS_STATE_CONNECTED) {
+        return 0;  // Server pushes the status itself
+    }
+    return ws_session_send_with_priority(ws, "{\"type\":\"query_ps5\"}", WS_PRIORITY_INTERACTIVE);
+}
+
+int ws_session_get_hint_state(const ws_session_t *ws, ws_hint_state_t *state) {
+    if (ws == NULL || state == NULL) {
+        return -1;
+    }
+    
+    uint32_t now = get_current_time_ms();
+    memset(state, 0, sizeof(*state));
+    
+    if (ws->hint.holding && (int32_t)(ws->hint.hold_until - now) > 0) {
+        state->hold_remaining_ms = ws->hint.hold_until - now;
+    }
+    state->rate_percent = ws->hint.active ? ws->hint.rate_percent : 100;
+    state->push_only = ws->hint.active && ws->hint.push_only;
+    if (ws->hint.active && (int32_t)(ws->hint.expiry - now) > 0) {
+        state->expires_in_ms = ws->hint.expiry - now;
+    }
+    state->hints_received = ws->hint.hints_received;
+    state->redirects = ws->hint.redirects;
+    
+    return 0;
+}
+
+ws_state_t ws_session_get_state(const ws_session_t *ws) {
+    if (ws == NULL) {
+        return WS_STATE_DISCONNECTED;
+    }
+    return ws->current_state;
+}
+
+int ws_session_disconnect(ws_session_t *ws) {
+    if (ws == NULL || !ws->initialized) {
+        return -1;
+    }
+    
+    #ifndef TESTING
+    if (ws->ws_connection != NULL) {
+        // The callback sees a stale connection on its next writable and
+        // closes it, instead of waiting for the server
+        lws_close_reason(ws->ws_connection, LWS_CLOSE_STATUS_NORMAL, NULL, 0);
+        lws_callback_on_writable(ws->ws_connection);
+        ws->ws_connection = NULL;
+    }
+    #else
+    ws->ws_connection = NULL;
+    #endif
+    
+    flush_send_queues(ws);
+    change_state(ws, WS_STATE_DISCONNECTED);
+    ws->auto_reconnect = false;
+    ws->redirect_reconnect = false;
+    
+    return 0;
+}
+
+void ws_session_close(ws_session_t *ws) {
+    if (ws == NULL || ws == &g_ws_ctx || !ws->initialized) {
+        return;
+    }
+    
+    ws->on_disconnected = NULL;  // Owner is going away
+    ws_session_disconnect(ws);
+    free_rx_buffer(ws);
+    ws->initialized = false;
+    
+    #ifndef TESTING
+    logger_info("WebSocket session closed: %s:%d", ws->server_host, ws->server_port);
+    #endif
+}
+
 const char* ws_client_state_to_string(ws_state_t state) {
     switch (state) {
         case WS_STATE_DISCONNECTED: return "DISCONNECTED";
@@ -537,6 +1702,48 @@ const char* ws_client_error_to_string(ws_error_t error) {
         case WS_ERROR_TIMEOUT:              return "TIMEOUT";
         case WS_ERROR_PROTOCOL:             return "PROTOCOL_ERROR";
         case WS_ERROR_CLOSED:               return "CONNECTION_CLOSED";
+        case WS_ERROR_DNS:                  return "DNS_FAILED";
+        case WS_ERROR_REFUSED:              return "CONNECTION_REFUSED";
+        case WS_ERROR_HANDSHAKE:            return "HANDSHAKE_FAILED";
+        case WS_ERROR_PONG_TIMEOUT:         return "PONG_TIMEOUT";
         default:                            return "UNKNOWN_ERROR";
     }
 }
+
+const char* ws_client_priority_to_string(ws_priority_t priority) {
+    switch (priority) {
+        case WS_PRIORITY_CONTROL:           return "CONTROL";
+        case WS_PRIORITY_INTERACTIVE:       return "INTERACTIVE";
+        case WS_PRIORITY_BACKGROUND:        return "BACKGROUND";
+        default:                            return "UNKNOWN";
+    }
+}
+
+#ifdef TESTING
+void ws_client_set_test_writer(ws_test_write_fn write_fn) {
+    g_ws_ctx.test_write = write_fn;
+}
+
+int ws_client_test_writable(void) {
+    return service_writable(&g_ws_ctx);
+}
+
+int ws_client_test_receive(const char *data, size_t length, bool final) {
+    return handle_receive(&g_ws_ctx, data, length, final, false);
+}
+
+int ws_session_test_receive(ws_session_t *session, const char *data, size_t length, bool final) {
+    if (session == NULL) {
+        return -1;
+    }
+    return handle_receive(session, data, length, final, false);
+}
+
+void ws_client_test_connection_error(const char *detail) {
+    handle_connection_error(&g_ws_ctx, detail);
+}
+
+void ws_client_test_end_hold(void) {
+    g_ws_ctx.hint.hold_until = get_current_time_ms();
+}
+#endif
@@ -8,6 +8,11 @@
  * - Send/receive JSON messages
  * - Auto-reconnect with exponential backoff
  * - Ping/Pong heartbeat
+ * - Prioritized outbound queues (control, interactive, background)
+ * - Optional batch envelopes negotiated with the server
+ * - Extra sessions to further servers on the same event loop
+ * - Server load-shedding hints (retry-after, slower pace, push-only, redirect)
+ * - Idle suspend of the libwebsockets context, rebuilt on next connect
  * 
  * @author Gaming System Development Team
  * @date 2025-11-03
@@ -41,6 +46,9 @@ extern "C" {
 /** Maximum message size in bytes */
 #define WS_MAX_MESSAGE_SIZE         4096
 
+/** Maximum size of a received message split across callbacks */
+#define WS_MAX_REASSEMBLY_SIZE      (64 * 1024)
+
 /** Connection timeout in milliseconds */
 #define WS_CONNECT_TIMEOUT_MS       10000
 
@@ -66,6 +74,29 @@ extern "C" {
 /** Reconnect backoff multiplier */
 #define WS_RECONNECT_BACKOFF        2
 
+/** Outbound queue depth per priority class */
+#define WS_SEND_QUEUE_DEPTH         16
+
+/** Default weighted round robin weights (messages per round) */
+#define WS_WEIGHT_CONTROL           4
+#define WS_WEIGHT_INTERACTIVE       4
+#define WS_WEIGHT_BACKGROUND        1
+
+/** Maximum open sessions, primary included */
+#define WS_MAX_SESSIONS             4
+
+/** Lifetime of a rate or push-only hint that gives no ttl_ms */
+#define WS_HINT_DEFAULT_TTL_MS      300000
+
+/** Longest hold-off or hint lifetime accepted from the server */
+#define WS_HINT_MAX_HOLD_MS         3600000
+
+/** Slowest pace a server may ask for, in percent of normal */
+#define WS_HINT_MIN_RATE_PERCENT    5
+
+/** Window over which redirected clients spread their reconnects */
+#define WS_HINT_REDIRECT_SPREAD_MS  5000
+
 /* ============================================================
  *  Type Definitions
  * ============================================================ */
@@ -93,14 +124,40 @@ typedef enum {
     WS_ERROR_TIMEOUT,               /**< Operation timed out */
     WS_ERROR_PROTOCOL,              /**< Protocol error */
     WS_ERROR_CLOSED,                /**< Connection closed */
+    WS_ERROR_DNS,                   /**< Server name did not resolve */
+    WS_ERROR_REFUSED,               /**< Server refused the connection */
+    WS_ERROR_HANDSHAKE,             /**< TLS or WebSocket upgrade failed */
+    WS_ERROR_PONG_TIMEOUT,          /**< Server stopped answering pings */
 } ws_error_t;
 
+/**
+ * @brief Outbound message priority classes
+ * 
+ * Lower values are served first.
+ */
+typedef enum {
+    WS_PRIORITY_CONTROL = 0,        /**< Heartbeats and session control */
+    WS_PRIORITY_INTERACTIVE,        /**< User-triggered queries */
+    WS_PRIORITY_BACKGROUND,         /**< Telemetry and bulk uploads */
+    WS_PRIORITY_COUNT,
+} ws_priority_t;
+
+/**
+ * @brief Outbound queue scheduling modes
+ */
+typedef enum {
+    WS_SCHED_STRICT = 0,            /**< Always serve highest non-empty class */
+    WS_SCHED_WEIGHTED,              /**< Weighted round robin across classes */
+} ws_sched_mode_t;
+
 /**
  * @brief WebSocket message callback
  * 
- * Called when a message is received from the server.
+ * Called when a message is received from the server. The message is a
+ * view over the receive buffer: it is not null-terminated and is only
+ * valid until the callback returns. Use ws_client_retain() to keep it.
  * 
- * @param message Message content (null-terminated string)
+ * @param message Message content (length bytes, not null-terminated)
  * @param length Message length in bytes
  * @param user_data User-provided data pointer
  */
@@ -140,6 +197,19 @@ typedef void (*ws_error_callback_t)(ws_error_t error,
                                     const char *message, 
                                     void *user_data);
 
+/**
+ * @brief WebSocket redirect callback
+ * 
+ * Called when the server's hint redirects the session to another server.
+ * The session is left as it is: the owner moves it (see
+ * ws_session_set_server()) and reconnects when it suits it.
+ * 
+ * @param host Target hostname or IP address
+ * @param port Target port number
+ * @param user_data User-provided data pointer
+ */
+typedef void (*ws_redirect_callback_t)(const char *host, int port, void *user_data);
+
 /**
  * @brief WebSocket client configuration
  */
@@ -164,6 +234,55 @@ typedef struct {
     uint32_t last_ping_ms;          /**< Last ping round-trip time */
 } ws_stats_t;
 
+/**
+ * @brief Outbound queue statistics for one priority class
+ */
+typedef struct {
+    uint32_t depth;                 /**< Messages currently queued */
+    uint32_t max_depth;             /**< Highest depth observed */
+    uint32_t enqueued;              /**< Messages accepted */
+    uint32_t sent;                  /**< Messages written to the socket */
+    uint32_t batched;               /**< Messages sent inside a batch envelope */
+    uint32_t dropped;               /**< Messages rejected, evicted or flushed */
+    uint32_t last_wait_ms;          /**< Queue wait of last sent message */
+    uint32_t max_wait_ms;           /**< Longest queue wait observed */
+    uint32_t total_wait_ms;         /**< Sum of queue waits (avg = total / sent) */
+} ws_queue_stats_t;
+
+/**
+ * @brief Load-shedding hints in force on a session
+ * 
+ * Servers send {"type":"hint", ...} when overloaded or restarting:
+ * retry_after_ms holds off connects (plus jitter), rate_percent stretches
+ * heartbeat and reconnect intervals, mode "push" stops status queries,
+ * and redirect moves the session to another server.
+ */
+typedef struct {
+    uint32_t hold_remaining_ms;     /**< Time until connects are allowed again (0 = none) */
+    uint32_t rate_percent;          /**< Heartbeat and backoff pace, 100 = normal */
+    bool push_only;                 /**< Server pushes status, queries are not sent */
+    uint32_t expires_in_ms;         /**< Until rate and push-only lapse (0 = none in force) */
+    uint32_t hints_received;        /**< Hints received on this session */
+    uint32_t redirects;             /**< Redirects followed */
+} ws_hint_state_t;
+
+/**
+ * @brief WebSocket session handle
+ * 
+ * One connection to one server. The ws_client_* functions operate on the
+ * primary session; ws_session_open() adds sessions to other servers.
+ */
+typedef struct ws_session_t ws_session_t;
+
+#ifdef TESTING
+/**
+ * @brief Test hook replacing the socket write
+ * 
+ * @return 0 on success, negative on failure
+ */
+typedef int (*ws_test_write_fn)(const char *data, size_t length);
+#endif
+
 /* ============================================================
  *  Public Function Declarations
  * ============================================================ */
@@ -208,6 +327,26 @@ void ws_client_set_callbacks(
     void *user_data
 );
 
+/**
+ * @brief Hand redirects of the primary session to its owner
+ * 
+ * @param on_redirect Redirect callback (NULL to follow redirects in place)
+ * @param user_data User data for the callback (can be NULL)
+ */
+void ws_client_set_redirect_callback(ws_redirect_callback_t on_redirect, void *user_data);
+
+/**
+ * @brief Point the client at another server
+ * 
+ * Takes effect with the next connect; a session that is connected or
+ * connecting keeps its server.
+ * 
+ * @param server_host Server hostname or IP address
+ * @param server_port Server port number
+ * @return 0 on success, -1 while a session is up or on invalid arguments
+ */
+int ws_client_set_server(const char *server_host, int server_port);
+
 /**
  * @brief Connect to WebSocket server
  * 
@@ -221,7 +360,7 @@ int ws_client_connect(void);
 /**
  * @brief Send message to server
  * 
- * Send a text message to the WebSocket server.
+ * Queue a text message in the interactive class.
  * 
  * @param message Message to send (null-terminated string)
  * @return 0 on success, negative error code on failure
@@ -230,6 +369,97 @@ int ws_client_connect(void);
  */
 int ws_client_send(const char *message);
 
+/**
+ * @brief Send message with priority
+ * 
+ * Queue a text message in the given class. One message is written per
+ * writable callback, picked by the scheduling mode. When the background
+ * queue is full its oldest message is evicted; other classes reject the
+ * new message instead.
+ * 
+ * @param message Message to send (null-terminated string)
+ * @param priority Priority class
+ * @return 0 on success, negative error code on failure
+ */
+int ws_client_send_with_priority(const char *message, ws_priority_t priority);
+
+/**
+ * @brief Configure outbound scheduling
+ * 
+ * @param mode Scheduling mode
+ * @param weights Messages per round for each class (WS_SCHED_WEIGHTED only,
+ *                NULL for defaults, zero weights are raised to 1)
+ * @return 0 on success, negative error code on failure
+ */
+int ws_client_set_scheduling(ws_sched_mode_t mode, const uint8_t weights[WS_PRIORITY_COUNT]);
+
+/**
+ * @brief Copy a received message
+ * 
+ * Make a null-terminated heap copy of a message view, for handlers that
+ * must keep it after the message callback returns.
+ * 
+ * @param message Message view passed to the message callback
+ * @param length Message length in bytes
+ * @return Copy to free with ws_client_release(), or NULL on failure
+ */
+char* ws_client_retain(const char *message, size_t length);
+
+/**
+ * @brief Release a retained message
+ * 
+ * @param message Copy returned by ws_client_retain() (can be NULL)
+ */
+void ws_client_release(char *message);
+
+/**
+ * @brief Enable or disable batch envelopes
+ * 
+ * When enabled, a hello message offering the "batch" feature is sent on
+ * every new connection. Once the server accepts it, each writable
+ * callback packs all ready messages that fit into one
+ * {"type":"batch","messages":[...]} frame, draining classes in priority
+ * order. Nothing is held back waiting for a batch to fill. Server
+ * batches are always unpacked and delivered one message at a time.
+ * The server's hello (or hello_ack) and other {"type":"ack"} frames are
+ * consumed by the client and never reach the message callback.
+ * 
+ * @param enable true to offer batching on connect
+ */
+void ws_client_set_batching(bool enable);
+
+/**
+ * @brief Check if batching was negotiated
+ * 
+ * @return true if the server accepted batch envelopes on this connection
+ */
+bool ws_client_is_batching(void);
+
+/**
+ * @brief Get outbound queue statistics
+ * 
+ * @param priority Priority class
+ * @param stats Pointer to stats structure to fill
+ * @return 0 on success, negative error code on failure
+ */
+int ws_client_get_queue_stats(ws_priority_t priority, ws_queue_stats_t *stats);
+
+/**
+ * @brief Get server hints in force
+ * 
+ * @param state Pointer to hint state to fill
+ * @return 0 on success, negative error code on failure
+ */
+int ws_client_get_hint_state(ws_hint_state_t *state);
+
+/**
+ * @brief Get priority class string
+ * 
+ * @param priority Priority class
+ * @return Priority class name
+ */
+const char* ws_client_priority_to_string(ws_priority_t priority);
+
 /**
  * @brief Send binary data to server
  * 
@@ -327,6 +557,32 @@ const char* ws_client_error_to_string(ws_error_t error);
  */
 const char* ws_client_state_to_string(ws_state_t state);
 
+/**
+ * @brief Suspend the WebSocket client while idle
+ * 
+ * Destroy the libwebsockets context shared by all sessions and free
+ * receive buffers, keeping configuration, callbacks and open session
+ * handles. The next connect (or ws_client_resume()) rebuilds it.
+ * Refused while any session is connected or connecting.
+ * 
+ * @return 0 on success (or already suspended), negative on failure
+ */
+int ws_client_suspend(void);
+
+/**
+ * @brief Rebuild the libwebsockets context after a suspend
+ * 
+ * @return 0 on success (or not suspended), negative on failure
+ */
+int ws_client_resume(void);
+
+/**
+ * @brief Check if the client is suspended
+ * 
+ * @return true between ws_client_suspend() and the next rebuild
+ */
+bool ws_client_is_suspended(void);
+
 /**
  * @brief Clean up WebSocket client
  * 
@@ -341,7 +597,9 @@ void ws_client_cleanup(void);
 /**
  * @brief Send PS5 status query
  * 
- * Send a query message to request PS5 status from server.
+ * Queue a query message in the interactive class to request PS5
+ * status from server. Nothing is sent while the server has asked for
+ * push-only mode; its next push is the answer.
  * 
  * @return 0 on success, negative error code on failure
  */
@@ -350,12 +608,191 @@ int ws_client_query_ps5_status(void);
 /**
  * @brief Send heartbeat message
  * 
- * Send a heartbeat message to keep connection alive.
+ * Queue a heartbeat message in the control class to keep connection
+ * alive.
  * 
  * @return 0 on success, negative error code on failure
  */
 int ws_client_send_heartbeat(void);
 
+/* ============================================================
+ *  Extra Sessions
+ * ============================================================ */
+
+/**
+ * @brief Open a session to another server
+ * 
+ * The session shares the primary session's libwebsockets context and is
+ * serviced by ws_client_service(). It starts disconnected, with the
+ * primary's scheduling and batching settings. Requires ws_client_init().
+ * 
+ * @param server_host Server hostname or IP address
+ * @param server_port Server port number
+ * @return Session handle, or NULL if none is free or on invalid arguments
+ */
+ws_session_t* ws_session_open(const char *server_host, int server_port);
+
+/**
+ * @brief Set callback functions of a session
+ * 
+ * @param session Session handle
+ * @param on_connected Connected callback (can be NULL)
+ * @param on_disconnected Disconnected callback (can be NULL)
+ * @param on_message Message callback (can be NULL)
+ * @param on_error Error callback (can be NULL)
+ * @param user_data User data for callbacks (can be NULL)
+ */
+void ws_session_set_callbacks(
+    ws_session_t *session,
+    ws_connected_callback_t on_connected,
+    ws_disconnected_callback_t on_disconnected,
+    ws_message_callback_t on_message,
+    ws_error_callback_t on_error,
+    void *user_data
+);
+
+/**
+ * @brief Hand redirects of a session to its owner
+ * 
+ * Without a callback the session follows a redirect itself: it
+ * disconnects, moves to the target and reconnects once the redirect's
+ * hold-off has passed.
+ * 
+ * @param session Session handle
+ * @param on_redirect Redirect callback (NULL to follow redirects in place)
+ * @param user_data User data for the callback (can be NULL)
+ */
+void ws_session_set_redirect_callback(ws_session_t *session,
+                                      ws_redirect_callback_t on_redirect,
+                                      void *user_data);
+
+/**
+ * @brief Point a session at another server
+ * 
+ * Same rules as ws_client_set_server().
+ * 
+ * @param session Session handle
+ * @param server_host Server hostname or IP address
+ * @param server_port Server port number
+ * @return 0 on success, -1 while the session is up or on invalid arguments
+ */
+int ws_session_set_server(ws_session_t *session, const char *server_host, int server_port);
+
+/**
+ * @brief Connect a session (non-blocking)
+ * 
+ * @param session Session handle
+ * @return 0 on success, negative error code on failure
+ */
+int ws_session_connect(ws_session_t *session);
+
+/**
+ * @brief Queue a message on a session
+ * 
+ * Same queueing rules as ws_client_send_with_priority().
+ * 
+ * @param session Session handle
+ * @param message Message to send (null-terminated string)
+ * @param priority Priority class
+ * @return 0 on success, negative error code on failure
+ */
+int ws_session_send_with_priority(ws_session_t *session, const char *message,
+                                  ws_priority_t priority);
+
+/**
+ * @brief Queue a PS5 status query on a session
+ * 
+ * @param session Session handle
+ * @return 0 on success, negative error code on failure
+ */
+int ws_session_query_ps5_status(ws_session_t *session);
+
+/**
+ * @brief Get connection state of a session
+ * 
+ * @param session Session handle
+ * @return Current connection state (WS_STATE_DISCONNECTED if NULL)
+ */
+ws_state_t ws_session_get_state(const ws_session_t *session);
+
+/**
+ * @brief Get server hints in force on a session
+ * 
+ * @param session Session handle
+ * @param state Pointer to hint state to fill
+ * @return 0 on success, negative error code on failure
+ */
+int ws_session_get_hint_state(const ws_session_t *session, ws_hint_state_t *state);
+
+/**
+ * @brief Disconnect a session
+ * 
+ * The session stays open and can be connected again.
+ * 
+ * @param session Session handle
+ * @return 0 on success, negative error code on failure
+ */
+int ws_session_disconnect(ws_session_t *session);
+
+/**
+ * @brief Close a session opened with ws_session_open()
+ * 
+ * Disconnect and free the slot. The primary session cannot be closed
+ * this way, use ws_client_cleanup().
+ * 
+ * @param session Session handle (can be NULL)
+ */
+void ws_session_close(ws_session_t *session);
+
+#ifdef TESTING
+/**
+ * @brief Replace the socket write (test builds only)
+ * 
+ * @param write_fn Write hook, NULL to discard writes
+ */
+void ws_client_set_test_writer(ws_test_write_fn write_fn);
+
+/**
+ * @brief Run one writable callback (test builds only)
+ * 
+ * @return 0 if a message was written, -1 if nothing was queued
+ */
+int ws_client_test_writable(void);
+
+/**
+ * @brief Feed one receive callback of a text message (test builds only)
+ * 
+ * @param data Received bytes
+ * @param length Number of bytes
+ * @param final true if this completes the message
+ * @return 0 on success, -1 if not valid UTF-8, -2 if too large
+ */
+int ws_client_test_receive(const char *data, size_t length, bool final);
+
+/**
+ * @brief Feed one receive callback to a session (test builds only)
+ * 
+ * @param session Session handle
+ * @param data Received bytes
+ * @param length Number of bytes
+ * @param final true if this completes the message
+ * @return 0 on success, -1 if not valid UTF-8, -2 if too large
+ */
+int ws_session_test_receive(ws_session_t *session, const char *data, size_t length, bool final);
+
+/**
+ * @brief Fail the pending connect with a library error text (test builds only)
+ * 
+ * @param detail Error text as libwebsockets reports it
+ */
+void ws_client_test_connection_error(const char *detail);
+
+/**
+ * @brief End the primary session's hold-off now (test builds only)
+ */
+void ws_client_test_end_hold(void);
+#endif
+
 /** @} */ // end of WebSocketClient group
 
 #ifdef __cplusplus
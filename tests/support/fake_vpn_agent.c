@@ -0,0 +1,157 @@
+/**
+ * @file fake_vpn_agent.c
+ * @brief Stand-in VPN agent for unit tests
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "fake_vpn_agent.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* ============================================================
+ *  Internal Structures
+ * ============================================================ */
+
+typedef enum {
+    AGENT_DISCONNECTED = 0,
+    AGENT_CONNECTED,
+    AGENT_SUSPENDED,
+} agent_state_t;
+
+typedef struct {
+    agent_state_t state;
+    bool resume_supported;
+    uint32_t suspend_time;
+    uint32_t linger_ms;
+    int handshake_count;
+    int resume_count;
+    
+    char outbox[2048];
+    size_t outbox_len;
+} fake_agent_t;
+
+static fake_agent_t g_agent = {
+    .state = AGENT_DISCONNECTED,
+    .resume_supported = true,
+};
+
+/* ============================================================
+ *  Internal Helper Functions
+ * ============================================================ */
+
+static uint32_t get_current_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+static void reply(const char *line) {
+    size_t len = strlen(line);
+    
+    if (g_agent.outbox_len + len + 1 >= sizeof(g_agent.outbox)) {
+        return;
+    }
+    
+    memcpy(g_agent.outbox + g_agent.outbox_len, line, len);
+    g_agent.outbox_len += len;
+    g_agent.outbox[g_agent.outbox_len++] = '\n';
+}
+
+static bool session_alive(void) {
+    return g_agent.state == AGENT_SUSPENDED &&
+           get_current_time_ms() - g_agent.suspend_time < g_agent.linger_ms;
+}
+
+static void do_connect(void) {
+    g_agent.handshake_count++;
+    g_agent.state = AGENT_CONNECTED;
+    
+    reply("{\"event\":\"progress\",\"stage\":\"resolving\"}");
+    reply("{\"event\":\"progress\",\"stage\":\"handshaking\"}");
+    reply("{\"event\":\"progress\",\"stage\":\"handshake_done\"}");
+    reply("{\"event\":\"progress\",\"stage\":\"routes_installed\"}");
+    reply("{\"status\":\"ok\",\"state\":\"connected\"}");
+}
+
+/* ============================================================
+ *  Public API Implementation
+ * ============================================================ */
+
+void fake_vpn_agent_reset(void) {
+    memset(&g_agent, 0, sizeof(g_agent));
+    g_agent.state = AGENT_DISCONNECTED;
+    g_agent.resume_supported = true;
+}
+
+void fake_vpn_agent_set_resume_supported(bool supported) {
+    g_agent.resume_supported = supported;
+}
+
+int fake_vpn_agent_send(const char *data, size_t length) {
+    bool is_suspend = strstr(data, "\"action\":\"suspend\"") != NULL;
+    bool is_resume = strstr(data, "\"action\":\"resume\"") != NULL;
+    
+    if ((is_suspend || is_resume) && !g_agent.resume_supported) {
+        reply("{\"status\":\"error\",\"reason\":\"unknown_action\"}");
+        return (int)length;
+    }
+    
+    if (strstr(data, "\"action\":\"connect\"")) {
+        do_connect();
+    } else if (is_suspend) {
+        const char *linger = strstr(data, "\"linger_ms\":");
+        g_agent.linger_ms = 0;
+        if (linger) {
+            sscanf(linger + 12, "%u", &g_agent.linger_ms);
+        }
+        g_agent.state = AGENT_SUSPENDED;
+        g_agent.suspend_time = get_current_time_ms();
+        reply("{\"status\":\"ok\",\"state\":\"suspended\"}");
+    } else if (is_resume) {
+        if (session_alive()) {
+            g_agent.resume_count++;
+            g_agent.state = AGENT_CONNECTED;
+            reply("{\"status\":\"ok\",\"state\":\"connected\",\"resumed\":true}");
+        } else {
+            g_agent.state = AGENT_DISCONNECTED;
+            reply("{\"status\":\"error\",\"reason\":\"session_expired\"}");
+        }
+    } else if (strstr(data, "\"action\":\"disconnect\"")) {
+        g_agent.state = AGENT_DISCONNECTED;
+        reply("{\"status\":\"ok\",\"state\":\"disconnected\"}");
+    } else if (strstr(data, "\"action\":\"status\"")) {
+        reply(g_agent.state == AGENT_CONNECTED
+              ? "{\"status\":\"ok\",\"state\":\"connected\"}"
+              : "{\"status\":\"ok\",\"state\":\"disconnected\"}");
+    } else {
+        reply("{\"status\":\"error\",\"reason\":\"unknown_action\"}");
+    }
+    
+    return (int)length;
+}
+
+int fake_vpn_agent_recv(char *buffer, size_t max_len) {
+    if (g_agent.outbox_len == 0 || max_len == 0) {
+        return 0;
+    }
+    
+    size_t len = g_agent.outbox_len < max_len ? g_agent.outbox_len : max_len;
+    memcpy(buffer, g_agent.outbox, len);
+    memmove(g_agent.outbox, g_agent.outbox + len, g_agent.outbox_len - len);
+    g_agent.outbox_len -= len;
+    
+    return (int)len;
+}
+
+int fake_vpn_agent_get_handshake_count(void) {
+    return g_agent.handshake_count;
+}
+
+int fake_vpn_agent_get_resume_count(void) {
+    return g_agent.resume_count;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file fake_vpn_agent.h
+ * @brief Stand-in VPN agent for unit tests
+ * 
+ * In-memory implementation of the VPN agent protocol, plugged into the
+ * VPN controller through vpn_controller_set_test_transport(). It emits
+ * connect progress events, honours suspend/resume within the requested
+ * linger window and counts full handshakes.
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#ifndef FAKE_VPN_AGENT_H
+#define FAKE_VPN_AGENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Reset agent to a disconnected state with no session
+ */
+void fake_vpn_agent_reset(void);
+
+/**
+ * @brief Emulate an older agent that rejects suspend/resume
+ * 
+ * @param supported false to reject suspend/resume commands
+ */
+void fake_vpn_agent_set_resume_supported(bool supported);
+
+/**
+ * @brief Transport send hook, consumes one command line
+ */
+int fake_vpn_agent_send(const char *data, size_t length);
+
+/**
+ * @brief Transport receive hook, drains pending agent output
+ */
+int fake_vpn_agent_recv(char *buffer, size_t max_len);
+
+/**
+ * @brief Number of full handshakes performed since reset
+ */
+int fake_vpn_agent_get_handshake_count(void);
+
+/**
+ * @brief Number of sessions resumed without handshake since reset
+ */
+int fake_vpn_agent_get_resume_count(void);
+
+#endif /* FAKE_VPN_AGENT_H */
@@ -6,11 +6,18 @@
  * @date 2025-11-03
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include "unity.h"
 #include "client_state_machine.h"
+#include "json_scan.h"
+#include "press_budget.h"
+#include "server_fanout.h"
 #include "mock_vpn_controller.h"
 #include "mock_websocket_client.h"
 #include <string.h>
+#include <time.h>
+#include <signal.h>
 
 /* ============================================================
  *  Test Configuration
@@ -78,9 +85,11 @@ void test_client_sm_init_should_succeed(void) {
     // Arrange - Mock VPN and WS initialization
     vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
     vpn_controller_set_callback_Ignore();  // 簡化：忽略所有參數
+    vpn_controller_set_progress_callback_Ignore();
     
     ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, 0);
     ws_client_set_callbacks_Ignore();      // 簡化：忽略所有參數
+    ws_client_set_redirect_callback_Ignore();
     
     // Act
     int result = client_sm_init(g_ctx);
@@ -113,6 +122,7 @@ void test_client_sm_init_should_fail_when_ws_init_fails(void) {
     // Arrange
     vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
     vpn_controller_set_callback_Ignore();
+    vpn_controller_set_progress_callback_Ignore();
     ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, -1);
     vpn_controller_cleanup_Expect();
     
@@ -255,8 +265,10 @@ void test_client_sm_update_should_succeed_when_initialized(void) {
     // Arrange
     vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
     vpn_controller_set_callback_Ignore();
+    vpn_controller_set_progress_callback_Ignore();
     ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, 0);
     ws_client_set_callbacks_Ignore();
+    ws_client_set_redirect_callback_Ignore();
     client_sm_init(g_ctx);
     
     vpn_controller_process_ExpectAndReturn(10, 0);
@@ -309,8 +321,10 @@ void test_client_sm_cleanup_should_allow_reinit(void) {
     // Arrange - First init
     vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
     vpn_controller_set_callback_Ignore();
+    vpn_controller_set_progress_callback_Ignore();
     ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, 0);
     ws_client_set_callbacks_Ignore();
+    ws_client_set_redirect_callback_Ignore();
     client_sm_init(g_ctx);
     
     // Cleanup
@@ -321,8 +335,10 @@ void test_client_sm_cleanup_should_allow_reinit(void) {
     // Reinit
     vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
     vpn_controller_set_callback_Ignore();
+    vpn_controller_set_progress_callback_Ignore();
     ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, 0);
     ws_client_set_callbacks_Ignore();
+    ws_client_set_redirect_callback_Ignore();
     
     // Act
     int result = client_sm_init(g_ctx);
@@ -364,6 +380,7 @@ void test_client_error_to_string_should_return_correct_strings(void) {
     TEST_ASSERT_EQUAL_STRING("PS5_TIMEOUT", client_error_to_string(CLIENT_ERROR_PS5_TIMEOUT));
     TEST_ASSERT_EQUAL_STRING("PS5_FAILED", client_error_to_string(CLIENT_ERROR_PS5_FAILED));
     TEST_ASSERT_EQUAL_STRING("MAX_RETRIES", client_error_to_string(CLIENT_ERROR_MAX_RETRIES));
+    TEST_ASSERT_EQUAL_STRING("BUDGET_EXCEEDED", client_error_to_string(CLIENT_ERROR_BUDGET_EXCEEDED));
 }
 
 void test_client_error_to_string_should_handle_invalid_error(void) {
@@ -388,3 +405,808 @@ void test_ps5_status_to_string_should_handle_invalid_status(void) {
     // Assert
     TEST_ASSERT_EQUAL_STRING("INVALID", str);
 }
+
+void test_client_cancel_to_string_should_return_correct_strings(void) {
+    TEST_ASSERT_EQUAL_STRING("NONE", client_cancel_to_string(CLIENT_CANCEL_NONE));
+    TEST_ASSERT_EQUAL_STRING("NEW_PRESS", client_cancel_to_string(CLIENT_CANCEL_NEW_PRESS));
+    TEST_ASSERT_EQUAL_STRING("LONG_PRESS", client_cancel_to_string(CLIENT_CANCEL_LONG_PRESS));
+    TEST_ASSERT_EQUAL_STRING("CONFIG_CHANGE", client_cancel_to_string(CLIENT_CANCEL_CONFIG_CHANGE));
+    TEST_ASSERT_EQUAL_STRING("SHUTDOWN", client_cancel_to_string(CLIENT_CANCEL_SHUTDOWN));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", client_cancel_to_string((client_cancel_t)999));
+}
+
+/* ============================================================
+ *  Test Group 10: Cancellation Tests
+ * ============================================================ */
+
+static ws_message_callback_t g_ws_on_message;
+static ws_error_callback_t g_ws_on_error;
+static void *g_ws_user_data;
+
+static void capture_ws_callbacks(ws_connected_callback_t on_connected,
+                                 ws_disconnected_callback_t on_disconnected,
+                                 ws_message_callback_t on_message,
+                                 ws_error_callback_t on_error,
+                                 void *user_data, int cmock_num_calls) {
+    g_ws_on_message = on_message;
+    g_ws_on_error = on_error;
+    g_ws_user_data = user_data;
+}
+
+static ws_redirect_callback_t g_ws_on_redirect;
+static void *g_ws_redirect_data;
+
+static void capture_ws_redirect(ws_redirect_callback_t on_redirect, void *user_data,
+                                int cmock_num_calls) {
+    g_ws_on_redirect = on_redirect;
+    g_ws_redirect_data = user_data;
+}
+
+static void init_client(void) {
+    vpn_controller_init_ExpectAndReturn(test_config.vpn_socket_path, 0);
+    vpn_controller_set_callback_Ignore();
+    vpn_controller_set_progress_callback_Ignore();
+    ws_client_init_ExpectAndReturn(test_config.ws_server_host, test_config.ws_server_port, 0);
+    ws_client_set_callbacks_StubWithCallback(capture_ws_callbacks);
+    ws_client_set_redirect_callback_StubWithCallback(capture_ws_redirect);
+    TEST_ASSERT_EQUAL(0, client_sm_init(g_ctx));
+}
+
+/**
+ * @brief Press and run the workflow into the VPN connect
+ */
+static void start_press(void) {
+    client_sm_trigger_button(g_ctx, false);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    client_sm_update(g_ctx);
+}
+
+/**
+ * @brief Run a press up to the sent status query
+ */
+static void run_press_to_query(void) {
+    client_sm_trigger_button(g_ctx, false);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_query_ps5_status_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_QUERYING_PS5, client_sm_get_state(g_ctx));
+}
+
+static void cleanup_client(void) {
+    vpn_controller_cleanup_Expect();
+    ws_client_cleanup_Expect();
+    client_sm_cleanup(g_ctx);
+}
+
+void test_client_sm_short_press_should_restart_busy_workflow(void) {
+    // Arrange
+    init_client();
+    start_press();
+    
+    // Act - second press while the VPN connect is still in flight
+    int result = client_sm_trigger_button(g_ctx, false);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);  // connect kept
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_stats_t stats;
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_VPN_CONNECTING, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(2, stats.button_press_count);
+    TEST_ASSERT_EQUAL(1, stats.restarted_workflows);
+    TEST_ASSERT_EQUAL(0, stats.cancelled_workflows);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_long_press_should_abort_workflow_without_timeout(void) {
+    // Arrange
+    init_client();
+    start_press();
+    
+    // Act
+    int result = client_sm_trigger_button(g_ctx, true);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    vpn_controller_disconnect_ExpectAndReturn(0);  // supersedes the connect
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_stats_t stats;
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, stats.cancelled_workflows);
+    
+    cleanup_client();
+}
+
+void test_client_sm_config_change_should_win_over_new_press(void) {
+    // Arrange
+    init_client();
+    start_press();
+    
+    // Act
+    TEST_ASSERT_EQUAL(0, client_sm_cancel(g_ctx, CLIENT_CANCEL_CONFIG_CHANGE));
+    TEST_ASSERT_EQUAL(0, client_sm_cancel(g_ctx, CLIENT_CANCEL_NEW_PRESS));
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_disconnect_ExpectAndReturn(0);  // no resume after a config change
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_stats_t stats;
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(0, stats.restarted_workflows);
+    TEST_ASSERT_EQUAL(1, stats.cancelled_workflows);
+    
+    cleanup_client();
+}
+
+void test_client_sm_stop_should_release_links_on_cleanup(void) {
+    // Arrange
+    init_client();
+    start_press();
+    
+    // Act
+    client_sm_stop(g_ctx);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);  // no linger configured
+    cleanup_client();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+}
+
+void test_client_sm_cancel_should_do_nothing_when_idle(void) {
+    // Arrange
+    init_client();
+    
+    // Act
+    client_sm_cancel(g_ctx, CLIENT_CANCEL_LONG_PRESS);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_stats_t stats;
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(0, stats.cancelled_workflows);
+    
+    cleanup_client();
+}
+
+static void press_from_signal(int signum) {
+    client_sm_trigger_button(g_ctx, false);
+}
+
+void test_client_sm_signal_press_should_publish_only_from_update(void) {
+    // Arrange - the state callback is where main.c publishes
+    struct sigaction action, previous;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = press_from_signal;
+    sigemptyset(&action.sa_mask);
+    init_client();
+    client_sm_set_state_callback(g_ctx, test_state_callback, NULL);
+    g_state_callback_count = 0;
+    sigaction(SIGUSR1, &action, &previous);
+    
+    // Act
+    raise(SIGUSR1);
+    sigaction(SIGUSR1, &previous, NULL);
+    
+    // Assert - nothing ran in the handler, the update starts the press
+    TEST_ASSERT_EQUAL(0, g_state_callback_count);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(1, g_state_callback_count);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, g_callback_old_state);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_PRESS_START, g_callback_new_state);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_cancel_should_reject_invalid_arguments(void) {
+    TEST_ASSERT_LESS_THAN(0, client_sm_cancel(NULL, CLIENT_CANCEL_SHUTDOWN));
+    TEST_ASSERT_LESS_THAN(0, client_sm_cancel(g_ctx, CLIENT_CANCEL_NONE));
+    TEST_ASSERT_LESS_THAN(0, client_sm_cancel(g_ctx, (client_cancel_t)999));
+}
+
+/* ============================================================
+ *  Test Group 11: Idle Release Tests
+ * ============================================================ */
+
+static void create_with_idle_release(void) {
+    client_config_t config = test_config;
+    config.idle_release_ms = 1;
+    client_sm_destroy(g_ctx);
+    g_ctx = client_sm_create(&config);
+    init_client();
+    
+    struct timespec idle = { 0, 2000000 };
+    nanosleep(&idle, NULL);
+}
+
+void test_client_sm_should_release_resources_after_idle(void) {
+    // Arrange
+    client_idle_stats_t stats;
+    create_with_idle_release();
+    
+    // Act
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_release_ExpectAndReturn(0);
+    ws_client_suspend_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_idle_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(1, stats.releases);
+    TEST_ASSERT_EQUAL(0, stats.restores);
+    
+    // Act - next press rebuilds before connecting
+    client_sm_trigger_button(g_ctx, false);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_resume_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_idle_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(1, stats.restores);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTING);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_should_keep_resources_while_vpn_lingers(void) {
+    // Arrange
+    client_idle_stats_t stats;
+    create_with_idle_release();
+    
+    // Act
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_release_ExpectAndReturn(-1);  // session still suspended
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_idle_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(0, stats.releases);
+    
+    cleanup_client();
+}
+
+void test_client_sm_get_idle_stats_should_reject_null(void) {
+    client_idle_stats_t stats;
+    TEST_ASSERT_LESS_THAN(0, client_sm_get_idle_stats(NULL, &stats));
+    TEST_ASSERT_LESS_THAN(0, client_sm_get_idle_stats(g_ctx, NULL));
+}
+
+/* ============================================================
+ *  Test Group 12: Pre-warm Tests
+ * ============================================================ */
+
+void test_client_sm_prewarm_should_bring_up_links_for_press(void) {
+    // Arrange
+    client_stats_t stats;
+    init_client();
+    TEST_ASSERT_EQUAL(0, client_sm_prewarm(g_ctx, 60000));
+    
+    // Act - VPN first, then the WebSocket once the tunnel is up
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_DISCONNECTED);
+    vpn_controller_connect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    ws_client_connect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    
+    client_sm_trigger_button(g_ctx, false);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    
+    // Assert - the warm tunnel is used at once
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_VPN_CONNECTED, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, stats.prewarms);
+    TEST_ASSERT_EQUAL(1, stats.prewarm_hits);
+    TEST_ASSERT_LESS_THAN(0, client_sm_prewarm(g_ctx, 60000));  // busy
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_prewarm_should_release_links_when_unused(void) {
+    // Arrange
+    client_stats_t stats;
+    struct timespec hold = { 0, 2000000 };
+    init_client();
+    client_sm_prewarm(g_ctx, 1);
+    nanosleep(&hold, NULL);
+    
+    // Act
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);  // no linger configured
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(1, stats.prewarms_unused);
+    TEST_ASSERT_EQUAL(0, stats.prewarm_hits);
+    
+    cleanup_client();
+}
+
+void test_client_sm_prewarm_should_reject_invalid_arguments(void) {
+    TEST_ASSERT_LESS_THAN(0, client_sm_prewarm(NULL, 60000));
+    TEST_ASSERT_LESS_THAN(0, client_sm_prewarm(g_ctx, 60000));  // not initialized
+}
+
+/* ============================================================
+ *  Test Group 13: Failure Statistics Tests
+ * ============================================================ */
+
+void test_client_sm_should_record_vpn_failure_cause(void) {
+    // Arrange
+    failure_stats_t failures;
+    failure_record_t record;
+    init_client();
+    client_sm_trigger_button(g_ctx, false);
+    
+    // Act - agent reports the connect failed
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_ERROR);
+    vpn_controller_get_last_error_ExpectAndReturn(VPN_ERROR_REJECTED);
+    vpn_controller_error_to_string_ExpectAndReturn(VPN_ERROR_REJECTED, "REJECTED");
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_failure_stats(g_ctx, &failures);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_ERROR, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, failures.causes[FAILURE_CAUSE_VPN_REJECTED].count);
+    TEST_ASSERT_TRUE(failures.outage_open);
+    TEST_ASSERT_EQUAL(FAILURE_CAUSE_VPN_REJECTED, failures.outage_cause);
+    TEST_ASSERT_EQUAL(1, failure_stats_get_recent(&failures, &record, 1));
+    TEST_ASSERT_EQUAL_STRING("VPN connection failed: REJECTED", record.detail);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_ERROR);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_should_record_parse_error_for_status_less_replies(void) {
+    // Arrange
+    failure_stats_t failures;
+    init_client();
+    run_press_to_query();
+    
+    // Act - only a reply without a status arrives before the deadline
+    const char *reply = "{\"type\":\"ack\"}";
+    g_ws_on_message(reply, strlen(reply), g_ws_user_data);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_QUERYING_PS5, client_sm_get_state(g_ctx));
+    
+    client_sm_test_age_state(g_ctx, CLIENT_PS5_QUERY_TIMEOUT_S * 1000);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_failure_stats(g_ctx, &failures);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_ERROR, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, failures.causes[FAILURE_CAUSE_PARSE_ERROR].count);
+    TEST_ASSERT_EQUAL(0, failures.causes[FAILURE_CAUSE_QUERY_TIMEOUT].count);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_should_record_pong_timeout_of_prewarmed_link(void) {
+    // Arrange
+    failure_stats_t failures;
+    client_stats_t stats;
+    init_client();
+    client_sm_prewarm(g_ctx, 60000);
+    
+    // Act
+    g_ws_on_error(WS_ERROR_PONG_TIMEOUT, "Pong timeout", g_ws_user_data);
+    
+    // Assert - recorded, but no press failed
+    client_sm_get_failure_stats(g_ctx, &failures);
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, failures.causes[FAILURE_CAUSE_WS_PONG_TIMEOUT].count);
+    TEST_ASSERT_EQUAL(0, stats.error_count);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_get_failure_stats_should_reject_null(void) {
+    failure_stats_t stats;
+    TEST_ASSERT_LESS_THAN(0, client_sm_get_failure_stats(NULL, &stats));
+    TEST_ASSERT_LESS_THAN(0, client_sm_get_failure_stats(g_ctx, NULL));
+}
+
+/* ============================================================
+ *  Test Group 14: Primary Server Tests
+ * ============================================================ */
+
+void test_client_sm_set_primary_server_should_swap_with_fanout_server(void) {
+    // Arrange
+    fanout_entry_t table[3];
+    init_client();
+    server_fanout_add_server("10.0.0.2", 9000);
+    
+    // Act
+    ws_client_set_server_ExpectAndReturn("10.0.0.2", 9000, 0);
+    ws_session_close_Expect(NULL);
+    int result = client_sm_set_primary_server(g_ctx, "10.0.0.2", 9000);
+    
+    // Assert - both servers are still in the table, roles swapped
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(2, client_sm_get_status_table(g_ctx, table, 3));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", table[0].host);
+    TEST_ASSERT_EQUAL(9000, table[0].port);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.1", table[1].host);
+    TEST_ASSERT_EQUAL(8080, table[1].port);
+    
+    vpn_controller_cleanup_Expect();
+    ws_session_close_Expect(NULL);
+    ws_client_cleanup_Expect();
+    client_sm_cleanup(g_ctx);
+}
+
+void test_client_sm_set_primary_server_should_wait_for_idle(void) {
+    // Arrange
+    init_client();
+    client_sm_trigger_button(g_ctx, false);
+    
+    // Act & Assert - no link is touched by a press about to start
+    TEST_ASSERT_LESS_THAN(0, client_sm_set_primary_server(g_ctx, "10.0.0.2", 9000));
+    TEST_ASSERT_LESS_THAN(0, client_sm_set_primary_server(NULL, "10.0.0.2", 9000));
+    
+    cleanup_client();
+}
+
+/* ============================================================
+ *  Test Group 15: Fan-out Tests
+ * ============================================================ */
+
+static int g_fake_session;
+static ws_connected_callback_t g_fanout_on_connected;
+static ws_message_callback_t g_fanout_on_message;
+static void *g_fanout_user_data;
+
+static void capture_session_callbacks(ws_session_t *session,
+                                      ws_connected_callback_t on_connected,
+                                      ws_disconnected_callback_t on_disconnected,
+                                      ws_message_callback_t on_message,
+                                      ws_error_callback_t on_error,
+                                      void *user_data, int cmock_num_calls) {
+    g_fanout_on_connected = on_connected;
+    g_fanout_on_message = on_message;
+    g_fanout_user_data = user_data;
+}
+
+void test_client_sm_should_show_fanout_answer_when_primary_fails(void) {
+    // Arrange
+    ws_session_t *session = (ws_session_t *)&g_fake_session;
+    client_stats_t stats;
+    init_client();
+    server_fanout_add_server("10.0.0.2", 9000);
+    ws_session_set_callbacks_StubWithCallback(capture_session_callbacks);
+    ws_session_set_redirect_callback_Ignore();
+    client_sm_trigger_button(g_ctx, false);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    
+    // Act - the extra server is queried at once, the primary cannot connect
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    ws_session_open_ExpectAndReturn("10.0.0.2", 9000, session);
+    ws_session_get_state_ExpectAndReturn(session, WS_STATE_DISCONNECTED);
+    ws_session_connect_ExpectAndReturn(session, 0);
+    ws_session_get_state_ExpectAndReturn(session, WS_STATE_CONNECTING);
+    ws_client_connect_ExpectAndReturn(-1);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_QUERYING_PS5, client_sm_get_state(g_ctx));
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);  // still waiting for the extra server
+    
+    ws_session_query_ps5_status_ExpectAndReturn(session, 0);
+    g_fanout_on_connected(g_fanout_user_data);
+    const char *reply = "{\"status\":\"standby\"}";
+    g_fanout_on_message(reply, strlen(reply), g_fanout_user_data);
+    
+    // Assert
+    client_sm_get_stats(g_ctx, &stats);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_LED_UPDATE, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(PS5_STATUS_STANDBY, client_sm_get_ps5_status(g_ctx));
+    TEST_ASSERT_EQUAL(0, stats.error_count);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    ws_session_disconnect_ExpectAndReturn(session, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    vpn_controller_cleanup_Expect();
+    ws_session_close_Expect(session);
+    ws_client_cleanup_Expect();
+    client_sm_cleanup(g_ctx);
+}
+
+void test_client_sm_should_fail_press_when_primary_and_fanout_fail(void) {
+    // Arrange
+    ws_session_t *session = (ws_session_t *)&g_fake_session;
+    failure_stats_t failures;
+    init_client();
+    server_fanout_add_server("10.0.0.2", 9000);
+    ws_session_set_callbacks_StubWithCallback(capture_session_callbacks);
+    ws_session_set_redirect_callback_Ignore();
+    client_sm_trigger_button(g_ctx, false);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    ws_session_open_ExpectAndReturn("10.0.0.2", 9000, session);
+    ws_session_get_state_ExpectAndReturn(session, WS_STATE_DISCONNECTED);
+    ws_session_connect_ExpectAndReturn(session, 0);
+    ws_session_get_state_ExpectAndReturn(session, WS_STATE_CONNECTING);
+    ws_client_connect_ExpectAndReturn(-1);
+    client_sm_update(g_ctx);
+    
+    // Act - the extra server's query fails as well
+    ws_session_query_ps5_status_ExpectAndReturn(session, -1);
+    g_fanout_on_connected(g_fanout_user_data);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    
+    // Assert - the press fails with the primary's cause
+    client_sm_get_failure_stats(g_ctx, &failures);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_ERROR, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL(1, failures.causes[FAILURE_CAUSE_WS_ERROR].count);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    ws_session_disconnect_ExpectAndReturn(session, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    vpn_controller_cleanup_Expect();
+    ws_session_close_Expect(session);
+    ws_client_cleanup_Expect();
+    client_sm_cleanup(g_ctx);
+}
+
+/* ============================================================
+ *  Test Group 16: Error Retry Tests
+ * ============================================================ */
+
+static void fail_vpn_connect(void) {
+    client_sm_trigger_button(g_ctx, false);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_ERROR);
+    vpn_controller_get_last_error_ExpectAndReturn(VPN_ERROR_REJECTED);
+    vpn_controller_error_to_string_ExpectAndReturn(VPN_ERROR_REJECTED, "REJECTED");
+    client_sm_update(g_ctx);
+}
+
+void test_client_sm_error_state_should_wait_without_blocking(void) {
+    // Arrange
+    struct timespec start, end;
+    init_client();
+    fail_vpn_connect();
+    
+    // Act
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < 3; i++) {
+        vpn_controller_process_ExpectAndReturn(10, 0);
+        ws_client_service_ExpectAndReturn(10, 0);
+        client_sm_update(g_ctx);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    // Assert - still waiting, but every pass returned at once
+    TEST_ASSERT_EQUAL(CLIENT_STATE_ERROR, client_sm_get_state(g_ctx));
+    TEST_ASSERT_LESS_THAN(1, end.tv_sec - start.tv_sec);
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_ERROR);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_error_state_should_retry_after_deadline(void) {
+    // Arrange
+    init_client();
+    fail_vpn_connect();
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    
+    // Act
+    client_sm_test_age_state(g_ctx, CLIENT_RETRY_INTERVAL_S * 1000);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(CLIENT_STATE_CLEANUP, client_sm_get_state(g_ctx));
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_ERROR);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+/* ============================================================
+ *  Test Group 17: Redirect Tests
+ * ============================================================ */
+
+void test_client_sm_redirect_after_press_should_move_primary_when_idle(void) {
+    // Arrange - a press answered by the primary
+    fanout_entry_t table[1];
+    init_client();
+    run_press_to_query();
+    const char *reply = "{\"status\":\"standby\"}";
+    g_ws_on_message(reply, strlen(reply), g_ws_user_data);
+    
+    // Act - the redirect arrives while the answer is shown
+    g_ws_on_redirect("10.0.0.9", 9100, g_ws_redirect_data);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_WAITING, client_sm_get_state(g_ctx));
+    client_sm_get_status_table(g_ctx, table, 1);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.1", table[0].host);
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_DISCONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_IDLE, client_sm_get_state(g_ctx));
+    
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    ws_client_set_server_ExpectAndReturn("10.0.0.9", 9100, 0);
+    client_sm_update(g_ctx);
+    
+    // Assert - the status table follows, the next press connects there
+    client_sm_get_status_table(g_ctx, table, 1);
+    TEST_ASSERT_EQUAL_STRING("10.0.0.9", table[0].host);
+    TEST_ASSERT_EQUAL(9100, table[0].port);
+    
+    client_sm_trigger_button(g_ctx, false);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    client_sm_update(g_ctx);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    ws_client_connect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_WS_CONNECTING, client_sm_get_state(g_ctx));
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
+
+void test_client_sm_redirect_mid_press_should_reconnect_to_new_server(void) {
+    // Arrange
+    fanout_entry_t table[1];
+    init_client();
+    run_press_to_query();
+    
+    // Act - redirected before the primary answered
+    g_ws_on_redirect("10.0.0.9", 9100, g_ws_redirect_data);
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_disconnect_ExpectAndReturn(0);
+    ws_client_set_server_ExpectAndReturn("10.0.0.9", 9100, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    ws_client_get_hint_state_ExpectAndReturn(NULL, 0);
+    ws_client_connect_ExpectAndReturn(0);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    client_sm_get_status_table(g_ctx, table, 1);
+    TEST_ASSERT_EQUAL(CLIENT_STATE_WS_CONNECTING, client_sm_get_state(g_ctx));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.9", table[0].host);
+    
+    // Act - a link that drops again is left to the retry path
+    vpn_controller_process_ExpectAndReturn(10, 0);
+    ws_client_service_ExpectAndReturn(10, 0);
+    ws_client_get_state_ExpectAndReturn(WS_STATE_DISCONNECTED);
+    client_sm_update(g_ctx);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(CLIENT_STATE_WS_CONNECTING, client_sm_get_state(g_ctx));
+    
+    ws_client_disconnect_ExpectAndReturn(0);
+    vpn_controller_get_state_ExpectAndReturn(VPN_STATE_CONNECTED);
+    vpn_controller_disconnect_ExpectAndReturn(0);
+    cleanup_client();
+}
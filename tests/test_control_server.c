@@ -0,0 +1,330 @@
+/**
+ * @file test_control_server.c
+ * @brief Unit tests for control server module
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "control_server.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static char g_socket_path[64];
+
+static int write_snapshot(char *buffer, size_t size, void *user_data) {
+    return snprintf(buffer, size, "{\"state\":\"IDLE\"}");
+}
+
+/**
+ * @brief Connect a control client
+ */
+static int connect_client(void) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, g_socket_path, sizeof(addr.sun_path) - 1);
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    control_server_process();  // Accept
+    return fd;
+}
+
+static void send_command(int fd, const char *command) {
+    TEST_ASSERT_EQUAL((ssize_t)strlen(command), send(fd, command, strlen(command), 0));
+    control_server_process();
+}
+
+/**
+ * @brief Read everything the server has written so far
+ */
+static int read_available(int fd, char *buffer, size_t size) {
+    ssize_t n = recv(fd, buffer, size - 1, MSG_DONTWAIT);
+    if (n < 0) {
+        n = 0;
+    }
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+static int count_lines(const char *text) {
+    int lines = 0;
+    for (; *text != '\0'; text++) {
+        if (*text == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+void setUp(void) {
+    snprintf(g_socket_path, sizeof(g_socket_path), "/tmp/test_control_%d.sock", (int)getpid());
+    TEST_ASSERT_EQUAL(0, control_server_init(g_socket_path, write_snapshot, NULL));
+}
+
+void tearDown(void) {
+    control_server_cleanup();
+}
+
+/* ============================================================
+ *  Test Group 1: Initialization
+ * ============================================================ */
+
+void test_control_server_init_should_fail_when_already_initialized(void) {
+    TEST_ASSERT_EQUAL(-1, control_server_init(g_socket_path, write_snapshot, NULL));
+}
+
+void test_control_server_socket_should_be_owner_only(void) {
+    // Arrange
+    struct stat st;
+
+    // Act
+    TEST_ASSERT_EQUAL(0, stat(g_socket_path, &st));
+
+    // Assert
+    TEST_ASSERT_EQUAL(CONTROL_SOCKET_MODE, st.st_mode & 0777);
+}
+
+void test_control_server_cleanup_should_remove_socket(void) {
+    // Act
+    control_server_cleanup();
+
+    // Assert
+    TEST_ASSERT_EQUAL(-1, access(g_socket_path, F_OK));
+}
+
+void test_control_server_publish_should_fail_when_not_initialized(void) {
+    // Arrange
+    control_server_cleanup();
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, control_server_publish(CONTROL_TOPIC_STATE, "{}"));
+}
+
+/* ============================================================
+ *  Test Group 2: Commands
+ * ============================================================ */
+
+void test_control_server_status_should_return_snapshot(void) {
+    // Arrange
+    char buffer[256];
+    int fd = connect_client();
+
+    // Act
+    send_command(fd, "status\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"status\",\"data\":{\"state\":\"IDLE\"}}\n", buffer);
+    close(fd);
+}
+
+void test_control_server_should_handle_split_and_batched_commands(void) {
+    // Arrange
+    char buffer[256];
+    int fd = connect_client();
+
+    // Act
+    send_command(fd, "pi");
+    send_command(fd, "ng\r\nping\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"pong\"}\n{\"type\":\"pong\"}\n", buffer);
+    close(fd);
+}
+
+static int g_press_count;
+
+static int record_press(void *user_data) {
+    g_press_count++;
+    return (user_data == NULL) ? 0 : -1;
+}
+
+void test_control_server_press_should_call_handler(void) {
+    // Arrange
+    char buffer[256];
+    int fd = connect_client();
+    g_press_count = 0;
+    control_server_set_press_handler(record_press, NULL);
+
+    // Act
+    send_command(fd, "press\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(1, g_press_count);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"press\",\"accepted\":true}\n", buffer);
+    close(fd);
+}
+
+void test_control_server_press_should_report_rejected_press(void) {
+    // Arrange
+    char buffer[256];
+    int fd = connect_client();
+    control_server_set_press_handler(record_press, &g_press_count);
+
+    // Act
+    send_command(fd, "press\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"press\",\"accepted\":false}\n", buffer);
+    close(fd);
+}
+
+void test_control_server_should_reject_unknown_command(void) {
+    // Arrange
+    char buffer[256];
+    int fd = connect_client();
+
+    // Act
+    send_command(fd, "reboot\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "unknown command"));
+    close(fd);
+}
+
+/* ============================================================
+ *  Test Group 3: Subscriptions
+ * ============================================================ */
+
+void test_control_server_watch_should_send_latest_values(void) {
+    // Arrange
+    char buffer[512];
+    control_server_publish(CONTROL_TOPIC_PS5, "{\"status\":\"ON\"}");
+    int fd = connect_client();
+
+    // Act
+    send_command(fd, "watch\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"type\":\"event\",\"topic\":\"ps5\",\"seq\":1,\"data\":{\"status\":\"ON\"}}\n", buffer);
+    TEST_ASSERT_EQUAL(1, control_server_get_subscriber_count());
+    close(fd);
+}
+
+void test_control_server_should_push_updates_to_subscribers(void) {
+    // Arrange
+    char buffer[512];
+    int watcher = connect_client();
+    int other = connect_client();
+    send_command(watcher, "watch\n");
+
+    // Act
+    control_server_publish(CONTROL_TOPIC_STATE, "{\"to\":\"VPN_CONNECTING\"}");
+    control_server_process();
+
+    // Assert
+    read_available(watcher, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "VPN_CONNECTING"));
+    TEST_ASSERT_EQUAL(0, read_available(other, buffer, sizeof(buffer)));
+    close(watcher);
+    close(other);
+}
+
+void test_control_server_should_coalesce_updates_per_topic(void) {
+    // Arrange
+    char buffer[512];
+    control_stats_t stats;
+    int fd = connect_client();
+    send_command(fd, "watch\n");
+    control_server_publish(CONTROL_TOPIC_STATE, "{\"to\":\"VPN_CONNECTING\"}");
+    control_server_process();
+    read_available(fd, buffer, sizeof(buffer));
+
+    // Act - three transitions between two passes of the main loop
+    control_server_publish(CONTROL_TOPIC_STATE, "{\"to\":\"VPN_CONNECTED\"}");
+    control_server_publish(CONTROL_TOPIC_STATE, "{\"to\":\"WS_CONNECTING\"}");
+    control_server_publish(CONTROL_TOPIC_STATE, "{\"to\":\"QUERYING\"}");
+    control_server_process();
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(1, count_lines(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "QUERYING"));
+    control_server_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.events_coalesced);
+    close(fd);
+}
+
+void test_control_server_unwatch_should_stop_events(void) {
+    // Arrange
+    char buffer[512];
+    int fd = connect_client();
+    send_command(fd, "watch\n");
+    send_command(fd, "unwatch\n");
+
+    // Act
+    control_server_publish(CONTROL_TOPIC_METRICS, "{\"presses\":1}");
+    control_server_process();
+
+    // Assert
+    TEST_ASSERT_EQUAL(0, read_available(fd, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(0, control_server_get_subscriber_count());
+    close(fd);
+}
+
+void test_control_server_should_drop_subscriber_that_stops_reading(void) {
+    // Arrange
+    char payload[CONTROL_EVENT_MAX];
+    control_stats_t stats;
+    int fd = connect_client();
+    send_command(fd, "watch\n");
+    control_server_set_stall_timeout(0);
+
+    memset(payload, 'x', sizeof(payload));
+    memcpy(payload, "{\"p\":\"", 6);
+    memcpy(payload + sizeof(payload) - 3, "\"}", 3);
+
+    // Act - never read until the socket buffer fills
+    for (int i = 0; i < 100000 && control_server_get_subscriber_count() > 0; i++) {
+        control_server_publish(CONTROL_TOPIC_METRICS, payload);
+        control_server_process();
+    }
+
+    // Assert
+    control_server_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, control_server_get_subscriber_count());
+    TEST_ASSERT_EQUAL(1, stats.slow_drops);
+    close(fd);
+}
+
+void test_control_server_should_drop_closed_client(void) {
+    // Arrange
+    int fd = connect_client();
+    send_command(fd, "watch\n");
+
+    // Act
+    close(fd);
+    control_server_process();
+
+    // Assert
+    TEST_ASSERT_EQUAL(0, control_server_get_subscriber_count());
+}
+
+void test_control_topic_to_string_should_return_names(void) {
+    TEST_ASSERT_EQUAL_STRING("state", control_topic_to_string(CONTROL_TOPIC_STATE));
+    TEST_ASSERT_EQUAL_STRING("ps5", control_topic_to_string(CONTROL_TOPIC_PS5));
+    TEST_ASSERT_EQUAL_STRING("metrics", control_topic_to_string(CONTROL_TOPIC_METRICS));
+    TEST_ASSERT_EQUAL_STRING("failures", control_topic_to_string(CONTROL_TOPIC_FAILURES));
+    TEST_ASSERT_EQUAL_STRING("unknown", control_topic_to_string(CONTROL_TOPIC_COUNT));
+}
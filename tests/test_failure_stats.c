@@ -0,0 +1,126 @@
+/**
+ * @file test_failure_stats.c
+ * @brief Unit tests for failure statistics module
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "unity.h"
+#include "failure_stats.h"
+#include <string.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static failure_stats_t g_stats;
+
+void setUp(void) {
+    failure_stats_init(&g_stats);
+}
+
+void tearDown(void) {
+}
+
+/* ============================================================
+ *  Test Group 1: Outages
+ * ============================================================ */
+
+void test_failure_stats_should_attribute_outage_to_first_cause(void) {
+    // Arrange
+    failure_stats_record(&g_stats, FAILURE_CAUSE_WS_DNS, "getaddrinfo failed", 1000);
+    failure_stats_record(&g_stats, FAILURE_CAUSE_WS_TIMEOUT, NULL, 3000);
+
+    // Act
+    uint32_t elapsed = failure_stats_recovered(&g_stats, 7500);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(6500, elapsed);
+    TEST_ASSERT_EQUAL(1, g_stats.causes[FAILURE_CAUSE_WS_DNS].count);
+    TEST_ASSERT_EQUAL(1, g_stats.causes[FAILURE_CAUSE_WS_DNS].recovered);
+    TEST_ASSERT_EQUAL_UINT32(6500, g_stats.causes[FAILURE_CAUSE_WS_DNS].ttr_total_ms);
+    TEST_ASSERT_EQUAL(1, g_stats.causes[FAILURE_CAUSE_WS_DNS].ttr_histogram[3]);  // 5-10 s
+    TEST_ASSERT_EQUAL(1, g_stats.causes[FAILURE_CAUSE_WS_TIMEOUT].count);
+    TEST_ASSERT_EQUAL(0, g_stats.causes[FAILURE_CAUSE_WS_TIMEOUT].recovered);
+}
+
+void test_failure_stats_recovered_should_ignore_success_without_outage(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, failure_stats_recovered(&g_stats, 1000));
+    failure_stats_record(&g_stats, FAILURE_CAUSE_NONE, NULL, 1000);
+    TEST_ASSERT_FALSE(g_stats.outage_open);
+}
+
+void test_failure_stats_should_put_long_outages_in_last_bucket(void) {
+    // Arrange
+    failure_stats_record(&g_stats, FAILURE_CAUSE_AGENT_UNREACHABLE, NULL, 0);
+
+    // Act
+    failure_stats_recovered(&g_stats, 600000);
+
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_stats.causes[FAILURE_CAUSE_AGENT_UNREACHABLE]
+                             .ttr_histogram[FAILURE_TTR_BUCKETS - 1]);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, failure_stats_bucket_limit_ms(FAILURE_TTR_BUCKETS - 1));
+}
+
+/* ============================================================
+ *  Test Group 2: Records and Export
+ * ============================================================ */
+
+void test_failure_stats_get_recent_should_return_newest_first(void) {
+    // Arrange
+    failure_record_t records[3];
+    for (uint32_t i = 0; i < FAILURE_LOG_SIZE + 2; i++) {
+        failure_stats_record(&g_stats, FAILURE_CAUSE_QUERY_TIMEOUT, NULL, i);
+    }
+
+    // Act
+    int count = failure_stats_get_recent(&g_stats, records, 3);
+
+    // Assert
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL_UINT32(FAILURE_LOG_SIZE + 1, records[0].time_ms);
+    TEST_ASSERT_EQUAL_UINT32(FAILURE_LOG_SIZE - 1, records[2].time_ms);
+}
+
+void test_failure_stats_rank_should_order_by_time_lost(void) {
+    // Arrange
+    failure_cause_t ranked[FAILURE_CAUSE_COUNT];
+    failure_stats_record(&g_stats, FAILURE_CAUSE_PARSE_ERROR, NULL, 0);
+    failure_stats_recovered(&g_stats, 500);
+    failure_stats_record(&g_stats, FAILURE_CAUSE_VPN_DNS, NULL, 1000);
+    failure_stats_recovered(&g_stats, 31000);
+    failure_stats_record(&g_stats, FAILURE_CAUSE_WS_REFUSED, NULL, 40000);
+
+    // Act
+    int count = failure_stats_rank(&g_stats, ranked, FAILURE_CAUSE_COUNT);
+
+    // Assert
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(FAILURE_CAUSE_VPN_DNS, ranked[0]);
+    TEST_ASSERT_EQUAL(FAILURE_CAUSE_PARSE_ERROR, ranked[1]);
+    TEST_ASSERT_EQUAL(FAILURE_CAUSE_WS_REFUSED, ranked[2]);
+}
+
+void test_failure_stats_to_json_should_keep_costliest_causes(void) {
+    // Arrange
+    char buffer[64];
+    failure_stats_record(&g_stats, FAILURE_CAUSE_WS_PONG_TIMEOUT, NULL, 0);
+    failure_stats_recovered(&g_stats, 1500);
+    failure_stats_record(&g_stats, FAILURE_CAUSE_BUDGET, NULL, 2000);
+
+    // Act
+    int len = failure_stats_to_json(&g_stats, buffer, sizeof(buffer));
+
+    // Assert
+    TEST_ASSERT_EQUAL((int)strlen(buffer), len);
+    TEST_ASSERT_EQUAL_STRING("{\"ws_pong_timeout\":[1,1,1500,1500,[0,1,0,0,0,0,0,0]]}", buffer);
+}
+
+void test_failure_cause_to_string_should_return_names(void) {
+    TEST_ASSERT_EQUAL_STRING("agent_unreachable",
+                             failure_cause_to_string(FAILURE_CAUSE_AGENT_UNREACHABLE));
+    TEST_ASSERT_EQUAL_STRING("ws_handshake", failure_cause_to_string(FAILURE_CAUSE_WS_HANDSHAKE));
+    TEST_ASSERT_EQUAL_STRING("unknown", failure_cause_to_string(FAILURE_CAUSE_COUNT));
+}
@@ -0,0 +1,331 @@
+/**
+ * @file test_json_scan.c
+ * @brief Unit tests for JSON scanner module
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "unity.h"
+#include "json_scan.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static char g_payload[8192];
+static uint32_t g_positions[JSON_SCAN_MAX_STRUCTURALS];
+static uint32_t g_scalar_positions[JSON_SCAN_MAX_STRUCTURALS];
+
+void setUp(void) {
+    memset(g_payload, 0, sizeof(g_payload));
+}
+
+void tearDown(void) {
+}
+
+/**
+ * @brief Build a multi-console status table larger than the SIMD threshold
+ */
+static size_t build_console_table(const char *status) {
+    size_t len = (size_t)snprintf(g_payload, sizeof(g_payload), "{\"consoles\":[");
+    
+    for (int i = 0; i < 20; i++) {
+        len += (size_t)snprintf(g_payload + len, sizeof(g_payload) - len,
+                                "%s{\"id\":\"ps5-%02d\",\"name\":\"Living \\\"Room\\\" %d\","
+                                "\"state\":\"standby\",\"uptime\":%d}",
+                                i == 0 ? "" : ",", i, i, i * 60);
+    }
+    
+    len += (size_t)snprintf(g_payload + len, sizeof(g_payload) - len,
+                            "],\"status\" : \"%s\"}", status);
+    return len;
+}
+
+/* ============================================================
+ *  Test Group 1: Structural Index Tests
+ * ============================================================ */
+
+void test_json_scan_structurals_should_index_small_object(void) {
+    // Arrange
+    const char *json = "{\"a\":[1,2]}";
+    
+    // Act
+    size_t count = json_scan_structurals(json, strlen(json), g_positions, JSON_SCAN_MAX_STRUCTURALS);
+    
+    // Assert: { " " : [ , ] }
+    TEST_ASSERT_EQUAL(8, count);
+    TEST_ASSERT_EQUAL(0, g_positions[0]);
+    TEST_ASSERT_EQUAL(4, g_positions[3]);
+    TEST_ASSERT_EQUAL(10, g_positions[7]);
+}
+
+void test_json_scan_structurals_should_match_scalar(void) {
+    // Arrange
+    size_t len = build_console_table("on");
+    
+    // Act
+    size_t simd = json_scan_structurals(g_payload, len, g_positions, JSON_SCAN_MAX_STRUCTURALS);
+    size_t scalar = json_scan_structurals_scalar(g_payload, len, g_scalar_positions,
+                                                 JSON_SCAN_MAX_STRUCTURALS);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(scalar, simd);
+    TEST_ASSERT_EQUAL_MEMORY(g_scalar_positions, g_positions, simd * sizeof(uint32_t));
+}
+
+void test_json_scan_structurals_should_report_overflow(void) {
+    // Arrange
+    const char *json = "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18]";
+    
+    // Act
+    size_t count = json_scan_structurals(json, strlen(json), g_positions, 4);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(5, count);
+}
+
+/* ============================================================
+ *  Test Group 2: Key Lookup Tests
+ * ============================================================ */
+
+void test_json_scan_find_string_should_find_value(void) {
+    // Arrange
+    const char *json = "{\"type\":\"status\",\"status\":\"standby\"}";
+    const char *value = NULL;
+    size_t value_length = 0;
+    
+    // Act
+    int result = json_scan_find_string(json, strlen(json), "status", &value, &value_length);
+    
+    // Assert: "status" as a value must not match
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(7, value_length);
+    TEST_ASSERT_EQUAL_MEMORY("standby", value, value_length);
+}
+
+void test_json_scan_find_string_should_find_value_in_large_payload(void) {
+    // Arrange
+    size_t len = build_console_table("off");
+    const char *value = NULL;
+    size_t value_length = 0;
+    TEST_ASSERT_TRUE(len >= JSON_SCAN_SIMD_THRESHOLD);
+    
+    // Act
+    int result = json_scan_find_string(g_payload, len, "status", &value, &value_length);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(3, value_length);
+    TEST_ASSERT_EQUAL_MEMORY("off", value, value_length);
+}
+
+void test_json_scan_find_string_should_skip_escaped_quotes(void) {
+    // Arrange
+    const char *json = "{\"note\":\"say \\\"status\\\":\\\"on\\\"\\\\\",\"status\":\"off\"}";
+    const char *value = NULL;
+    size_t value_length = 0;
+    
+    // Act
+    int result = json_scan_find_string(json, strlen(json), "status", &value, &value_length);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_MEMORY("off", value, 3);
+}
+
+void test_json_scan_find_string_should_fail_for_non_string_value(void) {
+    // Arrange
+    const char *json = "{\"status\":5,\"other\":\"on\"}";
+    const char *value = NULL;
+    size_t value_length = 0;
+    
+    // Act
+    int result = json_scan_find_string(json, strlen(json), "status", &value, &value_length);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(-1, result);
+}
+
+void test_json_scan_find_string_should_fail_when_key_missing(void) {
+    // Arrange
+    const char *json = "{\"state\":\"on\"}";
+    const char *value = NULL;
+    size_t value_length = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, json_scan_find_string(json, strlen(json), "status", &value, &value_length));
+    TEST_ASSERT_EQUAL(-1, json_scan_find_string(NULL, 0, "status", &value, &value_length));
+}
+
+void test_json_scan_find_int_should_find_value(void) {
+    // Arrange
+    const char *json = "{\"type\":\"hint\",\"retry_after_ms\": 15000,\"rate\":-2}";
+    long value = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, json_scan_find_int(json, strlen(json), "retry_after_ms", &value));
+    TEST_ASSERT_EQUAL(15000, value);
+    TEST_ASSERT_EQUAL(0, json_scan_find_int(json, strlen(json), "rate", &value));
+    TEST_ASSERT_EQUAL(-2, value);
+}
+
+void test_json_scan_find_int_should_reject_non_integers(void) {
+    // Arrange
+    const char *json = "{\"a\":\"5\",\"b\":1.5,\"c\":true,\"d\":99999999999999999999}";
+    long value = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_int(json, strlen(json), "a", &value));
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_int(json, strlen(json), "b", &value));
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_int(json, strlen(json), "c", &value));
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_int(json, strlen(json), "d", &value));
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_int(json, strlen(json), "e", &value));
+}
+
+void test_json_scan_find_top_string_should_skip_nested_keys(void) {
+    // Arrange
+    const char *json = "{\"data\":{\"type\":\"ack\"},\"list\":[{\"type\":\"hint\"}],"
+                       "\"type\":\"ps5_status\"}";
+    const char *nested_only = "{\"data\":{\"type\":\"ack\"}}";
+    const char *value = NULL;
+    size_t value_length = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, json_scan_find_top_string(json, strlen(json), "type", &value, &value_length));
+    TEST_ASSERT_EQUAL(10, value_length);
+    TEST_ASSERT_EQUAL_MEMORY("ps5_status", value, value_length);
+    TEST_ASSERT_EQUAL(-1, json_scan_find_top_string(nested_only, strlen(nested_only), "type",
+                                                    &value, &value_length));
+}
+
+void test_json_scan_find_top_int_should_skip_nested_keys(void) {
+    // Arrange
+    const char *json = "{\"data\":{\"ttl_ms\":5,\"s\":\"}\"},\"ttl_ms\":7}";
+    const char *nested_only = "{\"data\":[{\"ttl_ms\":5}]}";
+    long value = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, json_scan_find_top_int(json, strlen(json), "ttl_ms", &value));
+    TEST_ASSERT_EQUAL(7, value);
+    TEST_ASSERT_LESS_THAN(0, json_scan_find_top_int(nested_only, strlen(nested_only), "ttl_ms", &value));
+}
+
+/* ============================================================
+ *  Test Group 3: UTF-8 Validation Tests
+ * ============================================================ */
+
+void test_json_scan_utf8_should_accept_valid_text(void) {
+    // Arrange: ASCII, 2/3/4-byte sequences, crossing a 16-byte block boundary
+    const char *text = "{\"name\":\"Sal\xC3\xB3n \xE5\xAE\xA2\xE5\xBB\xB3 \xF0\x9F\x8E\xAE\"}";
+    
+    // Act & Assert
+    TEST_ASSERT_TRUE(json_scan_utf8_valid(text, strlen(text)));
+    TEST_ASSERT_TRUE(json_scan_utf8_valid_scalar(text, strlen(text)));
+}
+
+void test_json_scan_utf8_should_reject_invalid_sequences(void) {
+    // Arrange
+    const char *invalid[] = {
+        "\x80",                 // Lone continuation
+        "\xC0\xAF",             // Overlong
+        "\xE0\x80\xAF",         // Overlong 3-byte
+        "\xED\xA0\x80",         // Surrogate
+        "\xF4\x90\x80\x80",     // Above U+10FFFF
+        "\xF5\x80\x80\x80",     // Invalid lead byte
+        "abc\xE5\xAE",          // Truncated
+    };
+    
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        // Act & Assert
+        TEST_ASSERT_FALSE(json_scan_utf8_valid(invalid[i], strlen(invalid[i])));
+        TEST_ASSERT_FALSE(json_scan_utf8_valid_scalar(invalid[i], strlen(invalid[i])));
+    }
+}
+
+void test_json_scan_utf8_should_match_scalar_at_every_offset(void) {
+    // Arrange
+    size_t len = build_console_table("on");
+    
+    // Act & Assert: an invalid byte at any position is caught by both paths
+    for (size_t i = 0; i < len; i += 7) {
+        char saved = g_payload[i];
+        g_payload[i] = (char)0xFF;
+        TEST_ASSERT_FALSE(json_scan_utf8_valid(g_payload, len));
+        TEST_ASSERT_FALSE(json_scan_utf8_valid_scalar(g_payload, len));
+        g_payload[i] = saved;
+    }
+    TEST_ASSERT_TRUE(json_scan_utf8_valid(g_payload, len));
+}
+
+void test_json_scan_backend_should_be_named(void) {
+    TEST_ASSERT_NOT_NULL(json_scan_backend());
+}
+
+/* ============================================================
+ *  Test Group 4: Array Element Tests
+ * ============================================================ */
+
+static char g_elements[8][64];
+static int g_element_count = 0;
+
+static void collect_element(const char *element, size_t length, void *user_data) {
+    if (g_element_count < 8 && length < sizeof(g_elements[0])) {
+        memcpy(g_elements[g_element_count], element, length);
+        g_elements[g_element_count][length] = '\0';
+    }
+    g_element_count++;
+}
+
+void test_json_scan_for_each_element_should_split_nested_array(void) {
+    // Arrange
+    const char *json = "{\"type\":\"batch\",\"messages\": [ {\"a\":[1,2]} , "
+                       "{\"b\":\"x,]}\"},\n\"s\" ,7]}";
+    g_element_count = 0;
+    
+    // Act
+    int count = json_scan_for_each_element(json, strlen(json), "messages", collect_element, NULL);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2]}", g_elements[0]);
+    TEST_ASSERT_EQUAL_STRING("{\"b\":\"x,]}\"}", g_elements[1]);
+    TEST_ASSERT_EQUAL_STRING("\"s\"", g_elements[2]);
+    TEST_ASSERT_EQUAL_STRING("7", g_elements[3]);
+}
+
+void test_json_scan_for_each_element_should_handle_empty_array(void) {
+    // Arrange
+    const char *json = "{\"messages\":[]}";
+    g_element_count = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, json_scan_for_each_element(json, strlen(json), "messages", collect_element, NULL));
+    TEST_ASSERT_EQUAL(0, g_element_count);
+}
+
+void test_json_scan_for_each_element_should_fail_when_unterminated(void) {
+    // Arrange
+    const char *json = "{\"messages\":[{\"a\":1},{\"b\":2}";
+    const char *missing = "{\"messages\":\"none\"}";
+    g_element_count = 0;
+    
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, json_scan_for_each_element(json, strlen(json), "messages", collect_element, NULL));
+    TEST_ASSERT_LESS_THAN(0, json_scan_for_each_element(missing, strlen(missing), "messages", collect_element, NULL));
+}
+
+void test_json_scan_for_each_top_element_should_skip_nested_arrays(void) {
+    // Arrange
+    const char *json = "{\"data\":{\"messages\":[1,2,3]},\"messages\":[\"a\"]}";
+    g_element_count = 0;
+    
+    // Act
+    int count = json_scan_for_each_top_element(json, strlen(json), "messages", collect_element, NULL);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL_STRING("\"a\"", g_elements[0]);
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test_lan_status_server.c
+ * @brief Unit tests for LAN status server module
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "lan_status_server.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+/**
+ * @brief Connect to the server on loopback
+ */
+static int connect_client(void) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)lan_status_server_get_port());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    lan_status_server_process();  // Accept
+    return fd;
+}
+
+static int request(const char *head) {
+    int fd = connect_client();
+    TEST_ASSERT_EQUAL((ssize_t)strlen(head), send(fd, head, strlen(head), 0));
+    lan_status_server_process();
+    return fd;
+}
+
+/**
+ * @brief Read everything the server has written so far
+ */
+static int read_available(int fd, char *buffer, size_t size) {
+    size_t total = 0;
+    ssize_t n;
+
+    while (total < size - 1 &&
+           (n = recv(fd, buffer + total, size - 1 - total, MSG_DONTWAIT)) > 0) {
+        total += (size_t)n;
+    }
+    buffer[total] = '\0';
+    return (int)total;
+}
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(0, lan_status_server_init("127.0.0.1", 0));
+}
+
+void tearDown(void) {
+    lan_status_server_cleanup();
+}
+
+/* ============================================================
+ *  Test Group 1: Initialization
+ * ============================================================ */
+
+void test_lan_status_server_init_should_reject_bad_address(void) {
+    // Arrange
+    lan_status_server_cleanup();
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, lan_status_server_init("not-an-ip", 0));
+    TEST_ASSERT_EQUAL(-1, lan_status_server_init(NULL, 70000));
+    TEST_ASSERT_EQUAL(-1, lan_status_server_get_port());
+}
+
+void test_lan_status_server_init_should_pick_port(void) {
+    TEST_ASSERT_GREATER_THAN(0, lan_status_server_get_port());
+}
+
+/* ============================================================
+ *  Test Group 2: Requests
+ * ============================================================ */
+
+void test_lan_status_server_should_serve_cached_status(void) {
+    // Arrange
+    char buffer[1024];
+    lan_status_server_update("{\"status\":\"ON\"}");
+
+    // Act
+    int fd = request("GET /status HTTP/1.1\r\nHost: router\r\n\r\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "HTTP/1.1 200 OK\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "Content-Type: application/json\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\r\n\r\n{\"status\":\"ON\"}"));
+    close(fd);
+}
+
+void test_lan_status_server_should_report_unknown_before_first_update(void) {
+    // Arrange
+    char buffer[1024];
+
+    // Act
+    int fd = request("GET /status?x=1 HTTP/1.0\r\n\r\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "{\"status\":\"UNKNOWN\"}"));
+    close(fd);
+}
+
+void test_lan_status_server_should_wait_for_complete_request(void) {
+    // Arrange
+    char buffer[1024];
+    int fd = request("GET /status HTTP/1.1\r\n");
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, read_available(fd, buffer, sizeof(buffer)));
+    send(fd, "\r\n", 2, 0);
+    lan_status_server_process();
+    TEST_ASSERT_GREATER_THAN(0, read_available(fd, buffer, sizeof(buffer)));
+    close(fd);
+}
+
+void test_lan_status_server_should_reject_unknown_paths_and_methods(void) {
+    // Arrange
+    char buffer[1024];
+    lan_status_stats_t stats;
+
+    // Act
+    int not_found = request("GET /admin HTTP/1.1\r\n\r\n");
+    int not_allowed = request("POST /status HTTP/1.1\r\n\r\n");
+
+    // Assert
+    read_available(not_found, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "404 Not Found"));
+    read_available(not_allowed, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "405 Method Not Allowed"));
+    lan_status_server_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.bad_requests);
+    close(not_found);
+    close(not_allowed);
+}
+
+/* ============================================================
+ *  Test Group 3: Event Streams
+ * ============================================================ */
+
+void test_lan_status_server_events_should_stream_current_status(void) {
+    // Arrange
+    char buffer[1024];
+    lan_status_server_update("{\"status\":\"STANDBY\"}");
+
+    // Act
+    int fd = request("GET /events HTTP/1.1\r\n\r\n");
+
+    // Assert
+    read_available(fd, buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "Content-Type: text/event-stream\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "data: {\"status\":\"STANDBY\"}\n\n"));
+    TEST_ASSERT_EQUAL(1, lan_status_server_get_subscriber_count());
+    close(fd);
+}
+
+void test_lan_status_server_events_should_push_coalesced_updates(void) {
+    // Arrange
+    char buffer[1024];
+    lan_status_stats_t stats;
+    int first = request("GET /events HTTP/1.1\r\n\r\n");
+    int second = request("GET /events HTTP/1.1\r\n\r\n");
+    read_available(first, buffer, sizeof(buffer));
+    read_available(second, buffer, sizeof(buffer));
+    lan_status_server_update("{\"status\":\"OFF\"}");
+    lan_status_server_process();
+    read_available(first, buffer, sizeof(buffer));
+    read_available(second, buffer, sizeof(buffer));
+
+    // Act - two updates between passes of the main loop
+    lan_status_server_update("{\"status\":\"STANDBY\"}");
+    lan_status_server_update("{\"status\":\"ON\"}");
+    lan_status_server_process();
+
+    // Assert
+    read_available(first, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("data: {\"status\":\"ON\"}\n\n", buffer);
+    read_available(second, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("data: {\"status\":\"ON\"}\n\n", buffer);
+    lan_status_server_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.updates_coalesced);
+    TEST_ASSERT_EQUAL(2, stats.peak_subscribers);
+    close(first);
+    close(second);
+}
+
+void test_lan_status_server_should_count_closed_subscriber(void) {
+    // Arrange
+    int fd = request("GET /events HTTP/1.1\r\n\r\n");
+
+    // Act
+    close(fd);
+    lan_status_server_process();
+
+    // Assert
+    TEST_ASSERT_EQUAL(0, lan_status_server_get_subscriber_count());
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_path_cache.c
+ * @brief Unit tests for path cache module
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "unity.h"
+#include "path_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+#define HOME_NETWORK    0x11111111u
+#define HOTEL_NETWORK   0x22222222u
+
+#define ROUTE_HEADER    "Iface\tDestination\tGateway \tFlags\tRefCnt\tUse\tMetric\tMask\t\tMTU\tWindow\tIRTT\n"
+#define ARP_HEADER      "IP address       HW type     Flags       HW address            Mask     Device\n"
+
+static path_cache_t g_cache;
+static char g_cache_path[64];
+static char g_route_path[64];
+static char g_arp_path[64];
+
+static void write_file(const char *path, const char *text) {
+    FILE *file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+void setUp(void) {
+    path_cache_init(&g_cache);
+    snprintf(g_cache_path, sizeof(g_cache_path), "/tmp/test_paths_%d", (int)getpid());
+    snprintf(g_route_path, sizeof(g_route_path), "/tmp/test_route_%d", (int)getpid());
+    snprintf(g_arp_path, sizeof(g_arp_path), "/tmp/test_arp_%d", (int)getpid());
+}
+
+void tearDown(void) {
+    remove(g_cache_path);
+    remove(g_route_path);
+    remove(g_arp_path);
+}
+
+/* ============================================================
+ *  Test Group 1: Network Fingerprint
+ * ============================================================ */
+
+void test_path_cache_probe_should_key_on_gateway_mac(void) {
+    // Arrange - default route via 192.168.8.1 on wan, plus a tunnel route
+    uint32_t home, hotel;
+    write_file(g_route_path, ROUTE_HEADER
+               "tun0\t00000080\t00000000\t0001\t0\t0\t0\t00000080\t0\t0\t0\n"
+               "wan\t00000000\t0108A8C0\t0003\t0\t0\t0\t00000000\t0\t0\t0\n");
+    write_file(g_arp_path, ARP_HEADER
+               "192.168.8.1      0x1         0x2         aa:bb:cc:00:00:01     *        wan\n");
+
+    // Act
+    TEST_ASSERT_EQUAL(0, path_cache_probe(g_route_path, g_arp_path, &home));
+    write_file(g_arp_path, ARP_HEADER
+               "192.168.8.1      0x1         0x2         aa:bb:cc:00:00:02     *        wan\n");
+    TEST_ASSERT_EQUAL(0, path_cache_probe(g_route_path, g_arp_path, &hotel));
+
+    // Assert - the same subnet elsewhere is another network
+    TEST_ASSERT_NOT_EQUAL(0, home);
+    TEST_ASSERT_NOT_EQUAL(home, hotel);
+}
+
+void test_path_cache_probe_should_fail_until_gateway_resolved(void) {
+    // Arrange - ARP entry still incomplete
+    uint32_t fingerprint = 0;
+    write_file(g_route_path, ROUTE_HEADER
+               "wan\t00000000\t0108A8C0\t0003\t0\t0\t0\t00000000\t0\t0\t0\n");
+    write_file(g_arp_path, ARP_HEADER
+               "192.168.8.1      0x1         0x0         00:00:00:00:00:00     *        wan\n");
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, path_cache_probe(g_route_path, g_arp_path, &fingerprint));
+    TEST_ASSERT_EQUAL(-1, path_cache_probe("/nonexistent/route", g_arp_path, &fingerprint));
+    TEST_ASSERT_EQUAL(0, fingerprint);
+}
+
+/* ============================================================
+ *  Test Group 2: Recording
+ * ============================================================ */
+
+void test_path_cache_should_smooth_latency_of_same_winner(void) {
+    // Arrange
+    path_cache_record(&g_cache, HOME_NETWORK, "192.168.1.1", 8080, 100);
+
+    // Act
+    path_cache_record(&g_cache, HOME_NETWORK, "192.168.1.1", 8080, 20);
+
+    // Assert
+    const path_cache_entry_t *entry = path_cache_lookup(&g_cache, HOME_NETWORK);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(80, entry->rtt_ms);
+    TEST_ASSERT_EQUAL(2, entry->presses);
+    TEST_ASSERT_NULL(path_cache_lookup(&g_cache, HOTEL_NETWORK));
+}
+
+void test_path_cache_should_replace_winner_with_its_latency(void) {
+    // Arrange
+    path_cache_record(&g_cache, HOTEL_NETWORK, "192.168.1.1", 8080, 900);
+
+    // Act
+    path_cache_record(&g_cache, HOTEL_NETWORK, "relay.example.net", 443, 60);
+
+    // Assert
+    const path_cache_entry_t *entry = path_cache_lookup(&g_cache, HOTEL_NETWORK);
+    TEST_ASSERT_EQUAL_STRING("relay.example.net", entry->host);
+    TEST_ASSERT_EQUAL(443, entry->port);
+    TEST_ASSERT_EQUAL(60, entry->rtt_ms);
+}
+
+void test_path_cache_should_evict_least_recently_used(void) {
+    // Arrange - fill the cache, then use the oldest network again
+    for (uint32_t i = 1; i <= PATH_CACHE_ENTRIES; i++) {
+        path_cache_record(&g_cache, i, "192.168.1.1", 8080, 50);
+    }
+    path_cache_record(&g_cache, 1, "192.168.1.1", 8080, 50);
+
+    // Act
+    TEST_ASSERT_EQUAL(0, path_cache_record(&g_cache, HOTEL_NETWORK, "10.0.0.1", 8080, 50));
+
+    // Assert
+    TEST_ASSERT_NOT_NULL(path_cache_lookup(&g_cache, 1));
+    TEST_ASSERT_NULL(path_cache_lookup(&g_cache, 2));
+    TEST_ASSERT_NOT_NULL(path_cache_lookup(&g_cache, HOTEL_NETWORK));
+}
+
+/* ============================================================
+ *  Test Group 3: Persistence
+ * ============================================================ */
+
+void test_path_cache_should_round_trip(void) {
+    // Arrange
+    path_cache_t loaded;
+    path_cache_record(&g_cache, HOME_NETWORK, "192.168.1.1", 8080, 40);
+
+    // Act
+    TEST_ASSERT_EQUAL(0, path_cache_save(&g_cache, g_cache_path));
+    TEST_ASSERT_EQUAL(0, path_cache_load(&loaded, g_cache_path));
+
+    // Assert
+    TEST_ASSERT_FALSE(g_cache.dirty);
+    const path_cache_entry_t *entry = path_cache_lookup(&loaded, HOME_NETWORK);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.1", entry->host);
+    TEST_ASSERT_EQUAL(40, entry->rtt_ms);
+    TEST_ASSERT_EQUAL(1, loaded.clock);
+}
+
+void test_path_cache_load_should_reject_foreign_file(void) {
+    // Arrange
+    write_file(g_cache_path, "not a path cache");
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, path_cache_load(&g_cache, g_cache_path));
+    TEST_ASSERT_NULL(path_cache_lookup(&g_cache, HOME_NETWORK));
+    TEST_ASSERT_EQUAL(-1, path_cache_load(&g_cache, "/nonexistent/paths"));
+}
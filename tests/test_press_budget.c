@@ -0,0 +1,121 @@
+/**
+ * @file test_press_budget.c
+ * @brief Unit tests for press budget module
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "unity.h"
+#include "press_budget.h"
+#include <string.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static press_budget_t g_budget;
+
+void setUp(void) {
+    press_budget_init(&g_budget, 8000);
+    press_budget_set_phase(&g_budget, PRESS_PHASE_VPN, 10000, 0);
+    press_budget_set_phase(&g_budget, PRESS_PHASE_WS, 5000, 1500);
+    press_budget_set_phase(&g_budget, PRESS_PHASE_QUERY, 3000, 1000);
+}
+
+void tearDown(void) {
+}
+
+/* ============================================================
+ *  Test Group 1: Allowance
+ * ============================================================ */
+
+void test_press_budget_first_phase_should_leave_reserves_for_later_phases(void) {
+    press_budget_start(&g_budget, 1000);
+    
+    TEST_ASSERT_EQUAL_UINT32(5500, press_budget_begin_phase(&g_budget, PRESS_PHASE_VPN, 1000));
+    TEST_ASSERT_TRUE(press_budget_is_limited(&g_budget));
+}
+
+void test_press_budget_phase_should_get_what_earlier_phases_left(void) {
+    press_budget_start(&g_budget, 0);
+    press_budget_begin_phase(&g_budget, PRESS_PHASE_VPN, 0);
+    press_budget_end_phase(&g_budget, 2000, false);
+    
+    // 6000 left, 1000 held back for the query
+    TEST_ASSERT_EQUAL_UINT32(5000, press_budget_begin_phase(&g_budget, PRESS_PHASE_WS, 2000));
+    TEST_ASSERT_FALSE(press_budget_is_limited(&g_budget));
+    press_budget_end_phase(&g_budget, 2500, false);
+    
+    TEST_ASSERT_EQUAL_UINT32(3000, press_budget_begin_phase(&g_budget, PRESS_PHASE_QUERY, 2500));
+}
+
+void test_press_budget_last_phase_should_be_cut_to_remaining_budget(void) {
+    press_budget_start(&g_budget, 0);
+    
+    TEST_ASSERT_EQUAL_UINT32(1200, press_budget_begin_phase(&g_budget, PRESS_PHASE_QUERY, 6800));
+    TEST_ASSERT_TRUE(press_budget_is_limited(&g_budget));
+    TEST_ASSERT_EQUAL_UINT32(1200, press_budget_remaining(&g_budget, 6800));
+}
+
+void test_press_budget_spent_budget_should_give_zero_allowance(void) {
+    press_budget_start(&g_budget, 0);
+    
+    TEST_ASSERT_EQUAL_UINT32(0, press_budget_begin_phase(&g_budget, PRESS_PHASE_WS, 7500));
+    TEST_ASSERT_EQUAL_UINT32(0, press_budget_remaining(&g_budget, 9000));
+}
+
+void test_press_budget_disabled_should_use_phase_caps(void) {
+    press_budget_init(&g_budget, 0);
+    press_budget_set_phase(&g_budget, PRESS_PHASE_WS, 5000, 1500);
+    press_budget_start(&g_budget, 0);
+    
+    TEST_ASSERT_EQUAL_UINT32(5000, press_budget_begin_phase(&g_budget, PRESS_PHASE_WS, 60000));
+    TEST_ASSERT_FALSE(press_budget_is_limited(&g_budget));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, press_budget_remaining(&g_budget, 60000));
+}
+
+void test_press_budget_invalid_phase_should_fail(void) {
+    TEST_ASSERT_EQUAL_INT(-1, press_budget_set_phase(&g_budget, PRESS_PHASE_COUNT, 1000, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, press_budget_begin_phase(&g_budget, PRESS_PHASE_COUNT, 0));
+}
+
+/* ============================================================
+ *  Test Group 2: Statistics
+ * ============================================================ */
+
+void test_press_budget_should_record_phase_durations_and_overruns(void) {
+    press_budget_start(&g_budget, 0);
+    press_budget_begin_phase(&g_budget, PRESS_PHASE_VPN, 0);
+    press_budget_end_phase(&g_budget, 5500, true);
+    press_budget_finish(&g_budget, true, false);
+    
+    press_budget_start(&g_budget, 10000);
+    press_budget_begin_phase(&g_budget, PRESS_PHASE_VPN, 10000);
+    press_budget_end_phase(&g_budget, 11000, false);
+    press_budget_finish(&g_budget, false, true);
+    
+    TEST_ASSERT_EQUAL_UINT32(2, g_budget.stats.presses);
+    TEST_ASSERT_EQUAL_UINT32(1, g_budget.stats.exhausted);
+    TEST_ASSERT_EQUAL_UINT32(1, g_budget.stats.cached_fallbacks);
+    TEST_ASSERT_EQUAL_UINT32(1, g_budget.stats.overruns[PRESS_PHASE_VPN]);
+    TEST_ASSERT_EQUAL_UINT32(0, g_budget.stats.overruns[PRESS_PHASE_WS]);
+    TEST_ASSERT_EQUAL_UINT32(1000, g_budget.stats.last_phase_ms[PRESS_PHASE_VPN]);
+    TEST_ASSERT_EQUAL_UINT32(5500, g_budget.stats.max_phase_ms[PRESS_PHASE_VPN]);
+}
+
+void test_press_budget_finish_should_count_once_per_press(void) {
+    press_budget_start(&g_budget, 0);
+    press_budget_finish(&g_budget, true, false);
+    press_budget_finish(&g_budget, true, false);
+    
+    TEST_ASSERT_EQUAL_UINT32(1, g_budget.stats.exhausted);
+    TEST_ASSERT_FALSE(g_budget.active);
+}
+
+void test_press_budget_phase_to_string_should_return_names(void) {
+    TEST_ASSERT_EQUAL_STRING("VPN", press_budget_phase_to_string(PRESS_PHASE_VPN));
+    TEST_ASSERT_EQUAL_STRING("WS", press_budget_phase_to_string(PRESS_PHASE_WS));
+    TEST_ASSERT_EQUAL_STRING("QUERY", press_budget_phase_to_string(PRESS_PHASE_QUERY));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", press_budget_phase_to_string(PRESS_PHASE_COUNT));
+}
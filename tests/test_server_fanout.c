@@ -0,0 +1,287 @@
+/**
+ * @file test_server_fanout.c
+ * @brief Unit tests for server fan-out module
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#include "unity.h"
+#include "server_fanout.h"
+#include "websocket_client.h"
+#include "json_scan.h"
+#include <string.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static int g_result_count;
+static int g_last_index;
+static fanout_entry_t g_last_entry;
+
+/**
+ * @brief Test parser: a leading digit is the status
+ */
+static int parse_digit(const char *message, size_t length) {
+    if (length > 0 && message[0] >= '0' && message[0] <= '9') {
+        return message[0] - '0';
+    }
+    return -1;
+}
+
+static void record_result(int index, const fanout_entry_t *entry, void *user_data) {
+    g_result_count++;
+    g_last_index = index;
+    g_last_entry = *entry;
+}
+
+static void add_connected_servers(int count) {
+    for (int i = 0; i < count; i++) {
+        server_fanout_add_server("10.0.0.2", 9000 + i);
+    }
+    server_fanout_connect_all();
+}
+
+void setUp(void) {
+    g_result_count = 0;
+    g_last_index = -1;
+    memset(&g_last_entry, 0, sizeof(g_last_entry));
+    
+    ws_client_init("192.168.1.1", 8765);
+    server_fanout_init(parse_digit, record_result, NULL);
+}
+
+void tearDown(void) {
+    server_fanout_cleanup();
+    ws_client_cleanup();
+}
+
+/* ============================================================
+ *  Test Group 1: Server List
+ * ============================================================ */
+
+void test_server_fanout_add_servers_should_parse_list(void) {
+    // Act
+    int added = server_fanout_add_servers(" 10.0.0.2:9000  home.lan ");
+    
+    // Assert
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    TEST_ASSERT_EQUAL(2, added);
+    TEST_ASSERT_EQUAL(2, server_fanout_get_results(entries, FANOUT_MAX_SERVERS));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", entries[0].host);
+    TEST_ASSERT_EQUAL(9000, entries[0].port);
+    TEST_ASSERT_EQUAL_STRING("home.lan", entries[1].host);
+    TEST_ASSERT_EQUAL(WS_DEFAULT_SERVER_PORT, entries[1].port);
+}
+
+void test_server_fanout_add_servers_should_reject_bad_port(void) {
+    TEST_ASSERT_LESS_THAN(0, server_fanout_add_servers("10.0.0.2:abc"));
+    TEST_ASSERT_LESS_THAN(0, server_fanout_add_servers("10.0.0.2:"));
+    TEST_ASSERT_LESS_THAN(0, server_fanout_add_servers("10.0.0.2:70000"));
+    TEST_ASSERT_EQUAL(0, server_fanout_get_count());
+}
+
+void test_server_fanout_add_server_should_fail_when_full(void) {
+    // Arrange
+    for (int i = 0; i < FANOUT_MAX_SERVERS; i++) {
+        TEST_ASSERT_EQUAL(i, server_fanout_add_server("10.0.0.2", 9000 + i));
+    }
+    
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, server_fanout_add_server("10.0.0.9", 9000));
+}
+
+void test_server_fanout_set_server_should_reopen_session(void) {
+    // Arrange
+    add_connected_servers(1);
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    TEST_ASSERT_LESS_THAN(0, server_fanout_set_server(0, "192.168.1.1", 8765));
+    ws_session_test_receive(server_fanout_test_get_session(0), "1", 1, true);
+    
+    // Act
+    TEST_ASSERT_EQUAL(0, server_fanout_set_server(0, "192.168.1.1", 8765));
+    
+    // Assert
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    server_fanout_get_results(entries, FANOUT_MAX_SERVERS);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.1", entries[0].host);
+    TEST_ASSERT_EQUAL(8765, entries[0].port);
+    TEST_ASSERT_EQUAL(0, entries[0].replies);
+    TEST_ASSERT_NULL(server_fanout_test_get_session(0));
+    TEST_ASSERT_LESS_THAN(0, server_fanout_set_server(1, "10.0.0.9", 9000));
+}
+
+/* ============================================================
+ *  Test Group 2: Queries
+ * ============================================================ */
+
+void test_server_fanout_query_all_should_mark_servers_pending(void) {
+    // Arrange
+    add_connected_servers(2);
+    
+    // Act
+    int queried = server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Assert
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    server_fanout_get_results(entries, FANOUT_MAX_SERVERS);
+    TEST_ASSERT_EQUAL(2, queried);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_PENDING, entries[0].result);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_PENDING, entries[1].result);
+    TEST_ASSERT_FALSE(server_fanout_is_complete());
+    TEST_ASSERT_EQUAL(0, g_result_count);
+}
+
+void test_server_fanout_should_report_each_reply_as_it_arrives(void) {
+    // Arrange
+    add_connected_servers(2);
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Act - the second server answers first
+    ws_session_test_receive(server_fanout_test_get_session(1), "3", 1, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_result_count);
+    TEST_ASSERT_EQUAL(1, g_last_index);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_OK, g_last_entry.result);
+    TEST_ASSERT_EQUAL(3, g_last_entry.status);
+    TEST_ASSERT_EQUAL(1, g_last_entry.replies);
+    TEST_ASSERT_FALSE(server_fanout_is_complete());
+    
+    // Act - the first server answers
+    ws_session_test_receive(server_fanout_test_get_session(0), "1", 1, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(2, g_result_count);
+    TEST_ASSERT_EQUAL(0, g_last_index);
+    TEST_ASSERT_TRUE(server_fanout_is_complete());
+}
+
+void test_server_fanout_should_ignore_unsolicited_replies(void) {
+    // Arrange
+    add_connected_servers(1);
+    
+    // Act
+    ws_session_test_receive(server_fanout_test_get_session(0), "3", 1, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, g_result_count);
+}
+
+void test_server_fanout_should_keep_waiting_on_unrelated_messages(void) {
+    // Arrange
+    add_connected_servers(1);
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Act
+    ws_session_test_receive(server_fanout_test_get_session(0), "x", 1, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, g_result_count);
+    TEST_ASSERT_FALSE(server_fanout_is_complete());
+}
+
+void test_server_fanout_should_fail_query_lost_on_disconnect(void) {
+    // Arrange
+    add_connected_servers(1);
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Act
+    ws_session_disconnect(server_fanout_test_get_session(0));
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_result_count);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_ERROR, g_last_entry.result);
+    TEST_ASSERT_EQUAL(1, g_last_entry.errors);
+}
+
+void test_server_fanout_should_time_out_slow_servers(void) {
+    // Arrange
+    add_connected_servers(2);
+    
+    // Act
+    server_fanout_query_all(0);
+    server_fanout_process();
+    
+    // Assert
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    server_fanout_get_results(entries, FANOUT_MAX_SERVERS);
+    TEST_ASSERT_EQUAL(2, g_result_count);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_TIMEOUT, entries[0].result);
+    TEST_ASSERT_EQUAL(1, entries[0].timeouts);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_TIMEOUT, entries[1].result);
+    TEST_ASSERT_TRUE(server_fanout_is_complete());
+}
+
+void test_server_fanout_query_should_fail_without_session(void) {
+    // Arrange - no connect_all, so no session
+    server_fanout_add_server("10.0.0.2", 9000);
+    
+    // Act
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_result_count);
+    TEST_ASSERT_EQUAL(0, g_last_index);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_ERROR, g_last_entry.result);
+}
+
+void test_server_fanout_should_send_query_once_connected(void) {
+    // Arrange - session open but not connected when the query starts
+    add_connected_servers(1);
+    server_fanout_disconnect_all();
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Act
+    server_fanout_connect_all();
+    ws_session_test_receive(server_fanout_test_get_session(0), "2", 1, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_result_count);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_OK, g_last_entry.result);
+    TEST_ASSERT_EQUAL(2, g_last_entry.status);
+}
+
+void test_server_fanout_disconnect_all_should_abandon_pending_queries(void) {
+    // Arrange
+    add_connected_servers(2);
+    server_fanout_query_all(FANOUT_QUERY_TIMEOUT_MS);
+    
+    // Act
+    server_fanout_disconnect_all();
+    
+    // Assert
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    server_fanout_get_results(entries, FANOUT_MAX_SERVERS);
+    TEST_ASSERT_EQUAL(0, g_result_count);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_IDLE, entries[0].result);
+    TEST_ASSERT_EQUAL(FANOUT_RESULT_IDLE, entries[1].result);
+    TEST_ASSERT_TRUE(server_fanout_is_complete());
+}
+
+void test_server_fanout_redirect_should_move_table_entry(void) {
+    // Arrange
+    const char *hint = "{\"type\":\"hint\",\"redirect\":\"10.0.0.9:9100\"}";
+    fanout_entry_t entries[FANOUT_MAX_SERVERS];
+    add_connected_servers(1);
+    ws_session_t *session = server_fanout_test_get_session(0);
+    
+    // Act
+    ws_session_test_receive(session, hint, strlen(hint), true);
+    
+    // Assert - the table names the new server, connect_all goes there
+    server_fanout_get_results(entries, FANOUT_MAX_SERVERS);
+    TEST_ASSERT_EQUAL_STRING("10.0.0.9", entries[0].host);
+    TEST_ASSERT_EQUAL(9100, entries[0].port);
+    TEST_ASSERT_EQUAL(WS_STATE_DISCONNECTED, ws_session_get_state(session));
+}
+
+void test_server_fanout_result_to_string_should_return_names(void) {
+    TEST_ASSERT_EQUAL_STRING("IDLE", server_fanout_result_to_string(FANOUT_RESULT_IDLE));
+    TEST_ASSERT_EQUAL_STRING("PENDING", server_fanout_result_to_string(FANOUT_RESULT_PENDING));
+    TEST_ASSERT_EQUAL_STRING("OK", server_fanout_result_to_string(FANOUT_RESULT_OK));
+    TEST_ASSERT_EQUAL_STRING("TIMEOUT", server_fanout_result_to_string(FANOUT_RESULT_TIMEOUT));
+    TEST_ASSERT_EQUAL_STRING("ERROR", server_fanout_result_to_string(FANOUT_RESULT_ERROR));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", server_fanout_result_to_string((fanout_result_t)999));
+}
@@ -0,0 +1,164 @@
+/**
+ * @file test_usage_predictor.c
+ * @brief Unit tests for usage predictor module
+ *
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "unity.h"
+#include "usage_predictor.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+#define EVENING_SLOT    (2 * (USAGE_SLOTS / 7) + 40)    // Wednesday 20:00
+
+static usage_predictor_t g_predictor;
+static char g_profile_path[64];
+
+static void record_times(int slot, int presses) {
+    for (int i = 0; i < presses; i++) {
+        usage_predictor_record(&g_predictor, slot);
+    }
+}
+
+void setUp(void) {
+    usage_predictor_init(&g_predictor);
+    snprintf(g_profile_path, sizeof(g_profile_path), "/tmp/test_usage_%d", (int)getpid());
+}
+
+void tearDown(void) {
+    remove(g_profile_path);
+}
+
+/* ============================================================
+ *  Test Group 1: Slots
+ * ============================================================ */
+
+void test_usage_predictor_slot_should_start_week_on_monday(void) {
+    // Arrange - Wednesday 2025-11-05 20:10 local time
+    struct tm local = { .tm_year = 125, .tm_mon = 10, .tm_mday = 5,
+                        .tm_hour = 20, .tm_min = 10, .tm_isdst = -1 };
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(EVENING_SLOT, usage_predictor_slot(mktime(&local)));
+}
+
+/* ============================================================
+ *  Test Group 2: Prediction
+ * ============================================================ */
+
+void test_usage_predictor_should_need_minimum_presses(void) {
+    // Act
+    record_times(EVENING_SLOT, USAGE_MIN_PRESSES - 1);
+
+    // Assert
+    TEST_ASSERT_FALSE(usage_predictor_is_likely(&g_predictor, EVENING_SLOT));
+    record_times(EVENING_SLOT, 1);
+    TEST_ASSERT_TRUE(usage_predictor_is_likely(&g_predictor, EVENING_SLOT));
+}
+
+void test_usage_predictor_should_ignore_slots_near_average(void) {
+    // Arrange - the same use every evening, a few stray presses all week
+    for (int day = 0; day < 7; day++) {
+        record_times(day * (USAGE_SLOTS / 7) + 40, 10);
+    }
+    for (int slot = 0; slot < USAGE_SLOTS; slot += 3) {
+        record_times(slot + 1, 3);
+    }
+
+    // Act & Assert
+    TEST_ASSERT_TRUE(usage_predictor_is_likely(&g_predictor, EVENING_SLOT));
+    TEST_ASSERT_FALSE(usage_predictor_is_likely(&g_predictor, 1));
+    TEST_ASSERT_FALSE(usage_predictor_is_likely(&g_predictor, 0));
+    TEST_ASSERT_FALSE(usage_predictor_is_likely(&g_predictor, USAGE_SLOTS));
+}
+
+void test_usage_predictor_should_halve_on_saturation(void) {
+    // Arrange
+    record_times(EVENING_SLOT, UINT8_MAX);
+    record_times(0, 10);
+
+    // Act
+    record_times(EVENING_SLOT, 1);
+
+    // Assert
+    TEST_ASSERT_EQUAL(UINT8_MAX / 2 + 1, g_predictor.counts[EVENING_SLOT]);
+    TEST_ASSERT_EQUAL(5, g_predictor.counts[0]);
+    TEST_ASSERT_EQUAL(UINT8_MAX / 2 + 1 + 5, g_predictor.total);
+}
+
+void test_usage_predictor_should_age_when_week_wraps(void) {
+    // Arrange
+    record_times(EVENING_SLOT, 16);
+    usage_predictor_tick(&g_predictor, USAGE_SLOTS - 1);
+
+    // Act
+    usage_predictor_tick(&g_predictor, 0);
+
+    // Assert
+    TEST_ASSERT_EQUAL(14, g_predictor.counts[EVENING_SLOT]);
+    TEST_ASSERT_EQUAL(14, g_predictor.total);
+}
+
+void test_usage_predictor_should_forget_rare_habit(void) {
+    // Arrange
+    record_times(EVENING_SLOT, USAGE_MIN_PRESSES);
+    usage_predictor_tick(&g_predictor, USAGE_SLOTS - 1);
+
+    // Act: a week without presses
+    usage_predictor_tick(&g_predictor, 0);
+
+    // Assert
+    TEST_ASSERT_FALSE(usage_predictor_is_likely(&g_predictor, EVENING_SLOT));
+
+    // Act: the rest wears off within a few more weeks
+    for (int week = 0; week < USAGE_MIN_PRESSES; week++) {
+        usage_predictor_tick(&g_predictor, USAGE_SLOTS - 1);
+        usage_predictor_tick(&g_predictor, 0);
+    }
+
+    // Assert
+    TEST_ASSERT_EQUAL(0, g_predictor.counts[EVENING_SLOT]);
+    TEST_ASSERT_EQUAL(0, g_predictor.total);
+}
+
+/* ============================================================
+ *  Test Group 3: Persistence
+ * ============================================================ */
+
+void test_usage_predictor_should_round_trip_profile(void) {
+    // Arrange
+    usage_predictor_t loaded;
+    record_times(EVENING_SLOT, 7);
+    usage_predictor_tick(&g_predictor, 12);
+
+    // Act
+    TEST_ASSERT_EQUAL(0, usage_predictor_save(&g_predictor, g_profile_path));
+    TEST_ASSERT_EQUAL(0, usage_predictor_load(&loaded, g_profile_path));
+
+    // Assert
+    TEST_ASSERT_FALSE(g_predictor.dirty);
+    TEST_ASSERT_EQUAL(7, loaded.counts[EVENING_SLOT]);
+    TEST_ASSERT_EQUAL(7, loaded.total);
+    TEST_ASSERT_EQUAL(12, loaded.last_slot);
+}
+
+void test_usage_predictor_load_should_reject_foreign_file(void) {
+    // Arrange
+    FILE *file = fopen(g_profile_path, "wb");
+    fputs("not a usage profile", file);
+    fclose(file);
+
+    // Act & Assert
+    TEST_ASSERT_EQUAL(-1, usage_predictor_load(&g_predictor, g_profile_path));
+    TEST_ASSERT_EQUAL(0, g_predictor.total);
+    TEST_ASSERT_EQUAL(-1, usage_predictor_load(&g_predictor, "/nonexistent/usage"));
+}
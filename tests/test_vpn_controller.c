@@ -6,9 +6,14 @@
  * @date 2025-11-03
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include "unity.h"
 #include "vpn_controller.h"
+#include "vpn_shm.h"
+#include "fake_vpn_agent.h"
 #include <string.h>
+#include <time.h>
 
 /* ============================================================
  *  Test Fixtures
@@ -21,6 +26,7 @@ void setUp(void) {
 void tearDown(void) {
     // Clean up after each test
     vpn_controller_cleanup();
+    vpn_controller_set_test_transport(NULL, NULL);
 }
 
 /* ============================================================
@@ -295,6 +301,7 @@ void test_vpn_state_to_string_should_return_correct_strings(void) {
     TEST_ASSERT_EQUAL_STRING("CONNECTED", vpn_controller_state_to_string(VPN_STATE_CONNECTED));
     TEST_ASSERT_EQUAL_STRING("DISCONNECTING", vpn_controller_state_to_string(VPN_STATE_DISCONNECTING));
     TEST_ASSERT_EQUAL_STRING("ERROR", vpn_controller_state_to_string(VPN_STATE_ERROR));
+    TEST_ASSERT_EQUAL_STRING("SUSPENDED", vpn_controller_state_to_string(VPN_STATE_SUSPENDED));
 }
 
 void test_vpn_state_to_string_should_handle_invalid_state(void) {
@@ -311,6 +318,9 @@ void test_vpn_error_to_string_should_return_correct_strings(void) {
     TEST_ASSERT_EQUAL_STRING("TIMEOUT", vpn_controller_error_to_string(VPN_ERROR_TIMEOUT));
     TEST_ASSERT_EQUAL_STRING("AGENT_UNREACHABLE", vpn_controller_error_to_string(VPN_ERROR_AGENT_UNREACHABLE));
     TEST_ASSERT_EQUAL_STRING("INVALID_RESPONSE", vpn_controller_error_to_string(VPN_ERROR_INVALID_RESPONSE));
+    TEST_ASSERT_EQUAL_STRING("REJECTED", vpn_controller_error_to_string(VPN_ERROR_REJECTED));
+    TEST_ASSERT_EQUAL_STRING("RESOLVE_TIMEOUT", vpn_controller_error_to_string(VPN_ERROR_RESOLVE_TIMEOUT));
+    TEST_ASSERT_EQUAL_STRING("HANDSHAKE_TIMEOUT", vpn_controller_error_to_string(VPN_ERROR_HANDSHAKE_TIMEOUT));
 }
 
 void test_vpn_error_to_string_should_handle_invalid_error(void) {
@@ -364,3 +374,418 @@ void test_vpn_controller_cleanup_should_clear_callback(void) {
     // Assert
     TEST_ASSERT_EQUAL(0, g_callback_count);
 }
+
+/* ============================================================
+ *  Test Group 10: Connect Progress Tests
+ * ============================================================ */
+
+static const char *g_agent_script[8];
+static int g_agent_script_len;
+static int g_agent_script_pos;
+static int g_agent_connect_count;
+static int g_agent_command_count;
+
+static int scripted_agent_send(const char *data, size_t length) {
+    g_agent_command_count++;
+    if (strstr(data, "\"action\":\"connect\"")) {
+        g_agent_connect_count++;
+    }
+    return (int)length;
+}
+
+static int scripted_agent_recv(char *buffer, size_t max_len) {
+    if (g_agent_script_pos >= g_agent_script_len) {
+        return 0;  // Nothing pending
+    }
+    
+    strncpy(buffer, g_agent_script[g_agent_script_pos++], max_len);
+    return (int)strlen(buffer);
+}
+
+static void use_scripted_agent(void) {
+    g_agent_script_len = 0;
+    g_agent_script_pos = 0;
+    g_agent_connect_count = 0;
+    g_agent_command_count = 0;
+    vpn_controller_set_test_transport(scripted_agent_send, scripted_agent_recv);
+}
+
+static void script_agent(const char *response) {
+    g_agent_script[g_agent_script_len++] = response;
+}
+
+static vpn_connect_stage_t g_progress_stages[8];
+static int g_progress_count;
+
+static void test_progress_callback(vpn_connect_stage_t stage, void *user_data) {
+    if (g_progress_count < 8) {
+        g_progress_stages[g_progress_count] = stage;
+    }
+    g_progress_count++;
+}
+
+void test_vpn_controller_should_forward_progress_events(void) {
+    // Arrange
+    use_scripted_agent();
+    script_agent("{\"event\":\"progress\",\"stage\":\"resolving\"}\n"
+                 "{\"event\":\"progress\",\"stage\":\"handshaking\"}\n");
+    script_agent("{\"event\":\"progress\",\"stage\":\"handshake_done\"}\n");
+    g_progress_count = 0;
+    vpn_controller_init(NULL);
+    vpn_controller_set_progress_callback(test_progress_callback, NULL);
+    vpn_controller_connect();
+    
+    // Act
+    vpn_controller_process(0);
+    vpn_controller_process(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(3, g_progress_count);
+    TEST_ASSERT_EQUAL(VPN_STAGE_RESOLVING, g_progress_stages[0]);
+    TEST_ASSERT_EQUAL(VPN_STAGE_HANDSHAKING, g_progress_stages[1]);
+    TEST_ASSERT_EQUAL(VPN_STAGE_HANDSHAKE_DONE, g_progress_stages[2]);
+    TEST_ASSERT_EQUAL(VPN_STAGE_HANDSHAKE_DONE, vpn_controller_get_connect_stage());
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTING, vpn_controller_get_state());
+}
+
+void test_vpn_controller_should_reassemble_split_agent_lines(void) {
+    // Arrange
+    use_scripted_agent();
+    script_agent("{\"event\":\"progress\",\"sta");
+    script_agent("ge\":\"routes_installed\"}\n{\"status\":\"ok\",");
+    script_agent("\"state\":\"connected\"}\n");
+    g_progress_count = 0;
+    vpn_controller_init(NULL);
+    vpn_controller_set_progress_callback(test_progress_callback, NULL);
+    vpn_controller_connect();
+    
+    // Act
+    vpn_controller_process(0);
+    vpn_controller_process(0);
+    vpn_controller_process(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_progress_count);
+    TEST_ASSERT_EQUAL(VPN_STAGE_ROUTES_INSTALLED, g_progress_stages[0]);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(VPN_STAGE_NONE, vpn_controller_get_connect_stage());
+}
+
+void test_vpn_controller_should_retry_when_stage_deadline_expires(void) {
+    // Arrange
+    use_scripted_agent();
+    script_agent("{\"event\":\"progress\",\"stage\":\"handshaking\"}\n");
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    vpn_controller_process(0);
+    
+    // Act - stay silent past the handshake deadline
+    struct timespec wait = {
+        .tv_sec = VPN_STAGE_HANDSHAKE_TIMEOUT_MS / 1000,
+        .tv_nsec = (VPN_STAGE_HANDSHAKE_TIMEOUT_MS % 1000 + 100) * 1000000L
+    };
+    nanosleep(&wait, NULL);
+    int result = vpn_controller_process(0);
+    
+    // Assert - connect resent long before the overall connect timeout
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(2, g_agent_connect_count);
+    TEST_ASSERT_EQUAL(VPN_STAGE_NONE, vpn_controller_get_connect_stage());
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTING, vpn_controller_get_state());
+}
+
+void test_vpn_controller_should_not_apply_stage_deadline_without_progress(void) {
+    // Arrange - legacy agent that never reports progress
+    use_scripted_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    
+    // Act
+    struct timespec wait = {
+        .tv_sec = VPN_STAGE_START_TIMEOUT_MS / 1000,
+        .tv_nsec = (VPN_STAGE_START_TIMEOUT_MS % 1000 + 100) * 1000000L
+    };
+    nanosleep(&wait, NULL);
+    vpn_controller_process(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_agent_connect_count);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTING, vpn_controller_get_state());
+}
+
+void test_vpn_controller_should_report_rejected_connect(void) {
+    // Arrange
+    use_scripted_agent();
+    script_agent("{\"status\":\"error\",\"state\":\"error\"}\n");
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    TEST_ASSERT_EQUAL(VPN_ERROR_NONE, vpn_controller_get_last_error());
+    
+    // Act
+    vpn_controller_process(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(VPN_STATE_ERROR, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(VPN_ERROR_REJECTED, vpn_controller_get_last_error());
+}
+
+static int failing_agent_recv(char *buffer, size_t max_len) {
+    return -1;
+}
+
+void test_vpn_controller_should_report_lost_agent_connection(void) {
+    // Arrange
+    use_scripted_agent();
+    vpn_controller_set_test_transport(scripted_agent_send, failing_agent_recv);
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    
+    // Act
+    int result = vpn_controller_process(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(-1, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_ERROR, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(VPN_ERROR_SOCKET, vpn_controller_get_last_error());
+}
+
+void test_vpn_stage_to_string_should_return_correct_strings(void) {
+    TEST_ASSERT_EQUAL_STRING("NONE", vpn_controller_stage_to_string(VPN_STAGE_NONE));
+    TEST_ASSERT_EQUAL_STRING("RESOLVING", vpn_controller_stage_to_string(VPN_STAGE_RESOLVING));
+    TEST_ASSERT_EQUAL_STRING("HANDSHAKING", vpn_controller_stage_to_string(VPN_STAGE_HANDSHAKING));
+    TEST_ASSERT_EQUAL_STRING("HANDSHAKE_DONE", vpn_controller_stage_to_string(VPN_STAGE_HANDSHAKE_DONE));
+    TEST_ASSERT_EQUAL_STRING("ROUTES_INSTALLED", vpn_controller_stage_to_string(VPN_STAGE_ROUTES_INSTALLED));
+    TEST_ASSERT_EQUAL_STRING("INVALID", vpn_controller_stage_to_string((vpn_connect_stage_t)999));
+}
+
+/* ============================================================
+ *  Test Group 11: Suspend/Resume Tests (stand-in agent)
+ * ============================================================ */
+
+static void use_fake_agent(void) {
+    fake_vpn_agent_reset();
+    vpn_controller_set_test_transport(fake_vpn_agent_send, fake_vpn_agent_recv);
+}
+
+static void process_until_settled(void) {
+    for (int i = 0; i < 10; i++) {
+        vpn_controller_process(0);
+    }
+}
+
+void test_vpn_controller_suspend_should_keep_agent_session(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    
+    // Act
+    int result = vpn_controller_suspend(VPN_DEFAULT_LINGER_MS);
+    process_until_settled();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_SUSPENDED, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(1, fake_vpn_agent_get_handshake_count());
+}
+
+void test_vpn_controller_connect_should_resume_within_linger_window(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    vpn_controller_suspend(VPN_DEFAULT_LINGER_MS);
+    process_until_settled();
+    
+    // Act - second press shortly after the first
+    int result = vpn_controller_connect();
+    process_until_settled();
+    
+    // Assert - connected again without a second handshake
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(1, fake_vpn_agent_get_handshake_count());
+    TEST_ASSERT_EQUAL(1, fake_vpn_agent_get_resume_count());
+}
+
+void test_vpn_controller_connect_should_handshake_after_linger_expires(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    vpn_controller_suspend(50);
+    process_until_settled();
+    
+    struct timespec wait = { .tv_sec = 0, .tv_nsec = 100 * 1000000L };
+    nanosleep(&wait, NULL);
+    vpn_controller_process(0);
+    
+    // Act
+    int result = vpn_controller_connect();
+    process_until_settled();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(2, fake_vpn_agent_get_handshake_count());
+    TEST_ASSERT_EQUAL(0, fake_vpn_agent_get_resume_count());
+}
+
+void test_vpn_controller_suspend_should_fall_back_to_disconnect_on_old_agent(void) {
+    // Arrange
+    use_fake_agent();
+    fake_vpn_agent_set_resume_supported(false);
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    
+    // Act
+    vpn_controller_suspend(VPN_DEFAULT_LINGER_MS);
+    process_until_settled();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(VPN_STATE_DISCONNECTED, vpn_controller_get_state());
+}
+
+void test_vpn_controller_suspend_with_zero_linger_should_disconnect(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    
+    // Act
+    vpn_controller_suspend(0);
+    process_until_settled();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(VPN_STATE_DISCONNECTED, vpn_controller_get_state());
+}
+
+/* ============================================================
+ *  Test Group 12: Shared State Tests
+ * ============================================================ */
+
+#define TEST_SHM_NAME "/gaming-client-test-vpn"
+
+static void publish_vpn_state(vpn_shm_region_t *region, vpn_state_t state) {
+    vpn_shm_snapshot_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.info.state = state;
+    strncpy(snapshot.info.server_ip, "10.8.0.1", sizeof(snapshot.info.server_ip) - 1);
+    vpn_shm_publish(region, &snapshot);
+}
+
+void test_vpn_controller_attach_shm_should_fail_without_region(void) {
+    // Arrange
+    vpn_controller_init(NULL);
+    
+    // Act
+    int result = vpn_controller_attach_shm("/gaming-client-test-missing");
+    
+    // Assert
+    TEST_ASSERT_LESS_THAN(0, result);
+}
+
+void test_vpn_controller_should_read_state_from_shm(void) {
+    // Arrange - agent socket stays silent
+    use_scripted_agent();
+    vpn_shm_region_t *region = vpn_shm_create(TEST_SHM_NAME);
+    vpn_controller_init(NULL);
+    TEST_ASSERT_EQUAL(0, vpn_controller_attach_shm(TEST_SHM_NAME));
+    vpn_controller_connect();
+    
+    // Act
+    publish_vpn_state(region, VPN_STATE_CONNECTED);
+    vpn_state_t state = vpn_controller_get_state();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, state);
+    TEST_ASSERT_EQUAL(0, vpn_controller_process(0));
+    
+    vpn_controller_cleanup();
+    vpn_shm_destroy(region, TEST_SHM_NAME);
+}
+
+void test_vpn_controller_get_info_should_not_query_agent_with_shm(void) {
+    // Arrange
+    use_scripted_agent();
+    vpn_shm_region_t *region = vpn_shm_create(TEST_SHM_NAME);
+    vpn_controller_init(NULL);
+    vpn_controller_attach_shm(TEST_SHM_NAME);
+    publish_vpn_state(region, VPN_STATE_CONNECTED);
+    vpn_info_t info;
+    
+    // Act
+    int result = vpn_controller_get_info(&info);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, info.state);
+    TEST_ASSERT_EQUAL_STRING("10.8.0.1", info.server_ip);
+    TEST_ASSERT_EQUAL(0, g_agent_command_count);
+    
+    vpn_controller_cleanup();
+    vpn_shm_destroy(region, TEST_SHM_NAME);
+}
+
+/* ============================================================
+ *  Test Group 13: Idle Release Tests
+ * ============================================================ */
+
+void test_vpn_controller_release_should_refuse_while_session_held(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    vpn_controller_connect();
+    process_until_settled();
+    vpn_controller_suspend(VPN_DEFAULT_LINGER_MS);
+    process_until_settled();
+    
+    // Act
+    int result = vpn_controller_release();
+    
+    // Assert
+    TEST_ASSERT_LESS_THAN(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_SUSPENDED, vpn_controller_get_state());
+}
+
+void test_vpn_controller_release_should_keep_shm_attached(void) {
+    // Arrange
+    use_scripted_agent();
+    vpn_shm_region_t *region = vpn_shm_create(TEST_SHM_NAME);
+    vpn_controller_init(NULL);
+    vpn_controller_attach_shm(TEST_SHM_NAME);
+    publish_vpn_state(region, VPN_STATE_DISCONNECTED);
+    
+    // Act
+    int result = vpn_controller_release();
+    publish_vpn_state(region, VPN_STATE_CONNECTED);
+    
+    // Assert: still followed, and attaching again needs no agent round trip
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, vpn_controller_get_state());
+    TEST_ASSERT_EQUAL(0, vpn_controller_attach_shm(TEST_SHM_NAME));
+    TEST_ASSERT_EQUAL(0, g_agent_command_count);
+    
+    vpn_controller_cleanup();
+    vpn_shm_destroy(region, TEST_SHM_NAME);
+}
+
+void test_vpn_controller_should_reconnect_agent_after_release(void) {
+    // Arrange
+    use_fake_agent();
+    vpn_controller_init(NULL);
+    TEST_ASSERT_EQUAL(0, vpn_controller_release());
+    
+    // Act
+    int result = vpn_controller_connect();
+    process_until_settled();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, vpn_controller_get_state());
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_vpn_shm.c
+ * @brief Unit tests for VPN shared state module
+ * 
+ * @author Gaming System Development Team
+ * @date 2025-11-03
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "vpn_shm.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#define TEST_SHM_NAME "/gaming-client-test-shm"
+
+/* ============================================================
+ *  Test Fixtures
+ * ============================================================ */
+
+static vpn_shm_region_t *g_region = NULL;
+
+void setUp(void) {
+    g_region = vpn_shm_create(TEST_SHM_NAME);
+}
+
+void tearDown(void) {
+    vpn_shm_destroy(g_region, TEST_SHM_NAME);
+    g_region = NULL;
+}
+
+static void publish_state(vpn_state_t state, const char *server_ip) {
+    vpn_shm_snapshot_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.info.state = state;
+    snapshot.info.bytes_sent = 1234;
+    strncpy(snapshot.info.server_ip, server_ip, sizeof(snapshot.info.server_ip) - 1);
+    vpn_shm_publish(g_region, &snapshot);
+}
+
+/* ============================================================
+ *  Test Group 1: Mapping Tests
+ * ============================================================ */
+
+void test_vpn_shm_create_should_succeed(void) {
+    TEST_ASSERT_NOT_NULL(g_region);
+    TEST_ASSERT_EQUAL(VPN_SHM_MAGIC, g_region->magic);
+    TEST_ASSERT_EQUAL(0, g_region->sequence);
+}
+
+void test_vpn_shm_map_should_fail_when_region_missing(void) {
+    // Act
+    const vpn_shm_region_t *region = vpn_shm_map("/gaming-client-test-missing");
+    
+    // Assert
+    TEST_ASSERT_NULL(region);
+}
+
+void test_vpn_shm_map_should_reject_incompatible_version(void) {
+    // Arrange
+    g_region->version = VPN_SHM_VERSION + 1;
+    
+    // Act
+    const vpn_shm_region_t *region = vpn_shm_map(TEST_SHM_NAME);
+    
+    // Assert
+    TEST_ASSERT_NULL(region);
+}
+
+/* ============================================================
+ *  Test Group 2: Seqlock Tests
+ * ============================================================ */
+
+void test_vpn_shm_read_should_return_published_state(void) {
+    // Arrange
+    const vpn_shm_region_t *reader = vpn_shm_map(TEST_SHM_NAME);
+    publish_state(VPN_STATE_CONNECTED, "10.0.0.1");
+    vpn_shm_snapshot_t snapshot;
+    
+    // Act
+    int result = vpn_shm_read(reader, &snapshot);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(VPN_STATE_CONNECTED, snapshot.info.state);
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", snapshot.info.server_ip);
+    TEST_ASSERT_EQUAL(1234, snapshot.info.bytes_sent);
+    TEST_ASSERT_EQUAL(1, snapshot.change_count);
+    
+    vpn_shm_unmap(reader);
+}
+
+void test_vpn_shm_publish_should_advance_sequence_by_two(void) {
+    // Act
+    publish_state(VPN_STATE_CONNECTING, "10.0.0.1");
+    publish_state(VPN_STATE_CONNECTED, "10.0.0.1");
+    
+    // Assert
+    TEST_ASSERT_EQUAL(4, vpn_shm_sequence(g_region));
+    TEST_ASSERT_EQUAL(2, g_region->change_count);
+}
+
+void test_vpn_shm_read_should_fail_while_writer_in_progress(void) {
+    // Arrange - odd sequence means an update is being written
+    publish_state(VPN_STATE_CONNECTED, "10.0.0.1");
+    g_region->sequence++;
+    vpn_shm_snapshot_t snapshot;
+    
+    // Act
+    int result = vpn_shm_read(g_region, &snapshot);
+    
+    // Assert
+    TEST_ASSERT_LESS_THAN(0, result);
+}
+
+void test_vpn_shm_read_should_fail_with_null_args(void) {
+    vpn_shm_snapshot_t snapshot;
+    
+    TEST_ASSERT_LESS_THAN(0, vpn_shm_read(NULL, &snapshot));
+    TEST_ASSERT_LESS_THAN(0, vpn_shm_read(g_region, NULL));
+}
+
+/* ============================================================
+ *  Test Group 3: Doorbell Tests
+ * ============================================================ */
+
+void test_vpn_shm_doorbell_should_report_ring_once(void) {
+    // Arrange
+    int fd = eventfd(0, EFD_NONBLOCK);
+    eventfd_write(fd, 1);
+    
+    // Act & Assert
+    TEST_ASSERT_TRUE(vpn_shm_doorbell_rang(fd));
+    TEST_ASSERT_FALSE(vpn_shm_doorbell_rang(fd));
+    
+    close(fd);
+}
+
+void test_vpn_shm_doorbell_should_ignore_invalid_fd(void) {
+    TEST_ASSERT_FALSE(vpn_shm_doorbell_rang(-1));
+}
@@ -8,6 +8,8 @@
 
 #include "unity.h"
 #include "websocket_client.h"
+#include "json_scan.h"
+#include <stdio.h>
 #include <string.h>
 
 /* ============================================================
@@ -432,3 +434,728 @@ void test_ws_client_cleanup_should_clear_callbacks(void) {
     // Assert
     TEST_ASSERT_EQUAL(0, g_connected_count);
 }
+
+/* ============================================================
+ *  Test Group 12: Priority Queue Tests
+ * ============================================================ */
+
+#define MAX_WRITES 32
+
+static char g_writes[MAX_WRITES][128];
+static int g_write_count = 0;
+
+static int record_write(const char *data, size_t length) {
+    if (g_write_count < MAX_WRITES && length < sizeof(g_writes[0])) {
+        memcpy(g_writes[g_write_count], data, length);
+        g_writes[g_write_count][length] = '\0';
+    }
+    g_write_count++;
+    return 0;
+}
+
+static void connect_with_recorder(void) {
+    g_write_count = 0;
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_connect();
+    ws_client_set_test_writer(record_write);
+}
+
+void test_ws_client_strict_should_send_query_before_telemetry(void) {
+    // Arrange
+    connect_with_recorder();
+    ws_client_send_with_priority("{\"type\":\"telemetry\",\"n\":1}", WS_PRIORITY_BACKGROUND);
+    ws_client_send_with_priority("{\"type\":\"telemetry\",\"n\":2}", WS_PRIORITY_BACKGROUND);
+    ws_client_query_ps5_status();
+    ws_client_send_heartbeat();
+    
+    // Act
+    while (ws_client_test_writable() == 0) {
+    }
+    
+    // Assert
+    TEST_ASSERT_EQUAL(4, g_write_count);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"heartbeat\"}", g_writes[0]);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"query_ps5\"}", g_writes[1]);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"telemetry\",\"n\":1}", g_writes[2]);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"telemetry\",\"n\":2}", g_writes[3]);
+}
+
+void test_ws_client_weighted_should_not_starve_background(void) {
+    // Arrange: weights 2:1:1
+    const uint8_t weights[WS_PRIORITY_COUNT] = { 2, 1, 1 };
+    connect_with_recorder();
+    TEST_ASSERT_EQUAL(0, ws_client_set_scheduling(WS_SCHED_WEIGHTED, weights));
+    
+    for (int i = 0; i < 4; i++) {
+        ws_client_send_with_priority("{\"c\":0}", WS_PRIORITY_CONTROL);
+        ws_client_send_with_priority("{\"c\":1}", WS_PRIORITY_INTERACTIVE);
+        ws_client_send_with_priority("{\"c\":2}", WS_PRIORITY_BACKGROUND);
+    }
+    
+    // Act: one full round
+    for (int i = 0; i < 4; i++) {
+        ws_client_test_writable();
+    }
+    
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("{\"c\":0}", g_writes[0]);
+    TEST_ASSERT_EQUAL_STRING("{\"c\":0}", g_writes[1]);
+    TEST_ASSERT_EQUAL_STRING("{\"c\":1}", g_writes[2]);
+    TEST_ASSERT_EQUAL_STRING("{\"c\":2}", g_writes[3]);
+}
+
+void test_ws_client_queue_full_should_reject_interactive(void) {
+    // Arrange
+    connect_with_recorder();
+    for (int i = 0; i < WS_SEND_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(0, ws_client_send("{\"type\":\"query_ps5\"}"));
+    }
+    
+    // Act
+    int result = ws_client_send("{\"type\":\"query_ps5\"}");
+    
+    // Assert
+    ws_queue_stats_t stats;
+    ws_client_get_queue_stats(WS_PRIORITY_INTERACTIVE, &stats);
+    TEST_ASSERT_LESS_THAN(0, result);
+    TEST_ASSERT_EQUAL(WS_SEND_QUEUE_DEPTH, stats.depth);
+    TEST_ASSERT_EQUAL(1, stats.dropped);
+}
+
+void test_ws_client_queue_full_should_evict_oldest_background(void) {
+    // Arrange
+    char message[32];
+    connect_with_recorder();
+    for (int i = 0; i <= WS_SEND_QUEUE_DEPTH; i++) {
+        snprintf(message, sizeof(message), "{\"n\":%d}", i);
+        TEST_ASSERT_EQUAL(0, ws_client_send_with_priority(message, WS_PRIORITY_BACKGROUND));
+    }
+    
+    // Act
+    ws_client_test_writable();
+    
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("{\"n\":1}", g_writes[0]);
+}
+
+void test_ws_client_queue_stats_should_track_depth_and_sent(void) {
+    // Arrange
+    ws_queue_stats_t stats;
+    connect_with_recorder();
+    ws_client_send_heartbeat();
+    ws_client_send_heartbeat();
+    
+    // Act
+    ws_client_test_writable();
+    ws_client_get_queue_stats(WS_PRIORITY_CONTROL, &stats);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, stats.depth);
+    TEST_ASSERT_EQUAL(2, stats.max_depth);
+    TEST_ASSERT_EQUAL(2, stats.enqueued);
+    TEST_ASSERT_EQUAL(1, stats.sent);
+    TEST_ASSERT_TRUE(stats.max_wait_ms >= stats.last_wait_ms);
+}
+
+void test_ws_client_disconnect_should_flush_queues(void) {
+    // Arrange
+    ws_queue_stats_t stats;
+    connect_with_recorder();
+    ws_client_query_ps5_status();
+    
+    // Act
+    ws_client_disconnect();
+    ws_client_get_queue_stats(WS_PRIORITY_INTERACTIVE, &stats);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, stats.depth);
+    TEST_ASSERT_EQUAL(1, stats.dropped);
+    TEST_ASSERT_EQUAL(-1, ws_client_test_writable());
+}
+
+void test_ws_client_priority_to_string_should_return_correct_strings(void) {
+    TEST_ASSERT_EQUAL_STRING("CONTROL", ws_client_priority_to_string(WS_PRIORITY_CONTROL));
+    TEST_ASSERT_EQUAL_STRING("INTERACTIVE", ws_client_priority_to_string(WS_PRIORITY_INTERACTIVE));
+    TEST_ASSERT_EQUAL_STRING("BACKGROUND", ws_client_priority_to_string(WS_PRIORITY_BACKGROUND));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", ws_client_priority_to_string((ws_priority_t)999));
+}
+
+/* ============================================================
+ *  Test Group 13: Batch Envelope Tests
+ * ============================================================ */
+
+static char g_received[8][64];
+static int g_received_count = 0;
+
+static void record_message(const char *message, size_t length, void *user_data) {
+    if (g_received_count < 8 && length < sizeof(g_received[0])) {
+        memcpy(g_received[g_received_count], message, length);
+        g_received[g_received_count][length] = '\0';
+    }
+    g_received_count++;
+}
+
+static void connect_with_batching(void) {
+    g_write_count = 0;
+    g_received_count = 0;
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_set_batching(true);
+    ws_client_set_test_writer(record_write);
+    ws_client_set_callbacks(NULL, NULL, record_message, NULL, NULL);
+    ws_client_connect();
+}
+
+void test_ws_client_should_offer_batching_on_connect(void) {
+    // Arrange
+    connect_with_batching();
+    
+    // Act
+    ws_client_test_writable();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(1, g_write_count);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"hello\",\"features\":[\"batch\"]}", g_writes[0]);
+    TEST_ASSERT_FALSE(ws_client_is_batching());
+}
+
+void test_ws_client_should_not_batch_until_accepted(void) {
+    // Arrange
+    connect_with_batching();
+    ws_client_test_writable();
+    ws_client_test_receive("{\"type\":\"hello\",\"features\":[]}", 31, true);
+    ws_client_send_heartbeat();
+    ws_client_query_ps5_status();
+    
+    // Act
+    ws_client_test_writable();
+    
+    // Assert
+    TEST_ASSERT_FALSE(ws_client_is_batching());
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"heartbeat\"}", g_writes[1]);
+    TEST_ASSERT_EQUAL(0, g_received_count);
+}
+
+void test_ws_client_should_pack_ready_messages_in_priority_order(void) {
+    // Arrange
+    const char *hello = "{\"type\":\"hello\",\"features\":[\"batch\"]}";
+    ws_queue_stats_t stats;
+    connect_with_batching();
+    ws_client_test_writable();
+    ws_client_test_receive(hello, strlen(hello), true);
+    ws_client_send_with_priority("{\"t\":1}", WS_PRIORITY_BACKGROUND);
+    ws_client_query_ps5_status();
+    ws_client_send_heartbeat();
+    
+    // Act
+    ws_client_test_writable();
+    
+    // Assert
+    TEST_ASSERT_TRUE(ws_client_is_batching());
+    TEST_ASSERT_EQUAL(2, g_write_count);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"batch\",\"messages\":[{\"type\":\"heartbeat\"},"
+                             "{\"type\":\"query_ps5\"},{\"t\":1}]}", g_writes[1]);
+    ws_client_get_queue_stats(WS_PRIORITY_INTERACTIVE, &stats);
+    TEST_ASSERT_EQUAL(1, stats.batched);
+    TEST_ASSERT_EQUAL(0, stats.depth);
+}
+
+void test_ws_client_should_send_single_message_without_envelope(void) {
+    // Arrange
+    const char *hello = "{\"type\":\"hello\",\"features\":[\"batch\"]}";
+    connect_with_batching();
+    ws_client_test_writable();
+    ws_client_test_receive(hello, strlen(hello), true);
+    ws_client_query_ps5_status();
+    
+    // Act
+    ws_client_test_writable();
+    
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"query_ps5\"}", g_writes[1]);
+}
+
+void test_ws_client_should_unpack_server_batch(void) {
+    // Arrange
+    const char *batch = "{\"type\":\"batch\",\"messages\":[{\"status\":\"on\"},{\"ack\":7}]}";
+    connect_with_batching();
+    
+    // Act
+    ws_client_test_receive(batch, strlen(batch), true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(2, g_received_count);
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"on\"}", g_received[0]);
+    TEST_ASSERT_EQUAL_STRING("{\"ack\":7}", g_received[1]);
+}
+
+void test_ws_client_should_consume_hello_ack_and_acks(void) {
+    // Arrange
+    const char *hello_ack = "{\"type\":\"hello_ack\",\"features\":[\"batch\"]}";
+    const char *ack = "{\"type\":\"ack\",\"seq\":3}";
+    const char *batch = "{\"type\":\"batch\",\"messages\":[{\"type\":\"ack\"},{\"status\":\"on\"}]}";
+    connect_with_batching();
+    ws_client_test_writable();
+    
+    // Act
+    ws_client_test_receive(hello_ack, strlen(hello_ack), true);
+    ws_client_test_receive(ack, strlen(ack), true);
+    ws_client_test_receive(batch, strlen(batch), true);
+    
+    // Assert - only the status reaches the application
+    TEST_ASSERT_TRUE(ws_client_is_batching());
+    TEST_ASSERT_EQUAL(1, g_received_count);
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"on\"}", g_received[0]);
+}
+
+void test_ws_client_should_deliver_message_with_nested_ack_type(void) {
+    // Arrange
+    const char *status = "{\"data\":{\"type\":\"ack\"},\"type\":\"ps5_status\"}";
+    connect_with_batching();
+    
+    // Act
+    ws_client_test_receive(status, strlen(status), true);
+    
+    // Assert - only the top-level type decides
+    TEST_ASSERT_EQUAL(1, g_received_count);
+    TEST_ASSERT_EQUAL_STRING(status, g_received[0]);
+}
+
+/* ============================================================
+ *  Test Group 14: Receive Delivery Tests
+ * ============================================================ */
+
+static const char *g_view = NULL;
+static size_t g_view_length = 0;
+static char *g_retained = NULL;
+
+static void record_view(const char *message, size_t length, void *user_data) {
+    g_view = message;
+    g_view_length = length;
+    g_retained = ws_client_retain(message, length);
+}
+
+static void connect_with_view_recorder(void) {
+    g_view = NULL;
+    g_view_length = 0;
+    g_retained = NULL;
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_set_callbacks(NULL, NULL, record_view, NULL, NULL);
+    ws_client_connect();
+}
+
+void test_ws_client_should_deliver_view_without_copy(void) {
+    // Arrange: no terminator after the payload
+    const char frame[] = { '{', '"', 'a', '"', ':', '1', '}', 'X' };
+    connect_with_view_recorder();
+    
+    // Act
+    int result = ws_client_test_receive(frame, 7, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_PTR(frame, g_view);
+    TEST_ASSERT_EQUAL(7, g_view_length);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}", g_retained);
+    ws_client_release(g_retained);
+}
+
+void test_ws_client_should_reassemble_fragments(void) {
+    // Arrange
+    connect_with_view_recorder();
+    
+    // Act
+    ws_client_test_receive("{\"status\":", 10, false);
+    TEST_ASSERT_NULL(g_view);
+    ws_client_test_receive("\"on\"}", 5, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(15, g_view_length);
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"on\"}", g_retained);
+    ws_client_release(g_retained);
+}
+
+void test_ws_client_should_accept_message_above_send_limit(void) {
+    // Arrange
+    static char large[WS_MAX_MESSAGE_SIZE * 2];
+    memset(large, ' ', sizeof(large));
+    large[0] = '{';
+    large[sizeof(large) - 1] = '}';
+    connect_with_view_recorder();
+    
+    // Act
+    ws_client_test_receive(large, WS_MAX_MESSAGE_SIZE, false);
+    int result = ws_client_test_receive(large + WS_MAX_MESSAGE_SIZE, WS_MAX_MESSAGE_SIZE, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(sizeof(large), g_view_length);
+    ws_client_release(g_retained);
+}
+
+void test_ws_client_should_reject_oversized_message(void) {
+    // Arrange
+    static char chunk[WS_MAX_REASSEMBLY_SIZE / 2 + 1];
+    memset(chunk, ' ', sizeof(chunk));
+    connect_with_view_recorder();
+    
+    // Act
+    ws_client_test_receive(chunk, sizeof(chunk), false);
+    int result = ws_client_test_receive(chunk, sizeof(chunk), false);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(-2, result);
+    TEST_ASSERT_NULL(g_view);
+}
+
+void test_ws_client_should_reject_invalid_utf8(void) {
+    // Arrange
+    connect_with_view_recorder();
+    
+    // Act & Assert: split sequence is fine, invalid byte is not
+    TEST_ASSERT_EQUAL(0, ws_client_test_receive("\"\xE5\xAE", 3, false));
+    TEST_ASSERT_EQUAL(0, ws_client_test_receive("\xA2\"", 2, true));
+    ws_client_release(g_retained);
+    TEST_ASSERT_EQUAL(-1, ws_client_test_receive("\"\xC0\xAF\"", 4, true));
+}
+
+/* ============================================================
+ *  Test Group 15: Extra Session Tests
+ * ============================================================ */
+
+static int g_session_messages[WS_MAX_SESSIONS];
+
+static void count_session_message(const char *message, size_t length, void *user_data) {
+    g_session_messages[*(int *)user_data]++;
+}
+
+void test_ws_session_open_should_require_client_init(void) {
+    // Act & Assert
+    TEST_ASSERT_NULL(ws_session_open("10.0.0.2", 8765));
+}
+
+void test_ws_session_open_should_fail_when_all_slots_used(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    
+    // Act
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        TEST_ASSERT_NOT_NULL(ws_session_open("10.0.0.2", 8765 + i));
+    }
+    
+    // Assert
+    TEST_ASSERT_NULL(ws_session_open("10.0.0.9", 8765));
+}
+
+void test_ws_session_should_connect_independently_of_primary(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_session_t *session = ws_session_open("10.0.0.2", 8765);
+    
+    // Act
+    int result = ws_session_connect(session);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_session_get_state(session));
+    TEST_ASSERT_EQUAL(WS_STATE_DISCONNECTED, ws_client_get_state());
+    TEST_ASSERT_EQUAL(0, ws_session_query_ps5_status(session));
+    TEST_ASSERT_LESS_THAN(0, ws_client_query_ps5_status());
+}
+
+void test_ws_session_should_deliver_to_its_own_callback(void) {
+    // Arrange
+    static int primary_id = 0;
+    static int session_id = 1;
+    memset(g_session_messages, 0, sizeof(g_session_messages));
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_set_callbacks(NULL, NULL, count_session_message, NULL, &primary_id);
+    ws_session_t *session = ws_session_open("10.0.0.2", 8765);
+    ws_session_set_callbacks(session, NULL, NULL, count_session_message, NULL, &session_id);
+    ws_client_connect();
+    ws_session_connect(session);
+    
+    // Act
+    ws_session_test_receive(session, "{\"status\":\"on\"}", 15, true);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, g_session_messages[primary_id]);
+    TEST_ASSERT_EQUAL(1, g_session_messages[session_id]);
+}
+
+void test_ws_session_close_should_free_slot(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_session_t *sessions[WS_MAX_SESSIONS - 1];
+    for (int i = 0; i < WS_MAX_SESSIONS - 1; i++) {
+        sessions[i] = ws_session_open("10.0.0.2", 8765);
+    }
+    
+    // Act
+    ws_session_close(sessions[0]);
+    
+    // Assert
+    TEST_ASSERT_NOT_NULL(ws_session_open("10.0.0.3", 8765));
+}
+
+/* ============================================================
+ *  Test Group 16: Server Hint Tests
+ * ============================================================ */
+
+static void receive_hint(const char *hint) {
+    TEST_ASSERT_EQUAL(0, ws_client_test_receive(hint, strlen(hint), true));
+}
+
+void test_ws_client_hint_should_not_reach_application(void) {
+    // Arrange
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"rate_percent\":50}");
+    
+    // Assert
+    TEST_ASSERT_NULL(g_view);
+}
+
+void test_ws_client_retry_after_should_hold_off_connects(void) {
+    // Arrange
+    ws_hint_state_t hint;
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"retry_after_ms\":60000}");
+    ws_client_disconnect();
+    
+    // Assert: the hold carries up to a quarter of jitter
+    TEST_ASSERT_LESS_THAN(0, ws_client_connect());
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_GREATER_OR_EQUAL(59000, hint.hold_remaining_ms);
+    TEST_ASSERT_LESS_OR_EQUAL(75001, hint.hold_remaining_ms);
+    TEST_ASSERT_EQUAL(1, hint.hints_received);
+}
+
+void test_ws_client_rate_hint_should_be_clamped_and_expire(void) {
+    // Arrange
+    ws_hint_state_t hint;
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"rate_percent\":1,\"ttl_ms\":600000}");
+    
+    // Assert
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_EQUAL(WS_HINT_MIN_RATE_PERCENT, hint.rate_percent);
+    TEST_ASSERT_GREATER_THAN(0, hint.expires_in_ms);
+    
+    // Act: a bare hint restores normal pace
+    receive_hint("{\"type\":\"hint\"}");
+    
+    // Assert
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_EQUAL(100, hint.rate_percent);
+    TEST_ASSERT_EQUAL(0, hint.expires_in_ms);
+}
+
+void test_ws_client_push_only_should_suppress_queries(void) {
+    // Arrange
+    ws_queue_stats_t stats;
+    connect_with_view_recorder();
+    receive_hint("{\"type\":\"hint\",\"mode\":\"push\"}");
+    
+    // Act
+    int result = ws_client_query_ps5_status();
+    
+    // Assert
+    ws_client_get_queue_stats(WS_PRIORITY_INTERACTIVE, &stats);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(0, stats.enqueued);
+}
+
+void test_ws_client_redirect_should_move_session(void) {
+    // Arrange
+    ws_hint_state_t hint;
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"redirect\":\"10.0.0.9:9000\"}");
+    
+    // Assert
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_EQUAL(1, hint.redirects);
+    TEST_ASSERT_LESS_THAN(WS_HINT_REDIRECT_SPREAD_MS, hint.hold_remaining_ms);
+    TEST_ASSERT_EQUAL(WS_STATE_DISCONNECTED, ws_client_get_state());
+    
+    // Act: reconnects on its own once the hold is over
+    ws_client_test_end_hold();
+    ws_client_service(0);
+    
+    // Assert
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_client_get_state());
+}
+
+static char g_redirect_host[64];
+static int g_redirect_port;
+
+static void record_redirect(const char *host, int port, void *user_data) {
+    snprintf(g_redirect_host, sizeof(g_redirect_host), "%s", host);
+    g_redirect_port = port;
+}
+
+void test_ws_client_redirect_should_go_to_owner(void) {
+    // Arrange
+    g_redirect_host[0] = '\0';
+    connect_with_view_recorder();
+    ws_client_set_redirect_callback(record_redirect, NULL);
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"redirect\":\"10.0.0.9:9000\"}");
+    
+    // Assert: the owner decides, the link is left alone
+    TEST_ASSERT_EQUAL_STRING("10.0.0.9", g_redirect_host);
+    TEST_ASSERT_EQUAL(9000, g_redirect_port);
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_client_get_state());
+}
+
+void test_ws_client_should_ignore_malformed_redirect(void) {
+    // Arrange
+    ws_hint_state_t hint;
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint("{\"type\":\"hint\",\"redirect\":\"10.0.0.9:http\"}");
+    
+    // Assert
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_EQUAL(0, hint.redirects);
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_client_get_state());
+}
+
+void test_ws_client_should_ignore_nested_hint_fields(void) {
+    // Arrange
+    ws_hint_state_t hint;
+    const char *decoy = "{\"type\":\"ps5_status\",\"data\":{\"type\":\"hint\","
+                        "\"redirect\":\"10.0.0.9:9000\",\"retry_after_ms\":60000}}";
+    connect_with_view_recorder();
+    
+    // Act
+    receive_hint(decoy);
+    receive_hint("{\"type\":\"hint\",\"data\":{\"rate_percent\":10,\"retry_after_ms\":60000,"
+                 "\"redirect\":\"10.0.0.9:9000\"}}");
+    
+    // Assert: the decoy is application data, the hint's nested fields are ignored
+    TEST_ASSERT_EQUAL_PTR(decoy, g_view);
+    ws_client_get_hint_state(&hint);
+    TEST_ASSERT_EQUAL(1, hint.hints_received);
+    TEST_ASSERT_EQUAL(100, hint.rate_percent);
+    TEST_ASSERT_EQUAL(0, hint.redirects);
+    TEST_ASSERT_EQUAL(0, hint.hold_remaining_ms);
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_client_get_state());
+}
+
+void test_ws_client_set_server_should_wait_for_disconnect(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_connect();
+    
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, ws_client_set_server("10.0.0.9", 9000));
+    ws_client_disconnect();
+    TEST_ASSERT_EQUAL(0, ws_client_set_server("10.0.0.9", 9000));
+    TEST_ASSERT_LESS_THAN(0, ws_client_set_server("10.0.0.9", 0));
+}
+
+/* ============================================================
+ *  Test Group 17: Idle Suspend Tests
+ * ============================================================ */
+
+void test_ws_client_suspend_should_fail_when_not_initialized(void) {
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, ws_client_suspend());
+    TEST_ASSERT_FALSE(ws_client_is_suspended());
+}
+
+void test_ws_client_suspend_should_refuse_while_connected(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_session_t *session = ws_session_open("10.0.0.2", 8765);
+    ws_session_connect(session);
+    
+    // Act & Assert
+    TEST_ASSERT_LESS_THAN(0, ws_client_suspend());
+    TEST_ASSERT_FALSE(ws_client_is_suspended());
+}
+
+void test_ws_client_connect_should_resume_after_suspend(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_connect();
+    ws_client_disconnect();
+    
+    // Act
+    TEST_ASSERT_EQUAL(0, ws_client_suspend());
+    TEST_ASSERT_TRUE(ws_client_is_suspended());
+    ws_client_service(0);
+    int result = ws_client_connect();
+    
+    // Assert
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_FALSE(ws_client_is_suspended());
+    TEST_ASSERT_EQUAL(WS_STATE_CONNECTED, ws_client_get_state());
+}
+
+void test_ws_client_resume_should_be_idempotent(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_suspend();
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(0, ws_client_resume());
+    TEST_ASSERT_EQUAL(0, ws_client_resume());
+    TEST_ASSERT_FALSE(ws_client_is_suspended());
+}
+
+/* ============================================================
+ *  Test Group 18: Connection Error Tests
+ * ============================================================ */
+
+static ws_error_t g_last_ws_error;
+static char g_last_ws_error_message[64];
+
+static void capture_error(ws_error_t error, const char *message, void *user_data) {
+    g_last_ws_error = error;
+    snprintf(g_last_ws_error_message, sizeof(g_last_ws_error_message), "%s", message);
+}
+
+static ws_error_t fail_connect_with(const char *detail) {
+    ws_client_connect();
+    g_last_ws_error = WS_ERROR_NONE;
+    ws_client_test_connection_error(detail);
+    return g_last_ws_error;
+}
+
+void test_ws_client_should_classify_connection_errors(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_set_callbacks(NULL, NULL, NULL, capture_error, NULL);
+    
+    // Act & Assert
+    TEST_ASSERT_EQUAL(WS_ERROR_DNS, fail_connect_with("getaddrinfo failed"));
+    TEST_ASSERT_EQUAL(WS_ERROR_REFUSED, fail_connect_with("connect failed: Connection refused"));
+    TEST_ASSERT_EQUAL(WS_ERROR_TIMEOUT, fail_connect_with("timed out waiting for server"));
+    TEST_ASSERT_EQUAL(WS_ERROR_HANDSHAKE, fail_connect_with("HS: ws upgrade response not 101"));
+    TEST_ASSERT_EQUAL(WS_ERROR_CONNECT, fail_connect_with(NULL));
+    TEST_ASSERT_EQUAL(WS_STATE_ERROR, ws_client_get_state());
+}
+
+void test_ws_client_should_pass_library_detail_to_error_callback(void) {
+    // Arrange
+    ws_client_init("192.168.1.1", 8080);
+    ws_client_set_callbacks(NULL, NULL, NULL, capture_error, NULL);
+    
+    // Act
+    fail_connect_with("getaddrinfo failed");
+    
+    // Assert
+    TEST_ASSERT_EQUAL_STRING("getaddrinfo failed", g_last_ws_error_message);
+    TEST_ASSERT_EQUAL_STRING("DNS_FAILED", ws_client_error_to_string(WS_ERROR_DNS));
+    TEST_ASSERT_EQUAL_STRING("PONG_TIMEOUT", ws_client_error_to_string(WS_ERROR_PONG_TIMEOUT));
+}